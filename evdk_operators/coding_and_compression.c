@@ -17,6 +17,7 @@
  * For decoding, the process is reversed using the stored Huffman codes.
  */
 #include "coding_and_compression.h"
+#include "histogram_operations.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -296,13 +297,12 @@ static uint8_t readBit(const uint8_t* buffer, uint32_t pos) {
 int32_t huffmanEncode(const image_t* src, EncodedImage* encoded) {
 
     // Count frequency of each pixel value in the image
-    uint32_t frequency[256] = {0};
+    uint32_t frequency[256];
     uint8_t* pixelData = (uint8_t*)src->data;
     uint32_t totalPixels = src->cols * src->rows;
+    uint32_t stride = IMAGE_STRIDE(src);
     
-    for (uint32_t i = 0; i < totalPixels; i++) {
-        frequency[pixelData[i]]++;
-    }
+    histogram(src, frequency);
     
     // Create leaf nodes for each pixel value with non-zero frequency
     PriorityQueue* queue = createPriorityQueue(256);
@@ -382,8 +382,10 @@ int32_t huffmanEncode(const image_t* src, EncodedImage* encoded) {
     
     // Calculate the total size needed for the encoded data (rough estimate)
     uint32_t totalBits = 0;
-    for (uint32_t i = 0; i < totalPixels; i++) {
-        totalBits += encoded->codes[pixelData[i]].length;
+    for (int32_t y = 0; y < src->rows; y++) {
+        for (int32_t x = 0; x < src->cols; x++) {
+            totalBits += encoded->codes[pixelData[y * stride + x]].length;
+        }
     }
     
     // Allocate memory for encoded data
@@ -399,15 +401,17 @@ int32_t huffmanEncode(const image_t* src, EncodedImage* encoded) {
     
     // Encode the image by replacing each pixel with its Huffman code
     uint32_t bitPos = 0;
-    for (uint32_t i = 0; i < totalPixels; i++) {
-        uint8_t pixel = pixelData[i];
-        uint32_t code = encoded->codes[pixel].code;
-        uint8_t codeLength = encoded->codes[pixel].length;
-        
-        // Write the code bits from MSB to LSB
-        for (int32_t j = codeLength - 1; j >= 0; j--) {
-            uint8_t bit = (code >> j) & 1;
-            writeBit(encoded->data, &bitPos, bit);
+    for (int32_t y = 0; y < src->rows; y++) {
+        for (int32_t x = 0; x < src->cols; x++) {
+            uint8_t pixel = pixelData[y * stride + x];
+            uint32_t code = encoded->codes[pixel].code;
+            uint8_t codeLength = encoded->codes[pixel].length;
+            
+            // Write the code bits from MSB to LSB
+            for (int32_t j = codeLength - 1; j >= 0; j--) {
+                uint8_t bit = (code >> j) & 1;
+                writeBit(encoded->data, &bitPos, bit);
+            }
         }
     }
     
@@ -485,26 +489,28 @@ int32_t huffmanDecode(const EncodedImage* encoded, image_t* dst) {
     
     // Decode the image by traversing the tree for each encoded sequence
     uint8_t* pixelData = (uint8_t*)dst->data;
-    uint32_t totalPixels = dst->cols * dst->rows;
+    uint32_t stride = IMAGE_STRIDE(dst);
     uint32_t bitPos = 0;
     
-    for (uint32_t i = 0; i < totalPixels; i++) {
-        HuffmanNode* current = root;
+    for (int32_t y = 0; y < dst->rows; y++) {
+        for (int32_t x = 0; x < dst->cols; x++) {
+            HuffmanNode* current = root;
         
-        // Navigate the tree according to the bits in the encoded data
-        while (current->left || current->right) {
-            uint8_t bit = readBit(encoded->data, bitPos++);
-            current = bit ? current->right : current->left;
+            // Navigate the tree according to the bits in the encoded data
+            while (current->left || current->right) {
+                uint8_t bit = readBit(encoded->data, bitPos++);
+                current = bit ? current->right : current->left;
             
-            // Handle invalid codes (should never happen with properly encoded data)
-            if (!current) {
-                freeNode(root);
-                return 0;
+                // Handle invalid codes (should never happen with properly encoded data)
+                if (!current) {
+                    freeNode(root);
+                    return 0;
+                }
             }
-        }
         
-        // Found a leaf node - output the pixel value
-        pixelData[i] = current->pixel;
+            // Found a leaf node - output the pixel value
+            pixelData[y * stride + x] = current->pixel;
+        }
     }
     
     // Clean up resources
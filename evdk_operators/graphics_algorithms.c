@@ -599,6 +599,7 @@ void rotate180_c(const image_t *img)
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    ASSERT(!IMAGE_IS_PACKED(img), "img must not be a strided view");
 
     register uint32_t i;
     register uint8_pixel_t *s = (uint8_pixel_t *)img->data;
@@ -36,16 +36,47 @@
 #include "image_fundamentals.h"
 #include "histogram_operations.h"
 
+#include <string.h>
+
+/// Number of interleaved sub-histograms of histogramKernel()
+#define HISTOGRAM_BANKS (4)
+
 /*!
- * \brief Creates an histogram of an image
+ * \brief Adds the 16-bit sub-histograms of histogramKernel() to \p hist and
+ *        clears them
  *
- * The function does not check memory boundaries. It simply assumes that the
- * \p hist pointer points to memory allocated by the caller of this function.
+ * \param[in,out] bank The HISTOGRAM_BANKS - 1 sub-histograms
+ * \param[in,out] hist A pointer to an array of 256 uint32_t
+ */
+static void histogramFlush(uint16_t bank[][256], uint32_t *hist)
+{
+    for(uint32_t i=0; i<256; ++i)
+    {
+        hist[i] += (uint32_t)bank[0][i] + bank[1][i] + bank[2][i];
+    }
+
+    memset(bank, 0, (HISTOGRAM_BANKS - 1) * 256 * sizeof(uint16_t));
+}
+
+/*!
+ * \brief Counts the pixels of \p img, where \p msk is not 0, in \p hist
+ *
+ * Consecutive pixels often have the same value. With a single histogram, each
+ * increment then has to wait for the store of the previous increment of the
+ * same bin. The pixels are therefore distributed over HISTOGRAM_BANKS
+ * interleaved sub-histograms, which are summed at the end. Four pixels are
+ * loaded at once as a 32-bit word.
+ *
+ * \p hist itself is the first sub-histogram. The others count in 16 bits to
+ * keep the stack small, so they are added to \p hist before they can
+ * overflow.
  *
  * \param[in]  img  A pointer to a source image
+ * \param[in]  msk  A pointer to a mask image of the same size, or NULL to
+ *                  count all pixels
  * \param[out] hist A pointer to an array of 256 uint32_t
  */
-void histogram(const image_t *img, uint32_t *hist)
+static void histogramKernel(const image_t *img, const image_t *msk, uint32_t *hist)
 {
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
@@ -55,42 +86,613 @@ void histogram(const image_t *img, uint32_t *hist)
     // Verify histogram validity
     ASSERT(hist == NULL, "hist is invalid");
 
-    // Clear the histogram
-    // Note: You might have learned that the memset() function is faster than
-    //       this for-loop. However, the compiler optimizes such a loop to a
-    //       call to memset() anyway (at least when optimization is set to
-    //       -Ofast).
+    if(msk != NULL)
+    {
+        ASSERT(msk->data == NULL, "msk data is invalid");
+        ASSERT(msk->type != IMGTYPE_UINT8, "msk type is invalid");
+        ASSERT(img->cols != msk->cols, "img and msk have different number of columns");
+        ASSERT(img->rows != msk->rows, "img and msk have different number of rows");
+    }
+
+    const int32_t cols = img->cols;
+
+    // Every row adds at most cols / 4 to a bin of a 16-bit sub-histogram
+    ASSERT((cols / 4) > UINT16_MAX, "img has too many columns");
+
+    uint16_t bank[HISTOGRAM_BANKS - 1][256];
+    uint32_t pending = 0;
+
+    memset(hist, 0, 256 * sizeof(uint32_t));
+    memset(bank, 0, sizeof(bank));
+
+    for(int32_t y=0; y<img->rows; ++y)
+    {
+        // Set image pointer to the start of the row
+        const uint8_pixel_t *d = (uint8_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+        int32_t x = 0;
+
+        if((pending + (uint32_t)(cols / 4)) > UINT16_MAX)
+        {
+            histogramFlush(bank, hist);
+            pending = 0;
+        }
+
+        pending += cols / 4;
+
+        if(msk == NULL)
+        {
+            for(; x<=(cols - 4); x+=4)
+            {
+                uint32_t w;
+
+                // Rows are not necessarily aligned, memcpy() compiles to a
+                // single load where unaligned access is allowed
+                memcpy(&w, d + x, sizeof(w));
+
+                hist[w & 0xFF]++;
+                bank[0][(w >> 8) & 0xFF]++;
+                bank[1][(w >> 16) & 0xFF]++;
+                bank[2][w >> 24]++;
+            }
+
+            for(; x<cols; ++x)
+            {
+                hist[d[x]]++;
+            }
+        }
+        else
+        {
+            const uint8_pixel_t *m = (uint8_pixel_t *)msk->data + (y * IMAGE_STRIDE(msk));
+
+            for(; x<=(cols - 4); x+=4)
+            {
+                hist[d[x]]        += (m[x] != 0);
+                bank[0][d[x + 1]] += (m[x + 1] != 0);
+                bank[1][d[x + 2]] += (m[x + 2] != 0);
+                bank[2][d[x + 3]] += (m[x + 3] != 0);
+            }
+
+            for(; x<cols; ++x)
+            {
+                hist[d[x]] += (m[x] != 0);
+            }
+        }
+    }
+
+    histogramFlush(bank, hist);
+}
+
+/*!
+ * \brief Creates an histogram of an image
+ *
+ * The function does not check memory boundaries. It simply assumes that the
+ * \p hist pointer points to memory allocated by the caller of this function.
+ * Use roiImage() to create the histogram of a region of interest.
+ *
+ * \param[in]  img  A pointer to a source image
+ * \param[out] hist A pointer to an array of 256 uint32_t
+ */
+void histogram(const image_t *img, uint32_t *hist)
+{
+    histogramKernel(img, NULL, hist);
+}
+
+/*!
+ * \brief Creates an histogram of the pixels of an image where a mask is set
+ *
+ * \param[in]  img  A pointer to a source image
+ * \param[in]  msk  A pointer to a mask image of the same size. Only pixels
+ *                  where the mask is not 0 are counted. If NULL, all pixels
+ *                  are counted.
+ * \param[out] hist A pointer to an array of 256 uint32_t
+ */
+void histogramMasked(const image_t *img, const image_t *msk, uint32_t *hist)
+{
+    histogramKernel(img, msk, hist);
+}
+
+/*!
+ * \brief Creates an histogram of an image and returns the number, sum,
+ *        minimum and maximum of the counted pixels
+ *
+ * The statistics are derived from the histogram, so the image is read only
+ * once.
+ *
+ * \param[in]  img  A pointer to a source image
+ * \param[in]  msk  A pointer to a mask image of the same size. Only pixels
+ *                  where the mask is not 0 are counted. If NULL, all pixels
+ *                  are counted.
+ * \param[out] hist A pointer to an array of 256 uint32_t
+ *
+ * \return The statistics of the counted pixels
+ */
+histogramStats_t histogramStats(const image_t *img, const image_t *msk, uint32_t *hist)
+{
+    histogramKernel(img, msk, hist);
+
+    histogramStats_t stats =
+    {
+        .count = 0,
+        .sum   = 0,
+        .min   = 255,
+        .max   = 0,
+    };
+
     for(uint32_t i=0; i<256; ++i)
     {
-        hist[i]=0;
+        if(hist[i] != 0)
+        {
+            stats.count += hist[i];
+            stats.sum += (uint64_t)i * hist[i];
+            stats.min = (i < stats.min) ? i : stats.min;
+            stats.max = i;
+        }
+    }
+
+    return stats;
+}
+
+/*!
+ * \brief Returns the lookup table that does not change the pixels
+ *
+ * \return The lookup table
+ */
+lut_t lutIdentity(void)
+{
+    lut_t lut;
+
+    for(uint32_t g=0; g<256; ++g)
+    {
+        lut.table[g] = (uint8_pixel_t)g;
     }
 
-    // Set the image size
-    uint32_t imsize = img->rows * img->cols;
+    return lut;
+}
 
-    // Set image pointer
-    uint8_pixel_t *d = (uint8_pixel_t *)img->data;
+/*!
+ * \brief Returns the lookup table of brightness()
+ *
+ * \param[in] brightness Brightness value that is added to each pixel
+ *
+ * \return The lookup table
+ */
+lut_t lutBrightness(const int32_t brightness)
+{
+    lut_t lut;
 
-    // Create the histogram
-    for(uint32_t i=0; i<imsize; ++i)
+    for(int32_t g=0; g<256; ++g)
     {
-        hist[*d++]++;
+        int32_t i = g + brightness;
+
+        // Clip the result
+        if(i > 255)
+        {
+            i = 255;
+        }
+
+        if(i < 0)
+        {
+            i = 0;
+        }
+
+        lut.table[g] = (uint8_pixel_t)i;
     }
+
+    return lut;
 }
 
 /*!
- * \brief Adjusts the image brightness
+ * \brief Returns the lookup table of contrast()
  *
- * The \p brightness is added to each pixel value in the source image and the
- * result is stored in the destination image.
+ * s_i = (\p contrast * (g_i - \p average)) + \p average
+ *
+ * \param[in] contrast New distance to the average pixel value
+ * \param[in] average  The average pixel value
+ *
+ * \return The lookup table
+ */
+lut_t lutContrast(const float contrast, const float average)
+{
+    lut_t lut;
+
+    for(uint32_t g=0; g<256; ++g)
+    {
+        float v = contrast * ((float)g - average) + average;
+
+        // Clip the result
+        if(v > 255) { v = 255; }
+        if(v < 0)   { v = 0;   }
+
+        lut.table[g] = (uint8_pixel_t)v;
+    }
+
+    return lut;
+}
+
+/*!
+ * \brief Returns the lookup table of threshold()
+ *
+ * Pixel values from \p min up to and including \p max become 1, all other
+ * values become 0.
+ *
+ * \param[in] min Minimum graylevel that is part of an object
+ * \param[in] max Maximum graylevel that is part of an object
+ *
+ * \return The lookup table
+ */
+lut_t lutThreshold(const uint8_pixel_t min, const uint8_pixel_t max)
+{
+    lut_t lut;
+
+    for(uint32_t g=0; g<256; ++g)
+    {
+        lut.table[g] = ((g >= min) && (g <= max)) ? 1 : 0;
+    }
+
+    return lut;
+}
+
+/*!
+ * \brief Returns the lookup table of setSelectedToValue()
+ *
+ * \param[in] selected Pixel value that will be updated
+ * \param[in] value    New pixel value
+ *
+ * \return The lookup table
+ */
+lut_t lutSelectedToValue(const uint8_pixel_t selected, const uint8_pixel_t value)
+{
+    lut_t lut = lutIdentity();
+
+    lut.table[selected] = value;
+
+    return lut;
+}
+
+/*!
+ * \brief Returns the lookup table of scale()
+ *
+ * Stretches the pixel values from \p min to \p max to the range 0 to 255. If
+ * \p min equals \p max, all pixels become 128.
+ *
+ * \param[in] min The smallest pixel value in the image
+ * \param[in] max The largest pixel value in the image
+ *
+ * \return The lookup table
+ */
+lut_t lutScale(const uint8_pixel_t min, const uint8_pixel_t max)
+{
+    lut_t lut;
+
+    for(int32_t g=0; g<256; ++g)
+    {
+        if(max == min)
+        {
+            lut.table[g] = 128;
+        }
+        else if(g < min)
+        {
+            lut.table[g] = 0;
+        }
+        else if(g > max)
+        {
+            lut.table[g] = 255;
+        }
+        else
+        {
+            lut.table[g] = (uint8_pixel_t)((255.0f/(max-min)) * (g - min) + 0.5f);
+        }
+    }
+
+    return lut;
+}
+
+/*!
+ * \brief Returns the lookup table that makes a binary image visible
+ *
+ * Background pixels (0) stay 0, all other pixels become 255.
+ *
+ * \return The lookup table
+ */
+lut_t lutBinaryToDisplay(void)
+{
+    lut_t lut;
+
+    lut.table[0] = 0;
+    memset(&lut.table[1], 255, 255);
+
+    return lut;
+}
+
+/*!
+ * \brief Combines two lookup tables into one
+ *
+ * Applying the result equals applying \p first and then \p second, so a
+ * chain of point operations needs only one pass over the image.
  * \n
- * s_i = g_i + \p brightness
+ * lut[g] = \p second[\p first[g]]
  *
- * \param[in]  src        A pointer to the source image
- * \param[out] dst        A pointer to the destination image
- * \param[in]  brightness Brightness value that is added to each pixel
+ * \param[in] first  A pointer to the lookup table that is applied first
+ * \param[in] second A pointer to the lookup table that is applied second
+ *
+ * \return The combined lookup table
  */
-void brightness(const image_t *src, image_t *dst, const int32_t brightness)
+lut_t lutCompose(const lut_t *first, const lut_t *second)
+{
+    // Verify lookup table validity
+    ASSERT(first == NULL, "first is invalid");
+    ASSERT(second == NULL, "second is invalid");
+
+    lut_t lut;
+
+    for(uint32_t g=0; g<256; ++g)
+    {
+        lut.table[g] = second->table[first->table[g]];
+    }
+
+    return lut;
+}
+
+/*!
+ * \brief Calculates the lookup table that equalizes a histogram
+ *
+ * The cumulative histogram is stretched so the smallest pixel value maps to 0
+ * and the largest to 255:
+ * \n
+ * lut[i] = (cdf(i) - cdf_min) * 255 / (N - cdf_min)
+ * \n
+ * where cdf_min is the number of pixels with the smallest value. If all pixels
+ * have the same value, the lookup table does not change the pixels.
+ *
+ * \param[in]  hist A pointer to an array of 256 uint32_t
+ * \param[out] lut  A pointer to an array of 256 uint8_pixel_t
+ */
+void equalizeLut(const uint32_t *hist, uint8_pixel_t *lut)
+{
+    // Verify histogram and lookup table validity
+    ASSERT(hist == NULL, "hist is invalid");
+    ASSERT(lut == NULL, "lut is invalid");
+
+    uint64_t total = 0;
+    uint64_t cdfMin = 0;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        if((total == 0) && (hist[i] != 0))
+        {
+            cdfMin = hist[i];
+        }
+
+        total += hist[i];
+    }
+
+    uint64_t range = total - cdfMin;
+    uint64_t cdf = 0;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        cdf += hist[i];
+
+        if(range == 0)
+        {
+            lut[i] = (uint8_pixel_t)i;
+        }
+        else if(cdf <= cdfMin)
+        {
+            lut[i] = 0;
+        }
+        else
+        {
+            lut[i] = (uint8_pixel_t)((((cdf - cdfMin) * 255) + (range / 2)) / range);
+        }
+    }
+}
+
+/*!
+ * \brief Spreads the pixel values of an image evenly over the range 0 to 255
+ *
+ * Unlike scale(), the result depends on the number of pixels with each value
+ * and not only on the smallest and largest value, so a few outliers have
+ * little effect. See equalizeLut() for the mapping. The source and
+ * destination image may be the same image.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ */
+void equalize(const image_t *src, image_t *dst)
+{
+    uint32_t hist[256];
+    uint8_pixel_t lut[256];
+
+    histogram(src, hist);
+    equalizeLut(hist, lut);
+    applyLut(src, dst, lut);
+}
+
+/*!
+ * \brief Calculates the tiles between which a position is interpolated
+ *
+ * The center of tile t is at position (t + 0.5) * n / tiles - 0.5. Positions
+ * before the first center or after the last center use a single tile.
+ *
+ * \param[out] map   A pointer to an INT32 image of n columns and 3 rows. The
+ *                   rows receive the offset of the first tile, the offset of
+ *                   the second tile and the weight (0-256) of the second tile.
+ *                   The offset is the tile index times 256.
+ * \param[in]  n     The number of positions
+ * \param[in]  tiles The number of tiles
+ */
+static void claheMap(image_t *map, const int32_t n, const int32_t tiles)
+{
+    int32_t *first = (int32_t *)map->data;
+    int32_t *second = first + n;
+    int32_t *weight = second + n;
+
+    for(int32_t p=0; p<n; ++p)
+    {
+        // Position in tiles relative to the first center, in 1/256 tile
+        int64_t f = ((((int64_t)(2 * p + 1)) * tiles * 256) / (2 * n)) - 128;
+        int32_t t = 0;
+        int32_t w = 0;
+
+        if(f > 0)
+        {
+            t = (int32_t)(f >> 8);
+            w = (int32_t)(f & 0xFF);
+        }
+
+        if(t >= (tiles - 1))
+        {
+            t = tiles - 1;
+            w = 0;
+        }
+
+        first[p] = t * 256;
+        second[p] = (w == 0) ? (t * 256) : ((t + 1) * 256);
+        weight[p] = w;
+    }
+}
+
+/*!
+ * \brief Creates the scratch buffers of clahe()
+ *
+ * The image is divided into \p tilesX by \p tilesY tiles. The tables that
+ * tell which tiles are interpolated for each row and column are calculated
+ * here, so clahe() only has to build the histograms and lookup tables. Use
+ * deleteClahe() to free the buffers.
+ *
+ * \param[in] cols      Number of columns of the images to process
+ * \param[in] rows      Number of rows of the images to process
+ * \param[in] tilesX    Number of tiles in horizontal direction
+ * \param[in] tilesY    Number of tiles in vertical direction
+ * \param[in] clipLimit Maximum number of pixels in a histogram bin, relative
+ *                      to the average number of pixels per bin. Must be at
+ *                      least 1. Larger values give more contrast and more
+ *                      noise.
+ *
+ * \return The scratch buffers
+ */
+clahe_t newClahe(const uint32_t cols, const uint32_t rows, const uint32_t tilesX,
+                 const uint32_t tilesY, const float clipLimit)
+{
+    // Verify parameters
+    ASSERT((tilesX == 0) || (tilesX > cols), "tilesX is invalid");
+    ASSERT((tilesY == 0) || (tilesY > rows), "tilesY is invalid");
+    ASSERT(clipLimit < 1.0f, "clipLimit is invalid");
+
+    clahe_t c =
+    {
+        .cols      = cols,
+        .rows      = rows,
+        .tilesX    = tilesX,
+        .tilesY    = tilesY,
+        .clipLimit = clipLimit,
+        .hist      = newInt32Image(256, tilesX * tilesY),
+        .luts      = newUint8Image(256 * tilesX, tilesY),
+        .colMap    = newInt32Image(cols, 3),
+        .rowMap    = newInt32Image(rows, 3),
+    };
+
+    ASSERT((c.hist == NULL) || (c.luts == NULL) || (c.colMap == NULL) ||
+           (c.rowMap == NULL), "unable to allocate memory for the buffers");
+
+    claheMap(c.colMap, cols, tilesX);
+    claheMap(c.rowMap, rows, tilesY);
+
+    return c;
+}
+
+/*!
+ * \brief Deletes the scratch buffers of clahe()
+ *
+ * \param[in,out] c A pointer to the scratch buffers
+ */
+void deleteClahe(clahe_t *c)
+{
+    deleteImage(c->rowMap);
+    deleteImage(c->colMap);
+    deleteImage(c->luts);
+    deleteImage(c->hist);
+
+    memset(c, 0, sizeof(clahe_t));
+}
+
+/*!
+ * \brief Calculates the lookup table of one tile of clahe()
+ *
+ * Bins with more than the clip limit are cut off. The pixels that are cut off
+ * are spread evenly over all bins, after which the lookup table maps the
+ * cumulative histogram onto the range 0 to 255.
+ *
+ * \param[in,out] h         A pointer to the 256 bins of the tile
+ * \param[out]    lut       A pointer to the 256 entries of the lookup table
+ * \param[in]     clipLimit See newClahe()
+ */
+static void claheLut(uint32_t *h, uint8_pixel_t *lut, const float clipLimit)
+{
+    uint32_t total = 0;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        total += h[i];
+    }
+
+    uint32_t limit = (uint32_t)((clipLimit * (float)total) / 256.0f);
+    uint32_t excess = 0;
+
+    limit = (limit < 1) ? 1 : limit;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        if(h[i] > limit)
+        {
+            excess += h[i] - limit;
+            h[i] = limit;
+        }
+    }
+
+    // Spread the excess, the remainder over equally spaced bins
+    uint32_t add = excess / 256;
+    uint32_t residual = excess % 256;
+    uint32_t step = (residual == 0) ? 256 : (256 / residual);
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        h[i] += add;
+    }
+
+    for(uint32_t i=0; (i<256) && (residual > 0); i+=step, --residual)
+    {
+        h[i]++;
+    }
+
+    uint32_t cdf = 0;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        cdf += h[i];
+        lut[i] = (uint8_pixel_t)((((uint64_t)cdf * 255) + (total / 2)) / total);
+    }
+}
+
+/*!
+ * \brief Contrast limited adaptive histogram equalization (CLAHE)
+ *
+ * Every tile gets its own equalization lookup table, calculated from the
+ * clipped histogram of the tile. Clipping limits the amplification of noise
+ * in flat areas. Each destination pixel is interpolated bilinearly between
+ * the lookup tables of the four nearest tile centers, which prevents visible
+ * tile borders.
+ *
+ * The histograms of all tiles are built in a single pass over the image.
+ * The source and destination image may be the same image.
+ *
+ * \param[in]     src A pointer to the source image
+ * \param[out]    dst A pointer to the destination image
+ * \param[in,out] c   A pointer to the scratch buffers created by newClahe()
+ *                    for the size of \p src
+ */
+void clahe(const image_t *src, image_t *dst, clahe_t *c)
 {
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
@@ -104,33 +706,97 @@ void brightness(const image_t *src, image_t *dst, const int32_t brightness)
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    int32_t i;
+    // Verify buffer validity
+    ASSERT(c == NULL, "c is invalid");
+    ASSERT((c->cols != src->cols) || (c->rows != src->rows), "buffers have a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t tilesX = c->tilesX;
+    const int32_t tilesY = c->tilesY;
 
-    // Loop all pixels
-    for(int32_t y=0; y<src->rows; y++)
+    uint32_t *hist = (uint32_t *)c->hist->data;
+    uint8_pixel_t *luts = (uint8_pixel_t *)c->luts->data;
+
+    clearInt32Image(c->hist);
+
+    // Step 1: histograms of all tiles. Tile t covers the positions p for which
+    // p * tiles / n equals t.
+    for(int32_t y=0; y<rows; ++y)
     {
-        for(int32_t x=0; x<src->cols; x++)
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint32_t *h = hist + ((((y * tilesY) / rows) * tilesX) * 256);
+        int32_t x = 0;
+
+        for(int32_t tx=0; tx<tilesX; ++tx, h+=256)
         {
-            // Get the pixel from the original image and modify brightness
-            i = getUint8Pixel(src, x, y) + brightness;
+            // First column of the next tile
+            int32_t end = (((tx + 1) * cols) + tilesX - 1) / tilesX;
 
-            // Clip the result
-            if(i>255)
+            for(; x<end; ++x)
             {
-                i=255;
+                h[s[x]]++;
             }
+        }
+    }
 
-            if(i<0)
-            {
-                i=0;
-            }
+    // Step 2: lookup table of each tile
+    for(int32_t t=0; t<(tilesX * tilesY); ++t)
+    {
+        claheLut(hist + (t * 256), luts + (t * 256), c->clipLimit);
+    }
+
+    // Step 3: bilinear interpolation between the lookup tables
+    const int32_t *first = (int32_t *)c->colMap->data;
+    const int32_t *second = first + cols;
+    const int32_t *weight = second + cols;
+    const int32_t lutCols = 256 * tilesX;
+
+    for(int32_t y=0; y<rows; ++y)
+    {
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        const int32_t *rowMap = (int32_t *)c->rowMap->data;
+        const uint8_pixel_t *top = luts + ((rowMap[y] / 256) * lutCols);
+        const uint8_pixel_t *bottom = luts + ((rowMap[rows + y] / 256) * lutCols);
+        const int32_t wy = rowMap[(2 * rows) + y];
+
+        for(int32_t x=0; x<cols; ++x)
+        {
+            const int32_t v = s[x];
+            const int32_t wx = weight[x];
+
+            int32_t t = (top[first[x] + v] * (256 - wx)) + (top[second[x] + v] * wx);
+            int32_t b = (bottom[first[x] + v] * (256 - wx)) + (bottom[second[x] + v] * wx);
 
-            // Store the result
-            setUint8Pixel(dst, x, y, i);
+            d[x] = (uint8_pixel_t)(((t * (256 - wy)) + (b * wy) + 32768) >> 16);
         }
     }
 }
 
+/*!
+ * \brief Adjusts the image brightness
+ *
+ * The \p brightness is added to each pixel value in the source image and the
+ * result is stored in the destination image.
+ * \n
+ * s_i = g_i + \p brightness
+ * \n
+ * The pixels are mapped with lutBrightness(). The source and destination
+ * image may be the same image.
+ *
+ * \param[in]  src        A pointer to the source image
+ * \param[out] dst        A pointer to the destination image
+ * \param[in]  brightness Brightness value that is added to each pixel
+ */
+void brightness(const image_t *src, image_t *dst, const int32_t brightness)
+{
+    lut_t lut = lutBrightness(brightness);
+
+    applyLut(src, dst, lut.table);
+}
+
 /*!
  * \brief Enhances the visual appearance of an image
  *
@@ -140,6 +806,8 @@ void brightness(const image_t *src, image_t *dst, const int32_t brightness)
  * \n
  *     s_i = (\p contrast * (g_i - average)) + average
  * \n
+ * The pixels are mapped with lutContrast(). The source and destination image
+ * may be the same image.
  *
  * \param[in]  src      A pointer to the source image
  * \param[out] dst      A pointer to the destination image
@@ -161,52 +829,18 @@ void contrast(const image_t *src, image_t *dst, const float contrast)
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Init sum and average variables
-    uint32_t pixelValueSum = 0;
-    float pixelValueAverage = 0;
-
-    // Calculate amount of pixels in frame
-    uint32_t height =  src->rows;
-    uint32_t width = src->cols;
-    uint32_t pixelAmount = height * width;
-
-    // Loop all pixels and calculate the sum of all pixel values
-    for (uint32_t x = 0; x < width; x++)
-    {
-        for (uint32_t y = 0; y < height; y++)
-        {
-            // Get the pixel value
-            uint8_pixel_t pixelValue = getUint8Pixel(src, x, y);
-
-            // Add the pixel value to the sum
-            pixelValueSum += pixelValue;
-
-        }
-    }
-
+    // The sum of all pixel values follows from the histogram
+    uint32_t hist[256];
+    histogramStats_t stats = histogramStats(src, NULL, hist);
 
     // Avoid division by zero. Check if there are pixels in the frame
-    if (pixelAmount == 0) return;
+    if (stats.count == 0) return;
 
     // Calculate the average pixel value
-    pixelValueAverage = (float)pixelValueSum / (float)pixelAmount;
+    float pixelValueAverage = (float)stats.sum / (float)stats.count;
 
-    // Loop through all pixels and apply the contrast formula
-    for (uint32_t x = 0; x < width; x++)
-    {
-        for (uint32_t y = 0; y < height; y++)
-        {
-            // Get the old pixel value
-            float oldPixelValue = (float) getUint8Pixel(src, x, y);
-
-            float newPixelValue = contrast * (oldPixelValue - pixelValueAverage) + pixelValueAverage;
-
-            // Clip the result
-            if(newPixelValue > 255) { newPixelValue = 255;}
-            if (newPixelValue < 0)  { newPixelValue = 0;  }
+    // Apply the contrast formula to all pixels
+    lut_t lut = lutContrast(contrast, pixelValueAverage);
 
-            // Set the new pixel value
-            setUint8Pixel(dst, x, y, (uint8_pixel_t)newPixelValue);
-        }
-    }
+    applyLut(src, dst, lut.table);
 }
@@ -41,9 +41,61 @@ extern "C" {
 
 #include "image.h"
 
+/// Statistics of the pixels counted by histogramStats()
+typedef struct
+{
+    uint32_t      count; ///< Number of pixels
+    uint64_t      sum;   ///< Sum of the pixel values
+    uint8_pixel_t min;   ///< Smallest pixel value. 255 if no pixel was counted.
+    uint8_pixel_t max;   ///< Largest pixel value. 0 if no pixel was counted.
+
+}histogramStats_t;
+
+/// \brief A lookup table for a point operation on uint8 images
+///
+/// Entry g holds the new value of pixel value g. Lookup tables are built by the
+/// lut<operation>() functions, combined with lutCompose() and applied to an
+/// image with applyLut() of the image fundamentals.
+typedef struct
+{
+    uint8_pixel_t table[256]; ///< New value for every pixel value
+
+}lut_t;
+
+/// Tile histograms, lookup tables and interpolation weights of clahe()
+typedef struct
+{
+    int32_t  cols;      ///< Number of columns of the source image
+    int32_t  rows;      ///< Number of rows of the source image
+    int32_t  tilesX;    ///< Number of tiles in horizontal direction
+    int32_t  tilesY;    ///< Number of tiles in vertical direction
+    float    clipLimit; ///< Maximum bin count relative to the average bin count
+    image_t *hist;      ///< One histogram of 256 bins per tile
+    image_t *luts;      ///< One lookup table of 256 entries per tile
+    image_t *colMap;    ///< Per column: left tile, right tile and weight
+    image_t *rowMap;    ///< Per row: upper tile, lower tile and weight
+
+}clahe_t;
+
 // Functions are documented in the source file
 
 void histogram(const image_t *img, uint32_t *hist);
+void histogramMasked(const image_t *img, const image_t *msk, uint32_t *hist);
+histogramStats_t histogramStats(const image_t *img, const image_t *msk, uint32_t *hist);
+lut_t lutIdentity(void);
+lut_t lutBrightness(const int32_t brightness);
+lut_t lutContrast(const float contrast, const float average);
+lut_t lutThreshold(const uint8_pixel_t min, const uint8_pixel_t max);
+lut_t lutSelectedToValue(const uint8_pixel_t selected, const uint8_pixel_t value);
+lut_t lutScale(const uint8_pixel_t min, const uint8_pixel_t max);
+lut_t lutBinaryToDisplay(void);
+lut_t lutCompose(const lut_t *first, const lut_t *second);
+void equalizeLut(const uint32_t *hist, uint8_pixel_t *lut);
+void equalize(const image_t *src, image_t *dst);
+clahe_t newClahe(const uint32_t cols, const uint32_t rows, const uint32_t tilesX,
+                 const uint32_t tilesY, const float clipLimit);
+void deleteClahe(clahe_t *c);
+void clahe(const image_t *src, image_t *dst, clahe_t *c);
 void brightness(const image_t *src, image_t *dst, const int32_t brightness);
 void contrast(const image_t *src, image_t *dst, const float contrast);
 
@@ -70,6 +70,10 @@ typedef enum
     IMGTYPE_FLOAT  =  8, ///< An image with pixels of type ::float_pixel_t.
     IMGTYPE_UYVY   = 16, ///< An image with pixels of type ::uyvy_pixel_t.
     IMGTYPE_BGR888 = 32, ///< An image with pixels of type ::bgr888_pixel_t.
+    IMGTYPE_INT64  = 64, ///< An image with pixels of type ::int64_pixel_t.
+    IMGTYPE_COMPLEX = 128, ///< An image with pixels of type ::complex_pixel_t.
+    IMGTYPE_BIN1   = 256, ///< A binary image with 1 bit per pixel, packed in
+                          ///< words of type ::bin1_word_t.
 
 }eImageType;
 
@@ -88,6 +92,11 @@ typedef int16_t int16_pixel_t;
 /// 32 bits per pixel
 typedef int32_t int32_pixel_t;
 
+/// \brief Type definition of an int64 pixel
+///
+/// 64 bits per pixel
+typedef int64_t int64_pixel_t;
+
 /// \brief Type definition of a float pixel
 ///
 /// 32 bits per pixel
@@ -113,6 +122,28 @@ typedef struct bgr888_pixel_t
 
 }bgr888_pixel_t;
 
+/// \brief Type definition of a complex pixel
+///
+/// Two floats per pixel
+typedef struct complex_pixel_t
+{
+    float real;      ///< real part of the complex number
+    float imaginary; ///< imaginary part of the complex number
+
+}complex_pixel_t;
+
+/// \brief Type definition of a word of a bit-packed binary image
+///
+/// Every row of an IMGTYPE_BIN1 image is stored as whole words. Pixel x of a
+/// row is bit (x % 64) of word (x / 64), so the leftmost pixel is the least
+/// significant bit. The bits after the last column of a row are undefined.
+typedef uint64_t bin1_word_t;
+
+/*!
+ * \brief Returns the number of words that hold a row of \p cols binary pixels
+ */
+#define BIN1_WORDS(cols) (((cols) + 63) / 64)
+
 /// \name Definitions for min/max pixel values
 /// \{
 
@@ -128,6 +159,9 @@ typedef struct bgr888_pixel_t
 #define INT32_PIXEL_MIN (INT32_MIN)
 #define INT32_PIXEL_MAX (INT32_MAX)
 
+#define INT64_PIXEL_MIN (INT64_MIN)
+#define INT64_PIXEL_MAX (INT64_MAX)
+
 #define FLOAT_PIXEL_MIN (-(FLT_MAX))
 #define FLOAT_PIXEL_MAX (FLT_MAX)
 
@@ -170,15 +204,43 @@ typedef struct bgr888_pixel_t
 #endif
 
 /// Defines the attributes of an image
+///
+/// The \p stride allows an image to be a view on a region of interest (ROI)
+/// within a larger image. Pixel (c,r) is found at data[r * stride + c]. A
+/// stride of 0 means that the rows are packed, so the stride equals \p cols.
+/// This keeps images that are initialized without a stride valid.
 typedef struct
 {
-    int32_t     cols; ///< Number of columns in the image
-    int32_t     rows; ///< Number of rows in the image
-    eImageType  type; ///< The type of pixels in the image
-    uint8_t    *data; ///< A pointer to the pixel data
+    int32_t     cols;   ///< Number of columns in the image
+    int32_t     rows;   ///< Number of rows in the image
+    eImageType  type;   ///< The type of pixels in the image
+    uint8_t    *data;   ///< A pointer to the pixel data
+    int32_t     stride; ///< Number of pixels from the start of one row to the
+                        ///< start of the next row. 0 if the rows are packed.
 
 }image_t;
 
+/*!
+ * \brief Returns the number of pixels from the start of one row to the start of
+ *        the next row
+ */
+#define IMAGE_STRIDE(img) (((img)->stride > 0) ? (img)->stride : (img)->cols)
+
+/*!
+ * \brief Evaluates to 1 if the rows of the image are stored without gaps
+ */
+#define IMAGE_IS_PACKED(img) (IMAGE_STRIDE(img) == (img)->cols)
+
+/*!
+ * \brief Alignment in bytes of the pixel data of images
+ *
+ * The pixel data of every image created by a new<type>Image() function starts
+ * at a multiple of this value. Images created by newPaddedImage() also have
+ * every row padded to a multiple of this value, so kernels can use aligned
+ * full-width loads without handling leftover pixels.
+ */
+#define IMAGE_ALIGNMENT (64)
+
 /// Defines the relative brightness to look for in an image
 typedef enum
 {
@@ -187,6 +249,25 @@ typedef enum
 
 }eBrightness;
 
+/// Defines the method that selects a threshold from the histogram
+typedef enum
+{
+    THRESHOLD_OTSU = 0, ///< Highest between class variance, see thresholdOtsu()
+    THRESHOLD_OPTIMUM,  ///< Valley between two peaks, see thresholdOptimum()
+
+}eThresholdMethod;
+
+/// Defines how adaptive thresholding calculates the threshold from the mean m
+/// and the standard deviation s of the window around each pixel. The formulas
+/// are for dark objects.
+typedef enum
+{
+    ADAPTIVE_NIBLACK = 0, ///< m - k * s
+    ADAPTIVE_SAUVOLA,     ///< m * (1 + k * (s / 128 - 1))
+    ADAPTIVE_BRADLEY,     ///< m * (1 - k)
+
+}eAdaptiveMethod;
+
 /// Defines the neighbourhood connectivity
 typedef enum
 {
@@ -195,6 +276,44 @@ typedef enum
 
 }eConnected;
 
+/// Defines how the pixels outside the image are obtained by operators that use
+/// a window. The examples show the pixels left and right of a row abcd.
+typedef enum
+{
+    BORDER_CONSTANT = 0, ///< Constant value: xxx|abcd|xxx
+    BORDER_REPLICATE,    ///< Repeat the border pixel: aaa|abcd|ddd
+    BORDER_REFLECT,      ///< Mirror at the border: cba|abcd|dcb
+    BORDER_WRAP,         ///< Continue at the opposite side: bcd|abcd|abc
+
+}eBorder;
+
+/// Defines how the magnitude of a gradient is calculated
+typedef enum
+{
+    NORM_L1 = 1, ///< Sum of the absolute values: |gx| + |gy|
+    NORM_L2 = 2, ///< Euclidean length sqrt(gx^2 + gy^2), approximated by
+                 ///< max + 3/8 min with an error below 7%
+
+}eNorm;
+
+/// Defines the shape of the transfer function of a frequency domain filter
+typedef enum
+{
+    FILTER_IDEAL = 0,   ///< Passes or blocks frequencies with a sharp edge
+    FILTER_BUTTERWORTH, ///< Smooth edge, steeper for a higher order
+    FILTER_GAUSSIAN,    ///< Smooth edge without ringing
+
+}eFilterShape;
+
+/// Defines the frequencies that pass a frequency domain filter
+typedef enum
+{
+    FILTER_LOWPASS = 0, ///< Frequencies below the cutoff
+    FILTER_HIGHPASS,    ///< Frequencies above the cutoff
+    FILTER_BANDPASS,    ///< Frequencies within a band around the cutoff
+
+}eFilterPass;
+
 /// Defines a pixel coordinate
 typedef struct
 {
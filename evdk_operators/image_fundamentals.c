@@ -34,22 +34,65 @@
  *
  *****************************************************************************/
 
+#include <stddef.h>
 #include <string.h>
 #include "image_fundamentals.h"
 
-#define MAX_IMAGES (16)
+/*!
+ * \brief Images are handed out by a pool. Every image is stored in a single
+ *        block that holds the pool administration, the image_t structure and
+ *        the pixel data. Released blocks are kept in free lists, one list per
+ *        size class, so the next image of a similar size is created without
+ *        calling malloc(). The size classes are spaced a quarter of a power of
+ *        two apart, so at most 25% of a block is unused. The pixel data of a
+ *        block starts at a multiple of IMAGE_ALIGNMENT bytes.
+ */
+#define POOL_MIN_BLOCK_SIZE   (64)
+#define POOL_SIZE_CLASSES     (4 * 26)
+
+/*!
+ * \brief Pool administration of a single image
+ */
+typedef struct poolBlock_t
+{
+    struct poolBlock_t *prev; ///< Previous block in the list of live images
+    struct poolBlock_t *next; ///< Next block in the list of live images or free list
+    void     *memory;         ///< Memory returned by malloc(), used for free()
+    uint32_t  sequence;       ///< Creation sequence number of the image
+    uint8_t   sizeClass;      ///< Size class of the block
+    uint8_t   hasData;        ///< 1 if the pixel data is stored in the block
+    image_t   img;            ///< The image handed out to the application
+}poolBlock_t;
+
+/// Offset of the pixel data from the start of a block
+#define POOL_HEADER_SIZE ((sizeof(poolBlock_t) + 7) & ~((size_t)7))
+
+/// Returns the block that holds \p image
+#define POOL_BLOCK(image) \
+    ((poolBlock_t *)((uint8_t *)(image) - offsetof(poolBlock_t, img)))
+
+/*!
+ * \brief Most recently created live image. Is used to release all images
+ *        when calling the function deleteAllImages() or imagePoolRelease().
+ */
+static poolBlock_t *poolLive = NULL;
 
 /*!
- * \brief Local array of image pointers. Is used to free all allocated image
- *        data when calling the function deleteAllImages(). The value of the
- *        MAX_IMAGES define might need tweaking to your application. Increasing
- *        this number allows for more images to be stored, but requires more
- *        memory and more checks every time an image is created or deleted.
+ * \brief Free lists of released blocks, one list per size class
  */
-static image_t * imgs[MAX_IMAGES] = {NULL};
+static poolBlock_t *poolFree[POOL_SIZE_CLASSES] = {NULL};
+
+/// Sequence number of the next image that is created
+static uint32_t poolSequence = 1;
 
 // Function prototypes
 uint8_t clip(int32_t val);
+static void copyRows(const image_t *src, image_t *dst, const uint32_t size);
+static uint32_t poolSizeClass(const size_t size);
+static size_t poolBlockSize(const uint32_t sizeClass);
+static image_t *newImage(const eImageType type, const uint32_t cols,
+                         const uint32_t rows, const uint32_t stride,
+                         const uint8_t allocate);
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -68,6 +111,169 @@ inline uint8_t clip(int32_t val)
     return (val < 0) ? 0 : ((val > 255) ? 255 : val);
 }
 
+/*!
+ * \brief Copies the pixel data of \p src to \p dst row by row
+ *
+ * Packed images are copied with a single memcpy(). Otherwise, every row is
+ * copied separately, so only the pixels within a region of interest are
+ * touched.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] dst  A pointer to the destination image
+ * \param[in]  size The size of a single pixel in bytes
+ */
+static void copyRows(const image_t *src, image_t *dst, const uint32_t size)
+{
+    if(IMAGE_IS_PACKED(src) && IMAGE_IS_PACKED(dst))
+    {
+        memcpy(dst->data, src->data, src->cols * src->rows * size);
+        return;
+    }
+
+    const uint8_t *s = src->data;
+    uint8_t *d = dst->data;
+
+    for(int32_t y=0; y<src->rows; y++)
+    {
+        memcpy(d, s, src->cols * size);
+
+        s += IMAGE_STRIDE(src) * size;
+        d += IMAGE_STRIDE(dst) * size;
+    }
+}
+
+/*!
+ * \brief Returns the smallest size class that holds \p size bytes
+ *
+ * \param[in] size The required block size in bytes
+ *
+ * \return The size class. POOL_SIZE_CLASSES if \p size is too large.
+ */
+static uint32_t poolSizeClass(const size_t size)
+{
+    // Find the power of two range (base, 2*base] that holds the size
+    uint32_t e = 0;
+    while((e < (POOL_SIZE_CLASSES / 4)) &&
+          (((size_t)POOL_MIN_BLOCK_SIZE << (e + 1)) < size))
+    {
+        e++;
+    }
+
+    if(e == (POOL_SIZE_CLASSES / 4))
+    {
+        return POOL_SIZE_CLASSES;
+    }
+
+    // Split the range in four steps
+    size_t base = (size_t)POOL_MIN_BLOCK_SIZE << e;
+    size_t step = base / 4;
+    uint32_t sub = (size <= base) ? 0 : (uint32_t)((size - base + step - 1) / step);
+
+    return (e * 4) + sub;
+}
+
+/*!
+ * \brief Returns the size in bytes of a block of size class \p sizeClass
+ *
+ * \param[in] sizeClass The size class
+ *
+ * \return The block size in bytes
+ */
+static size_t poolBlockSize(const uint32_t sizeClass)
+{
+    size_t base = (size_t)POOL_MIN_BLOCK_SIZE << (sizeClass / 4);
+
+    return base + ((base / 4) * (sizeClass % 4));
+}
+
+/*!
+ * \brief Acquires an image from the pool
+ *
+ * A block of the matching size class is taken from the free list. Only if the
+ * free list is empty, a new block is allocated with malloc(). The image is
+ * added to the front of the list of live images, so the list is ordered from
+ * the newest to the oldest image.
+ *
+ * \param[in] type     The image type
+ * \param[in] cols     The number of columns for the new image
+ * \param[in] rows     The number of rows for the new image
+ * \param[in] stride   The number of pixels from the start of one row to the
+ *                     start of the next row
+ * \param[in] allocate 1 if pixel data must be allocated, 0 for an empty image
+ *
+ * \return A pointer to the new image. NULL if memory allocation failed.
+ */
+static image_t *newImage(const eImageType type, const uint32_t cols,
+                         const uint32_t rows, const uint32_t stride,
+                         const uint8_t allocate)
+{
+    size_t size = POOL_HEADER_SIZE;
+
+    if(allocate)
+    {
+        if(type == IMGTYPE_BIN1)
+        {
+            // The stride of a binary image is a multiple of 64 pixels
+            size += ((size_t)stride / 8) * rows;
+        }
+        else
+        {
+            size += (size_t)stride * rows * getPixelSize(type);
+        }
+    }
+
+    uint32_t sizeClass = poolSizeClass(size);
+    if(sizeClass >= POOL_SIZE_CLASSES)
+    {
+        // Image is too large
+        return NULL;
+    }
+
+    poolBlock_t *block = poolFree[sizeClass];
+    if(block != NULL)
+    {
+        // Reuse a released block
+        poolFree[sizeClass] = block->next;
+    }
+    else
+    {
+        // Allocate extra memory, so the pixel data can be aligned
+        uint8_t *memory = (uint8_t *)malloc(poolBlockSize(sizeClass) + IMAGE_ALIGNMENT);
+        if(memory == NULL)
+        {
+            // Unable to allocate memory for new image
+            return NULL;
+        }
+
+        uintptr_t data = ((uintptr_t)memory + POOL_HEADER_SIZE + (IMAGE_ALIGNMENT - 1)) &
+                         ~((uintptr_t)IMAGE_ALIGNMENT - 1);
+
+        block = (poolBlock_t *)(data - POOL_HEADER_SIZE);
+        block->memory = memory;
+    }
+
+    block->sizeClass = (uint8_t)sizeClass;
+    block->hasData = allocate;
+    block->sequence = poolSequence++;
+
+    block->img.cols = cols;
+    block->img.rows = rows;
+    block->img.stride = stride;
+    block->img.type = type;
+    block->img.data = allocate ? ((uint8_t *)block + POOL_HEADER_SIZE) : NULL;
+
+    // Add image to the front of the list of live images
+    block->prev = NULL;
+    block->next = poolLive;
+    if(poolLive != NULL)
+    {
+        poolLive->prev = block;
+    }
+    poolLive = block;
+
+    return &block->img;
+}
+
 /// \name Getter functions for individual pixels
 /// \{
 
@@ -83,32 +289,32 @@ inline uint8_t clip(int32_t val)
 
 inline uint8_pixel_t getUint8Pixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((uint8_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((uint8_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 
 inline int16_pixel_t getInt16Pixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((int16_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((int16_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 
 inline int32_pixel_t getInt32Pixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((int32_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((int32_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 
 inline float_pixel_t getFloatPixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((float_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((float_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 
 inline uyvy_pixel_t getUyvyPixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((uyvy_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((uyvy_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 
 inline bgr888_pixel_t getBgr888Pixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((bgr888_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((bgr888_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 /// \}
 
@@ -129,32 +335,32 @@ inline bgr888_pixel_t getBgr888Pixel(const image_t *img, const int32_t c, const
 
 inline void setUint8Pixel(const image_t *img, const int32_t c, const int32_t r, const  uint8_pixel_t value)
 {
-    *((uint8_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((uint8_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
 }
 
 inline void setInt16Pixel(const image_t *img, const int32_t c, const int32_t r, const int16_pixel_t value)
 {
-    *((int16_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((int16_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
 }
 
 inline void setInt32Pixel(const image_t *img, const int32_t c, const int32_t r, const int32_pixel_t value)
 {
-    *((int32_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((int32_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
 }
 
 inline void setFloatPixel(const image_t *img, const int32_t c, const int32_t r, const float_pixel_t value)
 {
-    *((float_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((float_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
 }
 
 inline void setUyvyPixel(const image_t *img, const int32_t c, const int32_t r, const uyvy_pixel_t value)
 {
-    *((uyvy_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((uyvy_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
 }
 
 inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r, const bgr888_pixel_t value)
 {
-    *((bgr888_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((bgr888_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
 }
 
 /// \}
@@ -170,7 +376,8 @@ inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r,
  *
  * After the image has been used and is not needed any more, make sure that the
  * image is deleted by calling the function delete<type>Image() or
- * deleteAllImages().
+ * deleteAllImages(). Images are taken from a pool, so memory of deleted
+ * images is reused without calling malloc().
  *
  * \param[in] cols The number of columns for the new image
  * \param[in] rows The number of rows for the new image
@@ -179,236 +386,70 @@ inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r,
  */
 image_t *newUint8Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(uint8_pixel_t));
-
-    if(img->data == NULL)
-    {
-        // Unable to allocate memory for data
-        free(img);
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UINT8;
-
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    return NULL;
+    return newImage(IMGTYPE_UINT8, cols, rows, cols, 1);
 }
 
 image_t *newInt16Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(int16_pixel_t));
-
-    if(img->data == NULL)
-    {
-        // Unable to allocate memory for data
-        free(img);
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT16;
-
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    return NULL;
+    return newImage(IMGTYPE_INT16, cols, rows, cols, 1);
 }
 
 image_t *newInt32Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(int32_pixel_t));
-
-    if(img->data == NULL)
-    {
-        // Unable to allocate memory for data
-        free(img);
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT32;
-
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    return NULL;
+    return newImage(IMGTYPE_INT32, cols, rows, cols, 1);
 }
 
 image_t *newFloatImage(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(float_pixel_t));
-
-    if(img->data == NULL)
-    {
-        // Unable to allocate memory for data
-        free(img);
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_FLOAT;
-
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    return NULL;
+    return newImage(IMGTYPE_FLOAT, cols, rows, cols, 1);
 }
 
 image_t *newUyvyImage(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(uyvy_pixel_t));
-
-    if(img->data == NULL)
-    {
-        // Unable to allocate memory for data
-        free(img);
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UYVY;
-
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    return NULL;
+    return newImage(IMGTYPE_UYVY, cols, rows, cols, 1);
 }
 
 image_t *newBgr888Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(bgr888_pixel_t));
-
-    if(img->data == NULL)
-    {
-        // Unable to allocate memory for data
-        free(img);
-        return NULL;
-    }
+    return newImage(IMGTYPE_BGR888, cols, rows, cols, 1);
+}
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_BGR888;
+image_t *newInt64Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_INT64, cols, rows, cols, 1);
+}
 
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
+image_t *newComplexImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_COMPLEX, cols, rows, cols, 1);
+}
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+image_t *newBin1Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_BIN1, cols, rows, BIN1_WORDS(cols) * 64, 1);
+}
 
-    return NULL;
+/*!
+ * \brief Creates a new image with padded rows
+ *
+ * Every row starts at a multiple of IMAGE_ALIGNMENT bytes, so the stride of
+ * the image is larger than the number of columns if the row size is not a
+ * multiple of IMAGE_ALIGNMENT. Kernels can read and write the padding pixels,
+ * which allows aligned full-width loads without leftover handling. The value
+ * of the padding pixels is undefined.
+ *
+ * After the image has been used and is not needed any more, make sure that the
+ * image is deleted by calling the function deleteImage() or deleteAllImages().
+ *
+ * \param[in] type The image type. Must be of type ::eImageType.
+ * \param[in] cols The number of columns for the new image
+ * \param[in] rows The number of rows for the new image
+ *
+ * \return A pointer to the new image. NULL if memory allocation failed.
+ */
+image_t *newPaddedImage(const eImageType type, const uint32_t cols, const uint32_t rows)
+{
+    return newImage(type, cols, rows, getPaddedStride(type, cols), 1);
 }
 
 /// \}
@@ -432,188 +473,349 @@ image_t *newBgr888Image(const uint32_t cols, const uint32_t rows)
  */
 image_t *newEmptyUint8Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
+    return newImage(IMGTYPE_UINT8, cols, rows, cols, 0);
+}
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UINT8;
-    img->data = NULL;
+image_t *newEmptyInt16Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_INT16, cols, rows, cols, 0);
+}
 
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
-    }
+image_t *newEmptyInt32Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_INT32, cols, rows, cols, 0);
+}
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+image_t *newEmptyFloatImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_FLOAT, cols, rows, cols, 0);
+}
 
-    return NULL;
+image_t *newEmptyUyvyImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(IMGTYPE_UYVY, cols, rows, cols, 0);
 }
 
-image_t *newEmptyInt16Image(const uint32_t cols, const uint32_t rows)
+image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
+    return newImage(IMGTYPE_BGR888, cols, rows, cols, 0);
+}
+
+/// \}
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT16;
-    img->data = NULL;
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/// \name Functions for region of interest (ROI) views
+/// \{
 
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+/*!
+ * \brief Returns the size in bytes of a single pixel of type \p type
+ *
+ * \param[in] type The image type. Must be of type ::eImageType.
+ *
+ * \return The pixel size in bytes. 0 if the type is unknown or, as for
+ *         IMGTYPE_BIN1, a pixel is smaller than a byte.
+ */
+uint32_t getPixelSize(const eImageType type)
+{
+    switch(type)
     {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
+    case IMGTYPE_UINT8:  return sizeof(uint8_pixel_t);
+    case IMGTYPE_INT16:  return sizeof(int16_pixel_t);
+    case IMGTYPE_INT32:  return sizeof(int32_pixel_t);
+    case IMGTYPE_FLOAT:  return sizeof(float_pixel_t);
+    case IMGTYPE_UYVY:   return sizeof(uyvy_pixel_t);
+    case IMGTYPE_BGR888: return sizeof(bgr888_pixel_t);
+    case IMGTYPE_INT64:  return sizeof(int64_pixel_t);
+    case IMGTYPE_COMPLEX: return sizeof(complex_pixel_t);
+    case IMGTYPE_BIN1:   break;
     }
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    return NULL;
+    return 0;
 }
 
-image_t *newEmptyInt32Image(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Returns the smallest stride for which every row starts at a multiple
+ *        of IMAGE_ALIGNMENT bytes
+ *
+ * \param[in] type The image type. Must be of type ::eImageType.
+ * \param[in] cols The number of columns
+ *
+ * \return The stride in pixels
+ */
+uint32_t getPaddedStride(const eImageType type, const uint32_t cols)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
+    // A binary image has 8 pixels per byte
+    if(type == IMGTYPE_BIN1)
     {
-        // Unable to allocate memory for new image
-        return NULL;
+        return ((cols + (8 * IMAGE_ALIGNMENT) - 1) / (8 * IMAGE_ALIGNMENT)) * (8 * IMAGE_ALIGNMENT);
     }
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT32;
-    img->data = NULL;
+    uint32_t size = getPixelSize(type);
 
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    // The number of pixels that fit exactly in a multiple of IMAGE_ALIGNMENT
+    // bytes, for example 64 for uint8 and 64 for BGR888 (192 bytes)
+    uint32_t unit = IMAGE_ALIGNMENT;
+    while((unit > 1) && ((size * (unit / 2)) % IMAGE_ALIGNMENT == 0))
     {
-        if(imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return(img);
-        }
+        unit /= 2;
     }
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+    return ((cols + unit - 1) / unit) * unit;
+}
+
+/*!
+ * \brief Checks if every row of an image starts at a multiple of
+ *        IMAGE_ALIGNMENT bytes
+ *
+ * If so, every row can be processed with aligned loads up to the stride of the
+ * image.
+ *
+ * \param[in] img A pointer to the image
+ *
+ * \return 1 if the rows are aligned, 0 otherwise
+ */
+uint8_t isAlignedImage(const image_t *img)
+{
+    // A binary image has 8 pixels per byte
+    const uint32_t rowSize = (img->type == IMGTYPE_BIN1) ?
+                                 (uint32_t)(IMAGE_STRIDE(img) / 8) :
+                                 (IMAGE_STRIDE(img) * getPixelSize(img->type));
 
-    return NULL;
+    return ((((uintptr_t)img->data) % IMAGE_ALIGNMENT) == 0) &&
+           ((rowSize % IMAGE_ALIGNMENT) == 0);
 }
 
-image_t *newEmptyFloatImage(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Creates a view on a rectangular region of interest within an image
+ *
+ * The view shares the pixel data with \p img, so no pixels are copied.
+ * Operators that are applied to the view only read and write the pixels
+ * within the region of interest. Because the view does not own any data, it
+ * must not be deleted. A view of a view is allowed.
+ *
+ * \param[in] img  A pointer to the image that contains the region of interest
+ * \param[in] x    Column (x) coordinate of the top-left pixel of the region
+ * \param[in] y    Row (y) coordinate of the top-left pixel of the region
+ * \param[in] cols The number of columns of the region
+ * \param[in] rows The number of rows of the region
+ *
+ * \return The image view
+ */
+image_t roiImage(const image_t *img, const int32_t x, const int32_t y,
+                 const int32_t cols, const int32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
-    {
-        // Unable to allocate memory for new image
-        return NULL;
-    }
+    // Verify image validity
+    ASSERT(img == NULL, "img image is invalid");
+    ASSERT(img->data == NULL, "img data is invalid");
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_FLOAT;
-    img->data = NULL;
+    // Verify region validity
+    ASSERT(x < 0, "x-value is out of range");
+    ASSERT(y < 0, "y-value is out of range");
+    ASSERT(cols <= 0, "cols must be larger than 0");
+    ASSERT(rows <= 0, "rows must be larger than 0");
+    ASSERT((x + cols) > img->cols, "region exceeds the number of columns");
+    ASSERT((y + rows) > img->rows, "region exceeds the number of rows");
 
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
+    int32_t stride = IMAGE_STRIDE(img);
+
+    image_t roi =
         {
-            imgs[i] = img;
-            return(img);
-        }
-    }
+            .cols=cols,
+            .rows=rows,
+            .type=img->type,
+            .data=img->data + (((y * stride) + x) * getPixelSize(img->type)),
+            .stride=stride,
+        };
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+    // A binary view must start at a word boundary
+    if(img->type == IMGTYPE_BIN1)
+    {
+        ASSERT((x % 64) != 0, "x-value of a binary image must be a multiple of 64");
 
-    return NULL;
+        roi.data = img->data + (((y * stride) + x) / 8);
+    }
+
+    return roi;
 }
 
-image_t *newEmptyUyvyImage(const uint32_t cols, const uint32_t rows)
+/// \}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/// \name Functions for border handling
+/// \{
+
+/*!
+ * \brief Maps a coordinate outside the image to a coordinate inside the image
+ *
+ * \param[in] i      The coordinate, which may be outside the range 0 to
+ *                   \p size - 1
+ * \param[in] size   The number of columns or rows of the image
+ * \param[in] border The border mode. Must be of type ::eBorder.
+ *
+ * \return The coordinate inside the image. -1 if \p border is
+ *         ::BORDER_CONSTANT and \p i is outside the image.
+ */
+int32_t getBorderCoordinate(int32_t i, const int32_t size, const eBorder border)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
+    if((i >= 0) && (i < size))
     {
-        // Unable to allocate memory for new image
-        return NULL;
+        return i;
     }
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UYVY;
-    img->data = NULL;
-
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    switch(border)
     {
-        if(imgs[i] == NULL)
+    case BORDER_REPLICATE:
+        return (i < 0) ? 0 : (size - 1);
+
+    case BORDER_REFLECT:
+        // Keep reflecting, in case the border is wider than the image
+        while((i < 0) || (i >= size))
         {
-            imgs[i] = img;
-            return(img);
+            i = (i < 0) ? (-i - 1) : ((2 * size) - i - 1);
         }
-    }
+        return i;
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+    case BORDER_WRAP:
+        i %= size;
+        return (i < 0) ? (i + size) : i;
 
-    return NULL;
+    case BORDER_CONSTANT:
+    default:
+        return -1;
+    }
 }
 
-image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Returns the next column to process in a loop that only visits the
+ *        border pixels of an image
+ *
+ * Operators with an \p r x \p r window split the image in an interior, where
+ * the window is always within the image, and a border. The interior is
+ * processed without bounds checks. The border is processed by a loop like:
+ *
+ *     for(int32_t y=0; y<img->rows; y++)
+ *         for(int32_t x=nextBorderColumn(img,-1,y,r); x<img->cols; x=nextBorderColumn(img,x,y,r))
+ *
+ * \param[in] img A pointer to the image
+ * \param[in] x   The current column, -1 to get the first column of a row
+ * \param[in] y   The current row
+ * \param[in] r   The radius of the window, so the window size is 2r+1
+ *
+ * \return The next column. Equal to the number of columns at the end of the row.
+ */
+int32_t nextBorderColumn(const image_t *img, const int32_t x, const int32_t y, const int32_t r)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if(img == NULL)
+    // Skip the interior of a row that is not in the top or bottom border
+    if(((x + 1) == r) && (y >= r) && (y < (img->rows - r)) && (img->cols > (2 * r)))
     {
-        // Unable to allocate memory for new image
-        return NULL;
+        return img->cols - r;
     }
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_BGR888;
-    img->data = NULL;
+    return x + 1;
+}
 
-    // Add image to the images array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == NULL)
+/*!
+ * \brief Copies an image into the centre of a larger image and fills the
+ *        surrounding border
+ *
+ * The border width is half the difference in size between \p dst and \p src.
+ * Operators run on the result without bounds checks. A view on the centre is
+ * obtained with roiImage().
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dst    A pointer to the destination image
+ * \param[in]  border The border mode. Must be of type ::eBorder.
+ * \param[in]  value  The value of the border pixels for ::BORDER_CONSTANT
+ */
+void copyWithBorder(const image_t *src, image_t *dst, const eBorder border, const int32_t value)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+
+    // Verify image consistency
+    ASSERT(src->type != dst->type, "src and dst have different types");
+    ASSERT(dst->cols < src->cols, "dst has less columns than src");
+    ASSERT(dst->rows < src->rows, "dst has less rows than src");
+    ASSERT(((dst->cols - src->cols) % 2) != 0, "border width is not equal at both sides");
+    ASSERT(((dst->rows - src->rows) % 2) != 0, "border height is not equal at both sides");
+
+    const int32_t bx = (dst->cols - src->cols) / 2;
+    const int32_t by = (dst->rows - src->rows) / 2;
+    const uint32_t size = getPixelSize(src->type);
+    ASSERT(size == 0, "src type is not supported");
+
+    // The value of a constant border pixel
+    union
+    {
+        uint8_pixel_t  u8;
+        int16_pixel_t  i16;
+        int32_pixel_t  i32;
+        float_pixel_t  f;
+        uyvy_pixel_t   uyvy;
+        bgr888_pixel_t bgr;
+        int64_pixel_t  i64;
+        complex_pixel_t c;
+    }pixel;
+
+    memset(&pixel, 0, sizeof(pixel));
+
+    switch(src->type)
+    {
+    case IMGTYPE_UINT8:  pixel.u8   = (uint8_pixel_t)value; break;
+    case IMGTYPE_INT16:  pixel.i16  = (int16_pixel_t)value; break;
+    case IMGTYPE_INT32:  pixel.i32  = (int32_pixel_t)value; break;
+    case IMGTYPE_FLOAT:  pixel.f    = (float_pixel_t)value; break;
+    case IMGTYPE_UYVY:   pixel.uyvy = (uyvy_pixel_t)value;  break;
+    case IMGTYPE_BGR888:
+        pixel.bgr.b = (uint8_t)value;
+        pixel.bgr.g = (uint8_t)value;
+        pixel.bgr.r = (uint8_t)value;
+        break;
+    case IMGTYPE_INT64:  pixel.i64  = (int64_pixel_t)value; break;
+    case IMGTYPE_COMPLEX: pixel.c.real = (float)value; break;
+    case IMGTYPE_BIN1:   break;
+    }
+
+    // Copy the image into the centre
+    image_t centre = roiImage(dst, bx, by, src->cols, src->rows);
+    copyRows(src, &centre, size);
+
+    // Fill the border
+    for(int32_t y=0; y<dst->rows; y++)
+    {
+        int32_t sy = getBorderCoordinate(y - by, src->rows, border);
+        uint8_t *d = dst->data + (y * IMAGE_STRIDE(dst) * size);
+        const uint8_t *s = (sy < 0) ? NULL : (src->data + (sy * IMAGE_STRIDE(src) * size));
+        int32_t centreRow = (y >= by) && (y < (by + src->rows));
+
+        for(int32_t x=0; x<dst->cols; x++)
         {
-            imgs[i] = img;
-            return(img);
-        }
-    }
+            // Skip the pixels that were copied already
+            if(centreRow && (x == bx))
+            {
+                x += src->cols - 1;
+                continue;
+            }
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+            int32_t sx = getBorderCoordinate(x - bx, src->cols, border);
 
-    return NULL;
+            if((s == NULL) || (sx < 0))
+            {
+                memcpy(d + (x * size), &pixel, size);
+            }
+            else
+            {
+                memcpy(d + (x * size), s + (sx * size), size);
+            }
+        }
+    }
 }
 
 /// \}
@@ -624,106 +826,149 @@ image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows)
 /// \name Functions for deleting images
 /// \{
 
-void deleteUint8Image(image_t *img)
+/*!
+ * \brief Functions for deleting images
+ *
+ * The image is returned to the pool in constant time, so creating and
+ * deleting temporary images in every frame does not fragment the heap. The
+ * memory is reused by the next image of a similar size. Images without data
+ * allocation free their data pointer, so it must be set to NULL first if the
+ * data is owned by someone else.
+ *
+ * \param[in] img A pointer to the image that was created by one of the
+ *                new<type>Image() or newEmpty<type>Image() functions
+ */
+void deleteImage(image_t *img)
 {
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    if(img == NULL)
     {
-        if(imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
+        return;
     }
 
-    free(img->data);
-    free(img);
-}
+    poolBlock_t *block = POOL_BLOCK(img);
 
-void deleteInt16Image(image_t *img)
-{
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    if(!block->hasData)
     {
-        if(imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
+        free(img->data);
     }
 
-    free(img->data);
-    free(img);
-}
+    // Remove image from the list of live images
+    if(block->prev != NULL)
+    {
+        block->prev->next = block->next;
+    }
+    else
+    {
+        poolLive = block->next;
+    }
 
-void deleteInt32Image(image_t *img)
-{
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    if(block->next != NULL)
     {
-        if(imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
+        block->next->prev = block->prev;
     }
 
-    free(img->data);
-    free(img);
+    // Add block to the free list of its size class
+    block->prev = NULL;
+    block->next = poolFree[block->sizeClass];
+    poolFree[block->sizeClass] = block;
 }
 
-void deleteFloatImage(image_t *img)
+void deleteUint8Image(image_t *img)
 {
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if(imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
+    deleteImage(img);
+}
 
-    free(img->data);
-    free(img);
+void deleteInt16Image(image_t *img)
+{
+    deleteImage(img);
+}
+
+void deleteInt32Image(image_t *img)
+{
+    deleteImage(img);
+}
+
+void deleteFloatImage(image_t *img)
+{
+    deleteImage(img);
 }
 
 void deleteUyvyImage(image_t *img)
 {
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    deleteImage(img);
+}
+
+void deleteBgr888Image(image_t *img)
+{
+    deleteImage(img);
+}
+
+void deleteAllImages(void)
+{
+    // Release all live images
+    while(poolLive != NULL)
     {
-        if(imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
+        deleteImage(&poolLive->img);
     }
 
-    free(img->data);
-    free(img);
+    // Return all memory to the heap
+    imagePoolTrim();
 }
 
-void deleteBgr888Image(image_t *img)
+/// \}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/// \name Functions for managing the image pool
+/// \{
+
+/*!
+ * \brief Marks the current state of the image pool
+ *
+ * All images that are created after this call can be deleted at once by
+ * passing the returned mark to imagePoolRelease(). This is typically used at
+ * the start of a frame in a streaming loop.
+ *
+ * \return The mark
+ */
+uint32_t imagePoolMark(void)
+{
+    return poolSequence;
+}
+
+/*!
+ * \brief Deletes all images that were created after \p mark
+ *
+ * Images that were created before the mark was taken are not affected. The
+ * released memory stays in the pool, so the images of the next frame are
+ * created without calling malloc().
+ *
+ * \param[in] mark The mark returned by imagePoolMark()
+ */
+void imagePoolRelease(const uint32_t mark)
 {
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    // The list of live images is ordered from the newest to the oldest image
+    while((poolLive != NULL) && (poolLive->sequence >= mark))
     {
-        if(imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
+        deleteImage(&poolLive->img);
     }
-
-    free(img->data);
-    free(img);
 }
 
-void deleteAllImages(void)
+/*!
+ * \brief Returns the memory of all released images to the heap
+ *
+ * Live images are not affected.
+ */
+void imagePoolTrim(void)
 {
-    // Remove image from the array
-    for(uint32_t i = 0; i < MAX_IMAGES; i++)
+    for(uint32_t i = 0; i < POOL_SIZE_CLASSES; i++)
     {
-        if(imgs[i] != NULL)
+        while(poolFree[i] != NULL)
         {
-            free(imgs[i]->data);
-            free(imgs[i]);
-            imgs[i] = NULL;
+            poolBlock_t *block = poolFree[i];
+            poolFree[i] = block->next;
+            free(block->memory);
         }
     }
 }
@@ -763,7 +1008,7 @@ void copyUint8Image(const image_t *src, image_t *dst)
     ASSERT(src == dst, "src and dst are the same images");
 
     // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(uint8_pixel_t));
+    copyRows(src, dst, sizeof(uint8_pixel_t));
 }
 
 void copyInt16Image(const image_t *src, image_t *dst)
@@ -782,7 +1027,7 @@ void copyInt16Image(const image_t *src, image_t *dst)
     ASSERT(src == dst, "src and dst are the same images");
 
     // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(int16_pixel_t));
+    copyRows(src, dst, sizeof(int16_pixel_t));
 }
 
 void copyInt32Image(const image_t *src, image_t *dst)
@@ -801,7 +1046,7 @@ void copyInt32Image(const image_t *src, image_t *dst)
     ASSERT(src == dst, "src and dst are the same images");
 
     // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(int32_pixel_t));
+    copyRows(src, dst, sizeof(int32_pixel_t));
 }
 
 void copyFloatImage(const image_t *src, image_t *dst)
@@ -820,7 +1065,7 @@ void copyFloatImage(const image_t *src, image_t *dst)
     ASSERT(src == dst, "src and dst are the same images");
 
     // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(float_pixel_t));
+    copyRows(src, dst, sizeof(float_pixel_t));
 }
 
 void copyUyvyImage(const image_t *src, image_t *dst)
@@ -839,7 +1084,7 @@ void copyUyvyImage(const image_t *src, image_t *dst)
     ASSERT(src == dst, "src and dst are the same images");
 
     // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(uyvy_pixel_t));
+    copyRows(src, dst, sizeof(uyvy_pixel_t));
 }
 
 void copyBgr888Image(const image_t *src, image_t *dst)
@@ -858,7 +1103,7 @@ void copyBgr888Image(const image_t *src, image_t *dst)
     ASSERT(src == dst, "src and dst are the same images");
 
     // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(bgr888_pixel_t));
+    copyRows(src, dst, sizeof(bgr888_pixel_t));
 }
 
 /// \}
@@ -884,13 +1129,17 @@ void clearUint8Image(image_t *img)
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register uint8_pixel_t *d = (uint8_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<img->rows; y++)
     {
-        *d++ = (uint8_pixel_t)0;
+        register long int i = img->cols;
+        register uint8_pixel_t *d = (uint8_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while(i-- > 0)
+        {
+            *d++ = (uint8_pixel_t)0;
+        }
     }
 }
 
@@ -901,13 +1150,17 @@ void clearInt16Image(image_t *img)
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_INT16, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register int16_pixel_t *d = (int16_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<img->rows; y++)
     {
-        *d++ = (int16_pixel_t)0;
+        register long int i = img->cols;
+        register int16_pixel_t *d = (int16_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while(i-- > 0)
+        {
+            *d++ = (int16_pixel_t)0;
+        }
     }
 }
 
@@ -918,13 +1171,17 @@ void clearInt32Image(image_t *img)
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_INT32, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register int32_pixel_t *d = (int32_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<img->rows; y++)
     {
-        *d++ = (int32_pixel_t)0;
+        register long int i = img->cols;
+        register int32_pixel_t *d = (int32_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while(i-- > 0)
+        {
+            *d++ = (int32_pixel_t)0;
+        }
     }
 }
 
@@ -935,13 +1192,17 @@ void clearFloatImage(image_t *img)
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_FLOAT, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register float_pixel_t *d = (float_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<img->rows; y++)
     {
-        *d++ = (float_pixel_t)0.0f;
+        register long int i = img->cols;
+        register float_pixel_t *d = (float_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while(i-- > 0)
+        {
+            *d++ = (float_pixel_t)0.0f;
+        }
     }
 }
 
@@ -961,18 +1222,22 @@ void clearFloatImage(image_t *img)
 void convertUyvyToUint8(image_t *src, image_t *dst)
 {
     // ********************************************
-    uint32_t i = src->rows * src->cols;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)dst->data;
-
-    // Loop all pixels and convert
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
     {
-        *uint8_pixel = (uint8_pixel_t)((*uyvy_pixel) >> 8);
+        uint32_t i = src->cols;
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels and convert
+        while(i-- > 0)
+        {
+            *uint8_pixel = (uint8_pixel_t)((*uyvy_pixel) >> 8);
 
-        // Next pixel
-        uyvy_pixel++;
-        uint8_pixel++;
+            // Next pixel
+            uyvy_pixel++;
+            uint8_pixel++;
+        }
     }
 
 
@@ -997,19 +1262,23 @@ void convertUyvyToUint8(image_t *src, image_t *dst)
  */
 void convertUint8ToUyvy(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)dst->data;
-
-    // Loop all pixels and convert
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
     {
-        *uyvy_pixel = ((uyvy_pixel_t)(*uint8_pixel)) << 8;
-        *uyvy_pixel |= 0x0080;
+        uint32_t i = src->cols;
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels and convert
+        while(i-- > 0)
+        {
+            *uyvy_pixel = ((uyvy_pixel_t)(*uint8_pixel)) << 8;
+            *uyvy_pixel |= 0x0080;
 
-        // Next pixel
-        uyvy_pixel++;
-        uint8_pixel++;
+            // Next pixel
+            uyvy_pixel++;
+            uint8_pixel++;
+        }
     }
 }
 
@@ -1024,18 +1293,22 @@ void convertUint8ToUyvy(image_t *src, image_t *dst)
  */
 void convertUyvyToInt16(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data;
-    int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data;
-
-    // Loop all pixels and convert
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
     {
-        *int16_pixel = (int16_pixel_t)((*uyvy_pixel) >> 8);
+        uint32_t i = src->cols;
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels and convert
+        while(i-- > 0)
+        {
+            *int16_pixel = (int16_pixel_t)((*uyvy_pixel) >> 8);
 
-        // Next pixel
-        uyvy_pixel++;
-        int16_pixel++;
+            // Next pixel
+            uyvy_pixel++;
+            int16_pixel++;
+        }
     }
 }
 
@@ -1056,108 +1329,112 @@ void convertUyvyToInt16(image_t *src, image_t *dst)
  */
 void convertUyvyToBgr888(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data;
-
-    while(i > 0)
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
     {
-        // Decrement by 2, because the chroma values are stored in two pixels
-        i -= 2;
-
-        uyvy_pixel_t uy = *uyvy_pixel++;
-        uyvy_pixel_t vy = *uyvy_pixel++;
-
-        int32_t u = (uy & 0xFFU) - 128;
-        int32_t y1 = uy >> 8;
-        int32_t v = (vy & 0xFFU) - 128;
-        int32_t y2 = vy >> 8;
-
-        bgr888_pixel->r = clip(y1 + (1.140f * v));
-        bgr888_pixel->g = clip(y1 - (0.394f * v) - (0.581f * u));
-        bgr888_pixel->b = clip(y1 + (2.032f * u));
-        bgr888_pixel++;
-
-        bgr888_pixel->r = clip(y2 + (1.140f * v));
-        bgr888_pixel->g = clip(y2 - (0.394f * v) - (0.581f * u));
-        bgr888_pixel->b = clip(y2 + (2.032f * u));
-        bgr888_pixel++;
-
-        // Test with alternative coefficients
-
-#if 0
-
-        bgr888_pixel->r = clip(y1 + (1.370705f * (v)));
-        bgr888_pixel->g = clip(y1 - (0.698001f * (v)) - (0.337633f * (u)));
-        bgr888_pixel->b = clip(y1 + (1.732446f * (u)));
-        bgr888_pixel++;
-
-        bgr888_pixel->r = clip(y2 + (1.370705f * (v)));
-        bgr888_pixel->g = clip(y2 - (0.698001f * (v)) - (0.337633f * (u)));
-        bgr888_pixel->b = clip(y2 + (1.732446f * (u)));
-        bgr888_pixel++;
-
-#endif
-
-        // Several alternative calculation methods
-        // \see https://learn.microsoft.com/en-us/windows/win32/medfound/recommended-8-bit-yuv-formats-for-video-rendering
-
-#if 0
-        int32_t C = y1;
-        int32_t D = u - 128;
-        int32_t E = u - 128;
-
-        // Calculations using doubles
-        bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
-        bgr888_pixel++;
-
-        C = y2;
-
-        bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
-        bgr888_pixel++;
-#endif
-
-#if 0
-        int32_t C = y1;
-        int32_t D = u - 128;
-        int32_t E = u - 128;
-
-        // Calculations using floats
-        bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
-        bgr888_pixel++;
-
-        C = y2;
+        uint32_t i = src->cols;
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
 
-        bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
-        bgr888_pixel++;
-#endif
-
-#if 0
-        int32_t C = y1;
-        int32_t D = u - 128;
-        int32_t E = u - 128;
-
-        // Calculations using integers
-        bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
-        bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
-        bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
-        bgr888_pixel++;
-
-        C = y2;
-
-        bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
-        bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
-        bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
-        bgr888_pixel++;
-#endif
+        while(i > 1)
+        {
+            // Decrement by 2, because the chroma values are stored in two pixels
+            i -= 2;
+
+            uyvy_pixel_t uy = *uyvy_pixel++;
+            uyvy_pixel_t vy = *uyvy_pixel++;
+
+            int32_t u = (uy & 0xFFU) - 128;
+            int32_t y1 = uy >> 8;
+            int32_t v = (vy & 0xFFU) - 128;
+            int32_t y2 = vy >> 8;
+
+            bgr888_pixel->r = clip(y1 + (1.140f * v));
+            bgr888_pixel->g = clip(y1 - (0.394f * v) - (0.581f * u));
+            bgr888_pixel->b = clip(y1 + (2.032f * u));
+            bgr888_pixel++;
+
+            bgr888_pixel->r = clip(y2 + (1.140f * v));
+            bgr888_pixel->g = clip(y2 - (0.394f * v) - (0.581f * u));
+            bgr888_pixel->b = clip(y2 + (2.032f * u));
+            bgr888_pixel++;
+
+            // Test with alternative coefficients
+
+    #if 0
+
+            bgr888_pixel->r = clip(y1 + (1.370705f * (v)));
+            bgr888_pixel->g = clip(y1 - (0.698001f * (v)) - (0.337633f * (u)));
+            bgr888_pixel->b = clip(y1 + (1.732446f * (u)));
+            bgr888_pixel++;
+
+            bgr888_pixel->r = clip(y2 + (1.370705f * (v)));
+            bgr888_pixel->g = clip(y2 - (0.698001f * (v)) - (0.337633f * (u)));
+            bgr888_pixel->b = clip(y2 + (1.732446f * (u)));
+            bgr888_pixel++;
+
+    #endif
+
+            // Several alternative calculation methods
+            // \see https://learn.microsoft.com/en-us/windows/win32/medfound/recommended-8-bit-yuv-formats-for-video-rendering
+
+    #if 0
+            int32_t C = y1;
+            int32_t D = u - 128;
+            int32_t E = u - 128;
+
+            // Calculations using doubles
+            bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
+            bgr888_pixel++;
+
+            C = y2;
+
+            bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
+            bgr888_pixel++;
+    #endif
+
+    #if 0
+            int32_t C = y1;
+            int32_t D = u - 128;
+            int32_t E = u - 128;
+
+            // Calculations using floats
+            bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
+            bgr888_pixel++;
+
+            C = y2;
+
+            bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
+            bgr888_pixel++;
+    #endif
+
+    #if 0
+            int32_t C = y1;
+            int32_t D = u - 128;
+            int32_t E = u - 128;
+
+            // Calculations using integers
+            bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
+            bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
+            bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
+            bgr888_pixel++;
+
+            C = y2;
+
+            bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
+            bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
+            bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
+            bgr888_pixel++;
+    #endif
+        }
     }
 }
 
@@ -1172,20 +1449,24 @@ void convertUyvyToBgr888(image_t *src, image_t *dst)
  */
 void convertUint8ToBgr888(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data;
-
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
     {
-        uint8_t val = *uint8_pixel;
+        uint32_t i = src->cols;
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while(i-- > 0)
+        {
+            uint8_t val = *uint8_pixel;
 
-        bgr888_pixel->r = val;
-        bgr888_pixel->g = val;
-        bgr888_pixel->b = val;
+            bgr888_pixel->r = val;
+            bgr888_pixel->g = val;
+            bgr888_pixel->b = val;
 
-        bgr888_pixel++;
-        uint8_pixel++;
+            bgr888_pixel++;
+            uint8_pixel++;
+        }
     }
 }
 
@@ -1200,18 +1481,22 @@ void convertUint8ToBgr888(image_t *src, image_t *dst)
  */
 void convertBgr888ToUint8(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)dst->data;
-
-    while(i-- > 0)
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
     {
-        *uint8_pixel = (bgr888_pixel->r * 0.299f) +
-                       (bgr888_pixel->g * 0.587f) +
-                       (bgr888_pixel->b * 0.114f);
+        uint32_t i = src->cols;
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while(i-- > 0)
+        {
+            *uint8_pixel = (bgr888_pixel->r * 0.299f) +
+                           (bgr888_pixel->g * 0.587f) +
+                           (bgr888_pixel->b * 0.114f);
 
-        bgr888_pixel++;
-        uint8_pixel++;
+            bgr888_pixel++;
+            uint8_pixel++;
+        }
     }
 }
 
@@ -1226,18 +1511,132 @@ void convertBgr888ToUint8(image_t *src, image_t *dst)
  */
 void convertBgr888ToInt16(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data;
-    int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data;
+    // Loop all rows
+    for(int32_t y=0; y<src->rows; y++)
+    {
+        uint32_t i = src->cols;
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while(i-- > 0)
+        {
+            *int16_pixel = (bgr888_pixel->r * 0.299f) +
+                           (bgr888_pixel->g * 0.587f) +
+                           (bgr888_pixel->b * 0.114f);
+
+            bgr888_pixel++;
+            int16_pixel++;
+        }
+    }
+}
+
+/*!
+ * \brief Converts a uint8_pixel_t image to a bit-packed binary image
+ *
+ * Pixels that are not 0 become 1. Eight pixels are converted at once: a
+ * 64-bit little-endian word of pixels is reduced to one bit per byte, and a
+ * multiplication gathers these bits into a single byte.
+ *
+ * \param[in]  src A pointer to the uint8_pixel_t image
+ * \param[out] dst A pointer to the IMGTYPE_BIN1 image
+ */
+void convertUint8ToBin1(const image_t *src, image_t *dst)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_BIN1, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const int32_t cols = src->cols;
+
+    for(int32_t y=0; y<src->rows; y++)
+    {
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        bin1_word_t *d = (bin1_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / 64));
+
+        for(int32_t x=0; x<cols; x+=64)
+        {
+            bin1_word_t w = 0;
+            int32_t n = ((cols - x) < 64) ? (cols - x) : 64;
+            int32_t i = 0;
+
+            for(; i<=(n - 8); i+=8)
+            {
+                uint64_t v;
+                memcpy(&v, s + x + i, sizeof(v));
+
+                // Set bit 7 of every byte that is not 0, move it to bit 0 and
+                // gather bit 0 of byte k into bit k
+                v = ((((v & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | v) >> 7) &
+                    0x0101010101010101ULL;
+
+                w |= ((v * 0x0102040810204080ULL) >> 56) << i;
+            }
+
+            for(; i<n; i++)
+            {
+                w |= (bin1_word_t)(s[x + i] != 0) << i;
+            }
+
+            d[x / 64] = w;
+        }
+    }
+}
+
+/*!
+ * \brief Converts a bit-packed binary image to a uint8_pixel_t image
+ *
+ * Every pixel becomes 0 or 1. Eight pixels are converted at once: a
+ * multiplication copies a byte of bits into all bytes of a 64-bit word, after
+ * which bit k is isolated in byte k.
+ *
+ * \param[in]  src A pointer to the IMGTYPE_BIN1 image
+ * \param[out] dst A pointer to the uint8_pixel_t image
+ */
+void convertBin1ToUint8(const image_t *src, image_t *dst)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_BIN1, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const int32_t cols = src->cols;
 
-    while(i-- > 0)
+    for(int32_t y=0; y<src->rows; y++)
     {
-        *int16_pixel = (bgr888_pixel->r * 0.299f) +
-                       (bgr888_pixel->g * 0.587f) +
-                       (bgr888_pixel->b * 0.114f);
+        const bin1_word_t *s = (bin1_word_t *)src->data + (y * (IMAGE_STRIDE(src) / 64));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+        int32_t x = 0;
 
-        bgr888_pixel++;
-        int16_pixel++;
+        for(; x<=(cols - 8); x+=8)
+        {
+            uint64_t bits = (s[x / 64] >> (x % 64)) & 0xFF;
+
+            // Byte k keeps bit k, adding 0x7F carries it into bit 7
+            uint64_t v = (bits * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+            v = ((v + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+
+            memcpy(d + x, &v, sizeof(v));
+        }
+
+        for(; x<cols; x++)
+        {
+            d[x] = (s[x / 64] >> (x % 64)) & 1;
+        }
     }
 }
 
@@ -1271,6 +1670,10 @@ void convertToUint8(image_t *src, image_t *dst)
     {
         convertBgr888ToUint8(src, dst);
     }
+    else if(src->type == IMGTYPE_BIN1)
+    {
+        convertBin1ToUint8(src, dst);
+    }
     else
     {
         // Conversion not implemented
@@ -1333,21 +1736,328 @@ void convertToBgr888(image_t *src, image_t *dst)
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
-    ASSERT(src == dst, "src and dst are the same images");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    if(src->type == IMGTYPE_UINT8)
+    {
+        convertUint8ToBgr888(src, dst);
+    }
+    else if(src->type == IMGTYPE_UYVY)
+    {
+        convertUyvyToBgr888(src, dst);
+    }
+    else
+    {
+        // Conversion not implemented
+        while(1)
+        {}
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/// \name Functions for integral images
+/// \{
+
+/*!
+ * \brief Computes rows of an integral image
+ *
+ * Row j+1 of the integral image is the running sum of source row j plus row j
+ * of the integral image. The running sum is a serial dependency, but adding
+ * the row above has independent iterations that the compiler can vectorise.
+ *
+ * 32-bit integral images are computed with unsigned arithmetic, so values wrap
+ * around modulo 2^32 instead of overflowing.
+ *
+ * \param[in]  src     A pointer to the source image
+ * \param[out] dst     A pointer to the integral image
+ * \param[in]  y       The first source row
+ * \param[in]  rows    The number of source rows
+ * \param[in]  squared 1 to sum the squared pixel values, 0 otherwise
+ */
+static void integralRows(const image_t *src, image_t *dst, const int32_t y,
+                         const int32_t rows, const uint8_t squared)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT((dst->type != IMGTYPE_INT32) && (dst->type != IMGTYPE_INT64), "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT((src->cols + 1) != dst->cols, "dst must have one column more than src");
+    ASSERT((src->rows + 1) != dst->rows, "dst must have one row more than src");
+
+    // Verify parameters
+    ASSERT((y < 0) || (rows < 0) || ((y + rows) > src->rows), "rows are outside the image");
+
+    const int32_t cols = src->cols;
+    const int32_t srcStride = IMAGE_STRIDE(src);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    if(dst->type == IMGTYPE_INT32)
+    {
+        uint32_t *d = (uint32_t *)dst->data;
+
+        if(y == 0)
+        {
+            memset(d, 0, (cols + 1) * sizeof(uint32_t));
+        }
+
+        for(int32_t j=y; j<(y + rows); j++)
+        {
+            const uint8_pixel_t *s = src->data + (j * srcStride);
+            const uint32_t *above = d + (j * dstStride);
+            uint32_t *row = d + ((j + 1) * dstStride);
+            uint32_t sum = 0;
+
+            row[0] = 0;
+
+            // Running sum of the source row
+            for(int32_t x=0; x<cols; x++)
+            {
+                uint32_t val = s[x];
+                sum += squared ? (val * val) : val;
+                row[x + 1] = sum;
+            }
+
+            // Add the row above
+            for(int32_t x=1; x<=cols; x++)
+            {
+                row[x] += above[x];
+            }
+        }
+    }
+    else
+    {
+        int64_pixel_t *d = (int64_pixel_t *)dst->data;
+
+        if(y == 0)
+        {
+            memset(d, 0, (cols + 1) * sizeof(int64_pixel_t));
+        }
+
+        for(int32_t j=y; j<(y + rows); j++)
+        {
+            const uint8_pixel_t *s = src->data + (j * srcStride);
+            const int64_pixel_t *above = d + (j * dstStride);
+            int64_pixel_t *row = d + ((j + 1) * dstStride);
+            int64_pixel_t sum = 0;
+
+            row[0] = 0;
+
+            // Running sum of the source row
+            for(int32_t x=0; x<cols; x++)
+            {
+                int64_pixel_t val = s[x];
+                sum += squared ? (val * val) : val;
+                row[x + 1] = sum;
+            }
+
+            // Add the row above
+            for(int32_t x=1; x<=cols; x++)
+            {
+                row[x] += above[x];
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Computes the integral image (summed-area table) of an image
+ *
+ * Pixel (x,y) of the integral image holds the sum of all source pixels above
+ * and to the left of source pixel (x,y), so the integral image has one column
+ * and one row more than the source image and the first row and column are 0.
+ * The sum of any rectangle is found with integralRectSum() in constant time.
+ *
+ * An integral image of type IMGTYPE_INT32 holds the sums modulo 2^32.
+ * Rectangle sums remain exact as long as the rectangle sum itself fits in 32
+ * bits, which holds for any uint8 image up to 16843009 pixels. Use an
+ * integral image of type IMGTYPE_INT64 if the integral values themselves are
+ * needed for large images.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the integral image of type IMGTYPE_INT32 or
+ *                 IMGTYPE_INT64 with size (src->cols+1) x (src->rows+1)
+ */
+void integralImage(const image_t *src, image_t *dst)
+{
+    ASSERT(src == NULL, "src image is invalid");
+
+    integralRows(src, dst, 0, src->rows, 0);
+}
+
+/*!
+ * \brief Computes the integral image of the squared pixel values of an image
+ *
+ * See integralImage(). Together with the integral image, the variance of any
+ * rectangle can be computed in constant time. A 32-bit rectangle sum of
+ * squares is exact for rectangles up to 66051 pixels.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the integral image of type IMGTYPE_INT32 or
+ *                 IMGTYPE_INT64 with size (src->cols+1) x (src->rows+1)
+ */
+void integralSquaredImage(const image_t *src, image_t *dst)
+{
+    ASSERT(src == NULL, "src image is invalid");
+
+    integralRows(src, dst, 0, src->rows, 1);
+}
+
+/*!
+ * \brief Updates the integral image for source rows \p y to \p y+rows-1
+ *
+ * The integral image rows above source row \p y must already be valid. By
+ * calling this function for consecutive bands of rows as soon as they are
+ * available, for example while a frame is received from the camera, the
+ * integral image is complete as soon as the last band has arrived. If source
+ * rows changed between frames, calling this function with \p y set to the
+ * first changed row and \p rows set to the remaining rows updates the integral
+ * image without recomputing the unchanged rows.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] dst  A pointer to the integral image
+ * \param[in]  y    The first source row to process
+ * \param[in]  rows The number of source rows to process
+ */
+void integralImageUpdate(const image_t *src, image_t *dst, const int32_t y,
+                         const int32_t rows)
+{
+    integralRows(src, dst, y, rows, 0);
+}
+
+/*!
+ * \brief Updates the squared integral image for source rows \p y to
+ *        \p y+rows-1
+ *
+ * See integralImageUpdate().
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] dst  A pointer to the squared integral image
+ * \param[in]  y    The first source row to process
+ * \param[in]  rows The number of source rows to process
+ */
+void integralSquaredImageUpdate(const image_t *src, image_t *dst, const int32_t y,
+                                const int32_t rows)
+{
+    integralRows(src, dst, y, rows, 1);
+}
+
+/*!
+ * \brief Returns the sum of the source pixels in a rectangle
+ *
+ * Only four integral image values are read, so the time is independent of the
+ * size of the rectangle. No bounds checking is done, the rectangle must be
+ * within the source image.
+ *
+ * \param[in] integral A pointer to an integral image as computed by
+ *                     integralImage() or integralSquaredImage()
+ * \param[in] x        The leftmost source column of the rectangle
+ * \param[in] y        The top source row of the rectangle
+ * \param[in] cols     The number of columns of the rectangle
+ * \param[in] rows     The number of rows of the rectangle
+ *
+ * \return The sum of the pixels in the rectangle
+ */
+int64_t integralRectSum(const image_t *integral, const int32_t x, const int32_t y,
+                        const int32_t cols, const int32_t rows)
+{
+    const int32_t stride = IMAGE_STRIDE(integral);
+    const int32_t top = y * stride;
+    const int32_t bottom = (y + rows) * stride;
+
+    if(integral->type == IMGTYPE_INT32)
+    {
+        // Unsigned arithmetic cancels any wrap around of the integral values
+        const uint32_t *d = (uint32_t *)integral->data;
+
+        return (uint32_t)(d[bottom + x + cols] - d[bottom + x] -
+                          d[top + x + cols] + d[top + x]);
+    }
+
+    const int64_pixel_t *d = (int64_pixel_t *)integral->data;
+
+    return d[bottom + x + cols] - d[bottom + x] - d[top + x + cols] + d[top + x];
+}
+
+/// \}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Replaces every pixel by its entry in a lookup table
+ *
+ * s_i = \p lut[g_i]
+ * \n
+ * Eight pixels are loaded, looked up and stored as one 64-bit word, so the
+ * image is read and written once. A chain of point operations is applied in a
+ * single pass by first combining their lookup tables with lutCompose(). The
+ * source and destination image may be the same image.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  lut A pointer to an array of 256 uint8_pixel_t
+ */
+void applyLut(const image_t *src, image_t *dst, const uint8_pixel_t *lut)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    if(src->type == IMGTYPE_UINT8)
-    {
-        convertUint8ToBgr888(src, dst);
-    }
-    else if(src->type == IMGTYPE_UYVY)
-    {
-        convertUyvyToBgr888(src, dst);
-    }
-    else
+    // Verify lookup table validity
+    ASSERT(lut == NULL, "lut is invalid");
+
+    // Packed images are processed as a single row
+    const int32_t packed = IMAGE_IS_PACKED(src) && IMAGE_IS_PACKED(dst);
+    const int32_t cols = packed ? (src->cols * src->rows) : src->cols;
+    const int32_t rows = packed ? 1 : src->rows;
+
+    for(int32_t y=0; y<rows; ++y)
     {
-        // Conversion not implemented
-        while(1)
-        {}
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+        int32_t x = 0;
+
+        for(; x<=(cols - 8); x+=8)
+        {
+            uint64_t w;
+
+            memcpy(&w, s + x, sizeof(w));
+
+            // The lookups are independent, so they are not serialized by the
+            // shifts of a single accumulator
+            const uint32_t lo = (uint32_t)lut[w & 0xFF] |
+                                ((uint32_t)lut[(w >> 8) & 0xFF] << 8) |
+                                ((uint32_t)lut[(w >> 16) & 0xFF] << 16) |
+                                ((uint32_t)lut[(w >> 24) & 0xFF] << 24);
+            const uint32_t hi = (uint32_t)lut[(w >> 32) & 0xFF] |
+                                ((uint32_t)lut[(w >> 40) & 0xFF] << 8) |
+                                ((uint32_t)lut[(w >> 48) & 0xFF] << 16) |
+                                ((uint32_t)lut[w >> 56] << 24);
+
+            w = ((uint64_t)hi << 32) | lo;
+
+            memcpy(d + x, &w, sizeof(w));
+        }
+
+        for(; x<cols; ++x)
+        {
+            d[x] = lut[s[x]];
+        }
     }
 }
 
@@ -1355,6 +2065,8 @@ void convertToBgr888(image_t *src, image_t *dst)
  * \brief This function sets all pixels in the source image with value \p
  *        selected to \p value in the destination image
  *
+ * The pixels are mapped with a lookup table, see applyLut().
+ *
  * \param[in]  src      A pointer to the source image
  * \param[out] dst      A pointer to the destination image
  * \param[in]  selected Pixel value that will be updated
@@ -1375,31 +2087,21 @@ void setSelectedToValue(const image_t *src, image_t *dst,
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
-
     dst->rows = src->rows;
     dst->cols = src->cols;
     dst->type = src->type;
 
-    // Loop all pixels and set selected pixel to value
-    // Copy all others
-    while(i-- > 0)
-    {
-        if(*s == selected)
-        {
-            *d = value;
-        }
-        else
-        {
-            *d = *s;
-        }
+    // Set selected pixels to value, copy all others
+    uint8_pixel_t lut[256];
 
-        // Next pixel
-        s++;
-        d++;
+    for(uint32_t i=0; i<256; ++i)
+    {
+        lut[i] = (uint8_pixel_t)i;
     }
+
+    lut[selected] = value;
+
+    applyLut(src, dst, lut);
 }
 
 /*!
@@ -1428,7 +2130,8 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     ASSERT(y < 0, "y-value is out of range");
     ASSERT(y >= img->rows, "y-value is out of range");
 
-    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * img->cols + x));
+    register int32_t stride = IMAGE_STRIDE(img);
+    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * stride + x));
 
     unsigned int cnt = 0;
 
@@ -1436,45 +2139,45 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     if(x == 0 && y == 0)
     {
         if(*(s + sizeof(uint8_pixel_t)              ) == p){ cnt++; } // right
-        if(*(s + (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
+        if(*(s + (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
+            if(*(s + (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
         }
     }
     // Right-top pixel
     else if(x == img->cols-1 && y == 0)
     {
         if(*(s - sizeof(uint8_pixel_t)              ) == p){ cnt++; } // left
-        if(*(s + (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
+        if(*(s + (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
+            if(*(s + (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
         }
     }
     // Left-bottom pixel
     else if(x == 0 && y == img->rows-1)
     {
-        if(*(s - (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
+        if(*(s - (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
         if(*(s + sizeof(uint8_pixel_t)              ) == p){ cnt++; } // right
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
+            if(*(s - (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
         }
 
     }
     // Right-bottom pixel
     else if(x == img->cols-1 && y == img->rows-1)
     {
-        if(*(s - (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
+        if(*(s - (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
         if(*(s - sizeof(uint8_pixel_t)              ) == p){ cnt++; } // left
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
+            if(*(s - (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
         }
     }
     // Top border pixels
@@ -1482,67 +2185,67 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     {
         if(*(s - sizeof(uint8_pixel_t)              ) == p){ cnt++; } // left
         if(*(s + sizeof(uint8_pixel_t)              ) == p){ cnt++; } // right
-        if(*(s + (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
+        if(*(s + (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
+            if(*(s + (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
+            if(*(s + (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
         }
     }
     // Bottom border pixels
     else if(y == img->rows-1)
     {
-        if(*(s - (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
+        if(*(s - (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
         if(*(s - sizeof(uint8_pixel_t)              ) == p){ cnt++; } // left
         if(*(s + sizeof(uint8_pixel_t)              ) == p){ cnt++; } // right
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
+            if(*(s - (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
+            if(*(s - (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
         }
     }
     // Left border pixels
     else if(x == 0)
     {
-        if(*(s - (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
+        if(*(s - (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
         if(*(s + sizeof(uint8_pixel_t)              ) == p){ cnt++; } // right
-        if(*(s + (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
+        if(*(s + (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
+            if(*(s - (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
+            if(*(s + (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
         }
     }
     // Right border pixels
     else if(x == img->cols-1)
     {
-        if(*(s - (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
+        if(*(s - (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
         if(*(s - sizeof(uint8_pixel_t)              ) == p){ cnt++; } // left
-        if(*(s + (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
+        if(*(s + (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
+            if(*(s - (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
+            if(*(s + (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
         }
     }
     else
     {
         // Inner pixels
-        if(*(s - (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
+        if(*(s - (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // up
         if(*(s - sizeof(uint8_pixel_t)              ) == p){ cnt++; } // left
         if(*(s + sizeof(uint8_pixel_t)              ) == p){ cnt++; } // right
-        if(*(s + (img->cols * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
+        if(*(s + (stride * sizeof(uint8_pixel_t))) == p){ cnt++; } // down
 
         if(c == CONNECTED_EIGHT)
         {
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
-            if(*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
-            if(*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
+            if(*(s - (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // up-left
+            if(*(s - (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // up-right
+            if(*(s + (stride * sizeof(uint8_pixel_t)) - 1) == p){ cnt++; } // down-left
+            if(*(s + (stride * sizeof(uint8_pixel_t)) + 1) == p){ cnt++; } // down-right
         }
     }
 
@@ -1556,118 +2259,212 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
  * \brief Applies a filter mask to an image by convolving the filter mask with
  *        the original image
  *
+ * Pixels outside the image are 0, so only the pixels within the image
+ * contribute to the result.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  msk A pointer to the mask image
  */
 void convolve(const image_t *src, image_t *dst, const image_t *msk)
+{
+    convolveBorder(src, dst, msk, BORDER_CONSTANT);
+}
+
+/*!
+ * \brief Applies a filter mask to an image by convolving the filter mask with
+ *        the original image, using the border mode \p border
+ *
+ * Convolution equals correlation with a mask that is rotated 180 degrees.
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dst    A pointer to the destination image
+ * \param[in]  msk    A pointer to the mask image
+ * \param[in]  border The border mode. Must be of type ::eBorder. Constant
+ *                    border pixels are 0.
+ */
+void convolveBorder(const image_t *src, image_t *dst, const image_t *msk, const eBorder border)
+{
+    // Verify image validity
+    ASSERT(msk == NULL, "msk image is invalid");
+    ASSERT(msk->data == NULL, "msk data is invalid");
+
+    // Rotate the mask 180 degrees
+    image_t *rot = newPaddedImage(msk->type, msk->cols, msk->rows);
+    ASSERT(rot == NULL, "unable to allocate memory for the rotated mask");
+
+    const uint32_t size = getPixelSize(msk->type);
+
+    for(int32_t y=0; y<msk->rows; y++)
+    {
+        const uint8_t *s = msk->data + (y * IMAGE_STRIDE(msk) * size);
+        uint8_t *d = rot->data + ((msk->rows - 1 - y) * IMAGE_STRIDE(rot) * size);
+
+        for(int32_t x=0; x<msk->cols; x++)
+        {
+            memcpy(d + ((msk->cols - 1 - x) * size), s + (x * size), size);
+        }
+    }
+
+    correlateBorder(src, dst, rot, border);
+
+    deleteImage(rot);
+}
+
+/*!
+ * \brief Applies a separable filter mask to an image by convolving the image
+ *        with a row kernel and a column kernel
+ *
+ * The result equals convolve() with the mask that is the outer product of
+ * \p colKernel and \p rowKernel, but only takes 2n instead of n*n
+ * multiplications per pixel. The sum is normalised in fixed-point by
+ * shifting it \p shift bits to the right with rounding. The result is
+ * saturated to the range of the destination type.
+ *
+ * Both passes are implemented row by row. The inner loops run over a row of
+ * pixels with a constant kernel value, so the compiler is able to vectorize
+ * them.
+ *
+ * \param[in]  src       A pointer to the source image
+ * \param[out] dst       A pointer to the destination image
+ * \param[in]  rowKernel A pointer to the horizontal kernel of size \p n
+ * \param[in]  colKernel A pointer to the vertical kernel of size \p n
+ * \param[in]  n         The size of the kernels. Must be an odd value.
+ * \param[in]  shift     Number of bits the sum is shifted to the right
+ * \param[in]  border    The border mode. Must be of type ::eBorder. Constant
+ *                       border pixels are 0.
+ */
+void convolveSeparable(const image_t *src, image_t *dst, const int16_t *rowKernel,
+                       const int16_t *colKernel, const uint8_t n, const uint8_t shift,
+                       const eBorder border)
 {
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
-    ASSERT(msk == NULL, "msk image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(msk->data == NULL, "msk data is invalid");
-    ASSERT(msk->rows % 2 == 0, "mask rows must be odd");
-    ASSERT(msk->cols % 2 == 0, "mask cols must be odd");
+    ASSERT((src->type != IMGTYPE_INT16) && (src->type != IMGTYPE_UINT8), "src type is invalid");
+    ASSERT(src->type != dst->type, "dst type is invalid");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    if(src->type == IMGTYPE_INT16)
+    // Verify parameters
+    ASSERT(rowKernel == NULL, "row kernel is invalid");
+    ASSERT(colKernel == NULL, "column kernel is invalid");
+    ASSERT((n % 2) == 0, "kernel size is not an odd value");
+    ASSERT(shift > 30, "shift is too large");
+
+    const int32_t r = n / 2;
+    const int32_t cols = src->cols;
+    const int32_t rnd = (shift > 0) ? (1 << (shift - 1)) : 0;
+
+    // Copy the source image into an image with a border
+    image_t *pad = newPaddedImage(src->type, cols + (2 * r), src->rows + (2 * r));
+    image_t *tmp = newPaddedImage(IMGTYPE_INT32, cols, pad->rows);
+    image_t *acc = newPaddedImage(IMGTYPE_INT32, cols, 1);
+    ASSERT((pad == NULL) || (tmp == NULL) || (acc == NULL), "unable to allocate memory");
+
+    copyWithBorder(src, pad, border, 0);
+
+    const int32_t padStride = IMAGE_STRIDE(pad);
+    const int32_t tmpStride = IMAGE_STRIDE(tmp);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    // Horizontal pass over all rows of the image with border. Convolution
+    // mirrors the kernel, so kernel value n-1-i is applied to offset i.
+    for(int32_t y=0; y<pad->rows; y++)
     {
-        ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
-        ASSERT(msk->type != IMGTYPE_INT16, "msk type is invalid");
+        int32_t *t = (int32_t *)tmp->data + (y * tmpStride);
 
-        // Loop all pixels
-        for(int32_t y=0; y<src->rows; y++)
+        memset(t, 0, cols * sizeof(int32_t));
+
+        for(int32_t i=0; i<n; i++)
         {
-            for(int32_t x=0; x<src->cols; x++)
+            const int32_t k = rowKernel[n - 1 - i];
+
+            if(k == 0)
             {
-                int32_t val = 0;
-                int32_t dr = (msk->rows/2);
-                int32_t dc = (msk->cols/2);
+                continue;
+            }
 
-                // Apply the kernel only for pixels within the image
-                for(int32_t j=-dr; j<=dr; j++)
-                {
-                    for(int32_t i=-dc; i<=dc; i++)
-                    {
-                        if(((x-i) >= 0) &&
-                           ((y-j) >= 0) &&
-                           ((x-i) <  src->cols) &&
-                           ((y-j) <  src->rows))
-                        {
-                            val += getInt16Pixel(src,x-i,y-j) *
-                                   getInt16Pixel(msk,i+dc,j+dr);
-                        }
-                    }
-                }
+            if(src->type == IMGTYPE_UINT8)
+            {
+                const uint8_pixel_t *p = (uint8_pixel_t *)pad->data + (y * padStride) + i;
 
-                // Clip the result
-                if(val>INT16_PIXEL_MAX)
+                for(int32_t x=0; x<cols; x++)
                 {
-                    val=INT16_PIXEL_MAX;
+                    t[x] += k * p[x];
                 }
+            }
+            else
+            {
+                const int16_pixel_t *p = (int16_pixel_t *)pad->data + (y * padStride) + i;
 
-                if(val<INT16_PIXEL_MIN)
+                for(int32_t x=0; x<cols; x++)
                 {
-                    val=INT16_PIXEL_MIN;
+                    t[x] += k * p[x];
                 }
-
-                // Store the result
-                setInt16Pixel(dst, x, y, val);
             }
         }
     }
-    else if(src->type == IMGTYPE_UINT8)
+
+    // Vertical pass, also row by row
+    int32_t *a = (int32_t *)acc->data;
+
+    for(int32_t y=0; y<src->rows; y++)
     {
-        ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
-        ASSERT(msk->type != IMGTYPE_UINT8, "msk type is invalid");
+        for(int32_t x=0; x<cols; x++)
+        {
+            a[x] = rnd;
+        }
 
-        // Loop all pixels
-        for(int32_t y=0; y<src->rows; y++)
+        for(int32_t j=0; j<n; j++)
         {
-            for(int32_t x=0; x<src->cols; x++)
+            const int32_t k = colKernel[n - 1 - j];
+            const int32_t *t = (int32_t *)tmp->data + ((y + j) * tmpStride);
+
+            if(k == 0)
             {
-                int32_t val = 0;
-                int32_t dr = (msk->rows/2);
-                int32_t dc = (msk->cols/2);
+                continue;
+            }
 
-                // Apply the kernel only for pixels within the image
-                for(int32_t j=-dr; j<=dr; j++)
-                {
-                    for(int32_t i=-dc; i<=dc; i++)
-                    {
-                        if(((x-i) >= 0) &&
-                           ((y-j) >= 0) &&
-                           ((x-i) <  src->cols) &&
-                           ((y-j) <  src->rows))
-                        {
-                            val += getUint8Pixel(src,x-i,y-j) * getUint8Pixel(msk,i+dc,j+dr);
-                        }
-                    }
-                }
+            for(int32_t x=0; x<cols; x++)
+            {
+                a[x] += k * t[x];
+            }
+        }
 
-                // Clip the result
-                if(val>UINT8_PIXEL_MAX)
-                {
-                    val=UINT8_PIXEL_MAX;
-                }
+        // Normalise, saturate and store the result
+        if(dst->type == IMGTYPE_UINT8)
+        {
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * dstStride);
 
-                if(val<UINT8_PIXEL_MIN)
-                {
-                    val=UINT8_PIXEL_MIN;
-                }
+            for(int32_t x=0; x<cols; x++)
+            {
+                int32_t val = a[x] >> shift;
+                d[x] = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX :
+                       ((val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val);
+            }
+        }
+        else
+        {
+            int16_pixel_t *d = (int16_pixel_t *)dst->data + (y * dstStride);
 
-                // Store the result
-                setUint8Pixel(dst, x, y, val);
+            for(int32_t x=0; x<cols; x++)
+            {
+                int32_t val = a[x] >> shift;
+                d[x] = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX :
+                       ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
             }
         }
     }
+
+    deleteImage(acc);
+    deleteImage(tmp);
+    deleteImage(pad);
 }
 
 /*!
@@ -1692,6 +2489,8 @@ void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
 
     int32_t width = src->cols;
     int32_t height = src->rows;
+    int32_t srcStride = IMAGE_STRIDE(src);
+    int32_t dstStride = IMAGE_STRIDE(dst);
 
     // Loop through all pixels, ignoring border pixels
     for (int32_t x = 1; x < width - 1; x++)
@@ -1703,18 +2502,18 @@ void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
 
             // Images are stored in memory as a single 1D array.
             // Accessing the pixel at (x, y) is done by calculating the offset
-            // Formula: offset = y * width + x
+            // Formula: offset = y * stride + x
 
             // Calculate the offset for the current pixel
-            pixelValue +=   sourcePixel[(y + 1) * width + (x + 1)] * maskPixel[0] +
-                            sourcePixel[(y + 1) * width + (x    )] * maskPixel[1] +
-                            sourcePixel[(y + 1) * width + (x - 1)] * maskPixel[2] +
-                            sourcePixel[(y    ) * width + (x + 1)] * maskPixel[3] +
-                            sourcePixel[(y    ) * width + (x    )] * maskPixel[4] +
-                            sourcePixel[(y    ) * width + (x - 1)] * maskPixel[5] +
-                            sourcePixel[(y - 1) * width + (x + 1)] * maskPixel[6] +
-                            sourcePixel[(y - 1) * width + (x    )] * maskPixel[7] +
-                            sourcePixel[(y - 1) * width + (x - 1)] * maskPixel[8];
+            pixelValue +=   sourcePixel[(y + 1) * srcStride + (x + 1)] * maskPixel[0] +
+                            sourcePixel[(y + 1) * srcStride + (x    )] * maskPixel[1] +
+                            sourcePixel[(y + 1) * srcStride + (x - 1)] * maskPixel[2] +
+                            sourcePixel[(y    ) * srcStride + (x + 1)] * maskPixel[3] +
+                            sourcePixel[(y    ) * srcStride + (x    )] * maskPixel[4] +
+                            sourcePixel[(y    ) * srcStride + (x - 1)] * maskPixel[5] +
+                            sourcePixel[(y - 1) * srcStride + (x + 1)] * maskPixel[6] +
+                            sourcePixel[(y - 1) * srcStride + (x    )] * maskPixel[7] +
+                            sourcePixel[(y - 1) * srcStride + (x - 1)] * maskPixel[8];
 
             // Clip the result
             if (pixelValue > INT16_PIXEL_MAX)
@@ -1727,7 +2526,7 @@ void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
             }
 
             // Store the result
-            destinationPixel[y * width + x] = (int16_pixel_t)pixelValue;
+            destinationPixel[y * dstStride + x] = (int16_pixel_t)pixelValue;
         }
     }
 }
@@ -1739,11 +2538,37 @@ void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
  * is often referred to as the template. The correlation is then called
  * template matching.
  *
+ * Pixels outside the image are 0, so only the pixels within the image
+ * contribute to the result.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  msk A pointer to the mask image
  */
 void correlate(const image_t *src, image_t *dst, const image_t *msk)
+{
+    correlateBorder(src, dst, msk, BORDER_CONSTANT);
+}
+
+/*!
+ * \brief Compares two images mathematically, using the border mode \p border
+ *
+ * The source image is copied into an image with a border that is half the mask
+ * size wide. The window is then always within this image, so the pixels are
+ * processed without bounds checks.
+ *
+ * To correlate every frame with the same mask, create a template once with
+ * newCorrelationTemplate() and call correlateTemplate() instead. It keeps the
+ * border image and switches to correlation in the frequency domain for large
+ * masks.
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dst    A pointer to the destination image
+ * \param[in]  msk    A pointer to the mask image
+ * \param[in]  border The border mode. Must be of type ::eBorder. Constant
+ *                    border pixels are 0.
+ */
+void correlateBorder(const image_t *src, image_t *dst, const image_t *msk, const eBorder border)
 {
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
@@ -1759,34 +2584,75 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
+    ASSERT(src->type != dst->type, "dst type is invalid");
+    ASSERT(src->type != msk->type, "msk type is invalid");
+    ASSERT((src->type != IMGTYPE_INT16) && (src->type != IMGTYPE_UINT8), "src type is invalid");
 
-    if(src->type == IMGTYPE_INT16)
-    {
-        ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
-        ASSERT(msk->type != IMGTYPE_INT16, "msk type is invalid");
+    // Copy the source image into an image with a border
+    image_t *pad = newPaddedImage(src->type, src->cols + msk->cols - 1, src->rows + msk->rows - 1);
+    ASSERT(pad == NULL, "unable to allocate memory for the border");
+
+    copyWithBorder(src, pad, border, 0);
+
+    correlatePadded(pad, dst, msk);
+
+    deleteImage(pad);
+}
+
+/*!
+ * \brief Compares an image that already has a border with a mask
+ *
+ * Pixel (x,y) of \p dst is the sum of the products of the mask and the window
+ * of \p pad with its top-left pixel at (x,y). \p pad is usually filled by
+ * copyWithBorder() with a border that is half the mask size wide, which gives
+ * the same result as correlateBorder() without allocating the border image
+ * for every call.
+ *
+ * \param[in]  pad A pointer to the source image with a border
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  msk A pointer to the mask image
+ */
+void correlatePadded(const image_t *pad, image_t *dst, const image_t *msk)
+{
+    // Verify image validity
+    ASSERT(pad == NULL, "pad image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(msk == NULL, "msk image is invalid");
+    ASSERT(pad->data == NULL, "pad data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(msk->data == NULL, "msk data is invalid");
 
+    // Verify image consistency
+    ASSERT((pad->cols - msk->cols + 1) != dst->cols, "pad and dst have a different number of columns");
+    ASSERT((pad->rows - msk->rows + 1) != dst->rows, "pad and dst have a different number of rows");
+    ASSERT(pad->type != dst->type, "dst type is invalid");
+    ASSERT(pad->type != msk->type, "msk type is invalid");
+    ASSERT((pad->type != IMGTYPE_INT16) && (pad->type != IMGTYPE_UINT8), "pad type is invalid");
+
+    const int32_t padStride = IMAGE_STRIDE(pad);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+    const int32_t mskStride = IMAGE_STRIDE(msk);
+
+    if(pad->type == IMGTYPE_INT16)
+    {
         // Loop all pixels
-        for(int32_t y=0; y<src->rows; y++)
+        for(int32_t y=0; y<dst->rows; y++)
         {
-            for(int32_t x=0; x<src->cols; x++)
+            int16_pixel_t *d = (int16_pixel_t *)dst->data + (y * dstStride);
+
+            for(int32_t x=0; x<dst->cols; x++)
             {
                 int32_t val = 0;
-                int32_t dr = (msk->rows/2);
-                int32_t dc = (msk->cols/2);
 
-                // Apply the kernel only for pixels within the image
-                for(int32_t j=-dr; j<=dr; j++)
+                // The window is always within the image with border
+                for(int32_t j=0; j<msk->rows; j++)
                 {
-                    for(int32_t i=-dc; i<=dc; i++)
+                    const int16_pixel_t *p = (int16_pixel_t *)pad->data + ((y + j) * padStride) + x;
+                    const int16_pixel_t *m = (int16_pixel_t *)msk->data + (j * mskStride);
+
+                    for(int32_t i=0; i<msk->cols; i++)
                     {
-                        if(((x+i) >= 0) &&
-                           ((y+j) >= 0) &&
-                           ((x+i) <  src->cols) &&
-                           ((y+j) <  src->rows))
-                        {
-                            val += getInt16Pixel(src,x+i,y+j) *
-                                   getInt16Pixel(msk,i+dc,j+dr);
-                        }
+                        val += p[i] * m[i];
                     }
                 }
 
@@ -1802,36 +2668,30 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
                 }
 
                 // Store the result
-                setInt16Pixel(dst, x, y, val);
+                d[x] = (int16_pixel_t)val;
             }
         }
     }
-    else if(src->type == IMGTYPE_UINT8)
+    else
     {
-        ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
-        ASSERT(msk->type != IMGTYPE_UINT8, "msk type is invalid");
-
         // Loop all pixels
-        for(int32_t y=0; y<src->rows; y++)
+        for(int32_t y=0; y<dst->rows; y++)
         {
-            for(int32_t x=0; x<src->cols; x++)
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * dstStride);
+
+            for(int32_t x=0; x<dst->cols; x++)
             {
                 int32_t val = 0;
-                int32_t dr = (msk->rows/2);
-                int32_t dc = (msk->cols/2);
 
-                // Apply the kernel only for pixels within the image
-                for(int32_t j=-dr; j<=dr; j++)
+                // The window is always within the image with border
+                for(int32_t j=0; j<msk->rows; j++)
                 {
-                    for(int32_t i=-dc; i<=dc; i++)
+                    const uint8_pixel_t *p = (uint8_pixel_t *)pad->data + ((y + j) * padStride) + x;
+                    const uint8_pixel_t *m = (uint8_pixel_t *)msk->data + (j * mskStride);
+
+                    for(int32_t i=0; i<msk->cols; i++)
                     {
-                        if(((x+i) >= 0) &&
-                           ((y+j) >= 0) &&
-                           ((x+i) <  src->cols) &&
-                           ((y+j) <  src->rows))
-                        {
-                            val += getUint8Pixel(src,x+i,y+j) * getUint8Pixel(msk,i+dc,j+dr);
-                        }
+                        val += p[i] * m[i];
                     }
                 }
 
@@ -1847,7 +2707,7 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
                 }
 
                 // Store the result
-                setUint8Pixel(dst, x, y, val);
+                d[x] = (uint8_pixel_t)val;
             }
         }
     }
@@ -1858,7 +2718,7 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
  *
  * This function can be used to enhance the image contrast. It is also used to
  * scale larger pixel data types to smaller pixel data types, e.g. float to
- * basic.
+ * basic. The pixels are mapped with a lookup table, see applyLut().
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
@@ -1878,46 +2738,37 @@ void scale(const image_t *src ,image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     uint8_pixel_t min=UINT8_PIXEL_MAX, max=UINT8_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
 
     // Scan input image for min/max values
-    for(uint32_t i=0; i<imsize; ++i)
+    for(int32_t y=0; y<src->rows; y++)
     {
-        if(*s < min)
-        {
-            min = *s;
-        }
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if(*s > max)
+        for(int32_t x=0; x<src->cols; ++x)
         {
-            max = *s;
-        }
-
-        ++s;
-    }
+            if(*s < min)
+            {
+                min = *s;
+            }
 
-    // Restore pointers
-    s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            if(*s > max)
+            {
+                max = *s;
+            }
 
-    // Prevent division by zero
-    if(max == min)
-    {
-        // Scale the output to basic image type
-        for(uint32_t i=0; i<imsize; ++i)
-        {
-            *d++ = (uint8_pixel_t)128;
+            ++s;
         }
     }
-    else
+
+    // Scale the output to basic image type, all pixels are within min..max
+    uint8_pixel_t lut[256];
+
+    for(int32_t i=min; i<=max; ++i)
     {
-        // Scale the output to basic image type
-        for(uint32_t i=0; i<imsize; ++i)
-        {
-            *d++ = (uint8_pixel_t)((255.0f/(max-min)) * (*s++ - min) + 0.5f);
-        }
+        lut[i] = (max == min) ? 128 : (uint8_pixel_t)((255.0f/(max-min)) * (i - min) + 0.5f);
     }
+
+    applyLut(src, dst, lut);
 }
 
 /*!
@@ -1945,45 +2796,50 @@ void scaleInt16ToUint8(const image_t *src ,image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     int16_pixel_t min=INT16_PIXEL_MAX, max=INT16_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-
-    int16_pixel_t *s = (int16_pixel_t *)src->data;
 
     // Scan input image for min/max values
-    for(uint32_t i=0; i<imsize; ++i)
+    for(int32_t y=0; y<src->rows; y++)
     {
-        if(*s < min)
-        {
-            min = *s;
-        }
+        int16_pixel_t *s = (int16_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if(*s > max)
+        for(int32_t x=0; x<src->cols; ++x)
         {
-            max = *s;
-        }
+            if(*s < min)
+            {
+                min = *s;
+            }
 
-        ++s;
-    }
+            if(*s > max)
+            {
+                max = *s;
+            }
 
-    // Restore pointers
-    s = (int16_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            ++s;
+        }
+    }
 
-    // Prevent division by zero
-    if(max == min)
+    for(int32_t y=0; y<src->rows; y++)
     {
-        // Scale the output to basic image type
-        for(uint32_t i=0; i<imsize; ++i)
+        // Set pointers to the start of the row
+        int16_pixel_t *s = (int16_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Prevent division by zero
+        if(max == min)
         {
-            *d++ = (uint8_pixel_t)128;
+            // Scale the output to basic image type
+            for(int32_t x=0; x<src->cols; ++x)
+            {
+                *d++ = (uint8_pixel_t)128;
+            }
         }
-    }
-    else
-    {
-        // Scale the output to basic image type
-        for(uint32_t i=0; i<imsize; ++i)
+        else
         {
-            *d++ = (uint8_pixel_t)((255.0f/(max-min)) * (*s++ - min) + 0.5f);
+            // Scale the output to basic image type
+            for(int32_t x=0; x<src->cols; ++x)
+            {
+                *d++ = (uint8_pixel_t)((255.0f/(max-min)) * (*s++ - min) + 0.5f);
+            }
         }
     }
 }
@@ -2013,45 +2869,50 @@ void scaleFloatToUint8(const image_t *src ,image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     float_pixel_t min=FLOAT_PIXEL_MAX, max=FLOAT_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-
-    float_pixel_t *s = (float_pixel_t *)src->data;
 
     // Scan input image for min/max values
-    for(uint32_t i=0; i<imsize; ++i)
+    for(int32_t y=0; y<src->rows; y++)
     {
-        if(*s < min)
-        {
-            min = *s;
-        }
+        float_pixel_t *s = (float_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if(*s > max)
+        for(int32_t x=0; x<src->cols; ++x)
         {
-            max = *s;
-        }
+            if(*s < min)
+            {
+                min = *s;
+            }
 
-        ++s;
-    }
+            if(*s > max)
+            {
+                max = *s;
+            }
 
-    // Restore pointers
-    s = (float_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            ++s;
+        }
+    }
 
-    // Prevent division by zero
-    if(max == min)
+    for(int32_t y=0; y<src->rows; y++)
     {
-        // Scale the output to basic image type
-        for(uint32_t i=0; i<imsize; ++i)
+        // Set pointers to the start of the row
+        float_pixel_t *s = (float_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Prevent division by zero
+        if(max == min)
         {
-            *d++ = (uint8_pixel_t)128;
+            // Scale the output to basic image type
+            for(int32_t x=0; x<src->cols; ++x)
+            {
+                *d++ = (uint8_pixel_t)128;
+            }
         }
-    }
-    else
-    {
-        // Scale the output to basic image type
-        for(uint32_t i=0; i<imsize; ++i)
+        else
         {
-            *d++ = (uint8_pixel_t)((255.0f/(max-min)) * (*s++ - min) + 0.5f);
+            // Scale the output to basic image type
+            for(int32_t x=0; x<src->cols; ++x)
+            {
+                *d++ = (uint8_pixel_t)((255.0f/(max-min)) * (*s++ - min) + 0.5f);
+            }
         }
     }
 }
@@ -2083,99 +2944,127 @@ void scaleFast(const image_t *src, image_t *dst)
     uint8_pixel_t minPixelValue = UINT8_PIXEL_MAX;
     uint8_pixel_t maxPixelValue = UINT8_PIXEL_MIN;
 
-    // Get amount of pixels and pointers to pixels
-    uint32_t pixelAmount = src->rows * src->cols;
-    uint32_t fourPixelsCount = pixelAmount / 4;
-    uint32_t fourPixelsLeftover   = pixelAmount % 4;
-    uint32_t *pSource32 = (uint32_t *)src->data;
-    uint8_t *pSource8;  // Declare once at the start
+    // Packed images are processed as one long row, so the 32-bit word loops
+    // run over the entire image
+    int32_t rowAmount = src->rows;
+    uint32_t pixelAmount = src->cols;
+
+    if(IMAGE_IS_PACKED(src) && IMAGE_IS_PACKED(dst))
+    {
+        rowAmount = 1;
+        pixelAmount = src->rows * src->cols;
+    }
 
     // Find min and max values for pixels. As inspired by EVDK sheets from H. Arends
-    while(fourPixelsCount-- > 0)
+    for(int32_t y = 0; y < rowAmount; y++)
     {
-        uint32_t fourPixels = *pSource32++;
+        // Get amount of pixels and pointers to pixels
+        uint32_t fourPixelsCount = pixelAmount / 4;
+        uint32_t fourPixelsLeftover = pixelAmount % 4;
+        uint32_t *pSource32 = (uint32_t *)((uint8_t *)src->data + (y * IMAGE_STRIDE(src)));
+        uint8_t *pSource8;
 
-        // Extract 4 separate bytes from the 32-bit chunk
-        uint8_t pixel1 = (uint8_t)((fourPixels >>  0) & 0xFF);
-        uint8_t pixel2 = (uint8_t)((fourPixels >>  8) & 0xFF);
-        uint8_t pixel3 = (uint8_t)((fourPixels >> 16) & 0xFF);
-        uint8_t pixel4 = (uint8_t)((fourPixels >> 24) & 0xFF);
+        while(fourPixelsCount-- > 0)
+        {
+            uint32_t fourPixels = *pSource32++;
 
-        // Compare each pixel with the current min/max
-        if (pixel1 < minPixelValue) minPixelValue = pixel1;
-        if (pixel1 > maxPixelValue) maxPixelValue = pixel1;
+            // Extract 4 separate bytes from the 32-bit chunk
+            uint8_t pixel1 = (uint8_t)((fourPixels >>  0) & 0xFF);
+            uint8_t pixel2 = (uint8_t)((fourPixels >>  8) & 0xFF);
+            uint8_t pixel3 = (uint8_t)((fourPixels >> 16) & 0xFF);
+            uint8_t pixel4 = (uint8_t)((fourPixels >> 24) & 0xFF);
 
-        if (pixel2 < minPixelValue) minPixelValue = pixel2;
-        if (pixel2 > maxPixelValue) maxPixelValue = pixel2;
+            // Compare each pixel with the current min/max
+            if (pixel1 < minPixelValue) minPixelValue = pixel1;
+            if (pixel1 > maxPixelValue) maxPixelValue = pixel1;
 
-        if (pixel3 < minPixelValue) minPixelValue = pixel3;
-        if (pixel3 > maxPixelValue) maxPixelValue = pixel3;
+            if (pixel2 < minPixelValue) minPixelValue = pixel2;
+            if (pixel2 > maxPixelValue) maxPixelValue = pixel2;
 
-        if (pixel4 < minPixelValue) minPixelValue = pixel4;
-        if (pixel4 > maxPixelValue) maxPixelValue = pixel4;
-    }
+            if (pixel3 < minPixelValue) minPixelValue = pixel3;
+            if (pixel3 > maxPixelValue) maxPixelValue = pixel3;
 
-    // Handle leftover pixels
-    pSource8 = (uint8_t *)pSource32;  // Just assign, don't redeclare
-    while(fourPixelsLeftover-- > 0)
-    {
-        uint8_t pixel = *pSource8++;
+            if (pixel4 < minPixelValue) minPixelValue = pixel4;
+            if (pixel4 > maxPixelValue) maxPixelValue = pixel4;
+        }
+
+        // Handle leftover pixels
+        pSource8 = (uint8_t *)pSource32;
+        while(fourPixelsLeftover-- > 0)
+        {
+            uint8_t pixel = *pSource8++;
 
-        if (pixel < minPixelValue) minPixelValue = pixel;
-        if (pixel > maxPixelValue) maxPixelValue = pixel;
+            if (pixel < minPixelValue) minPixelValue = pixel;
+            if (pixel > maxPixelValue) maxPixelValue = pixel;
+        }
     }
 
-    // Prevent division by zero
+    // Build a lookup table with the scaled value of every possible pixel
+    // value. Values outside the range min - max only occur in padding pixels.
+    uint8_t lut[256];
+
     if(maxPixelValue == minPixelValue)
     {
-        // Scale the output to basic image type
-        uint8_pixel_t *pDestination = (uint8_pixel_t *)dst->data;
-        for(uint32_t i=0; i<pixelAmount; ++i)
+        // Prevent division by zero
+        memset(lut, 128, sizeof(lut));
+    }
+    else
+    {
+        // Get the scale factor
+        float scaleFactor = 255.0f / (maxPixelValue - minPixelValue);
+
+        for(int32_t i = 0; i < 256; ++i)
         {
-            *pDestination++ = (uint8_pixel_t)128;
+            if(i < minPixelValue)
+            {
+                lut[i] = 0;
+            }
+            else if(i > maxPixelValue)
+            {
+                lut[i] = 255;
+            }
+            else
+            {
+                lut[i] = (uint8_t)(((i - minPixelValue) * scaleFactor) + 0.5f);
+            }
         }
-
-    return;
     }
 
-    // Restore pointers
-    pSource32 = (uint32_t *)src->data;
-
-    // Get the scale factor
-    float scaleFactor = 255.0f / (maxPixelValue - minPixelValue);
-
-    // Process 4 pixels in parallel by casting pointers to 32-bit words
-    uint32_t *pDestination32 = (uint32_t *)dst->data;
-    fourPixelsCount = pixelAmount / 4;
-    fourPixelsLeftover = pixelAmount % 4;
+    // Rows of aligned images are padded to a multiple of IMAGE_ALIGNMENT
+    // bytes, so full rows including the padding are processed and no leftover
+    // pixels remain
+    if(isAlignedImage(src) && isAlignedImage(dst) &&
+       (IMAGE_STRIDE(src) == IMAGE_STRIDE(dst)) && !IMAGE_IS_PACKED(src))
+    {
+        pixelAmount = IMAGE_STRIDE(src);
+    }
 
-    while(fourPixelsCount-- > 0)
+    for(int32_t y = 0; y < rowAmount; y++)
     {
-        uint32_t fourPixels = *pSource32++;
-        
-        // Read pixel value from 32-bit source pointer
-        uint8_t pixelSource1 = fourPixels & 0xFF;          // First byte
-        uint8_t pixelSource2 = (fourPixels >> 8) & 0xFF;   // Second byte  
-        uint8_t pixelSource3 = (fourPixels >> 16) & 0xFF;  // Third byte
-        uint8_t pixelSource4 = (fourPixels >> 24) & 0xFF;  // Fourth byte
+        // Process 4 pixels in parallel by casting pointers to 32-bit words
+        uint32_t fourPixelsCount = pixelAmount / 4;
+        uint32_t fourPixelsLeftover = pixelAmount % 4;
+        uint32_t *pSource32 = (uint32_t *)((uint8_t *)src->data + (y * IMAGE_STRIDE(src)));
+        uint32_t *pDestination32 = (uint32_t *)((uint8_t *)dst->data + (y * IMAGE_STRIDE(dst)));
 
-        // Scale each pixel to full range
-        uint8_t pixelDest1 = ((pixelSource1 - minPixelValue) * scaleFactor) + 0.5f;
-        uint8_t pixelDest2 = ((pixelSource2 - minPixelValue) * scaleFactor) + 0.5f;
-        uint8_t pixelDest3 = ((pixelSource3 - minPixelValue) * scaleFactor) + 0.5f; 
-        uint8_t pixelDest4 = ((pixelSource4 - minPixelValue) * scaleFactor) + 0.5f;
+        while(fourPixelsCount-- > 0)
+        {
+            uint32_t fourPixels = *pSource32++;
 
-        // Combine scaled pixels back into 32-bit word
-        *pDestination32++ = (pixelDest4 << 24) | (pixelDest3 << 16) | (pixelDest2 << 8) | pixelDest1;
-    }
+            // Scale each byte of the 32-bit word and combine the results
+            *pDestination32++ = ((uint32_t)lut[(fourPixels >> 24) & 0xFF] << 24) |
+                                ((uint32_t)lut[(fourPixels >> 16) & 0xFF] << 16) |
+                                ((uint32_t)lut[(fourPixels >>  8) & 0xFF] <<  8) |
+                                ((uint32_t)lut[(fourPixels >>  0) & 0xFF] <<  0);
+        }
 
-    // Handle leftover pixels
-    pSource8 = (uint8_t *)pSource32;
-    uint8_t *pDestination8 = (uint8_t *)pDestination32;
+        // Handle leftover pixels
+        uint8_t *pSource8 = (uint8_t *)pSource32;
+        uint8_t *pDestination8 = (uint8_t *)pDestination32;
 
-    while(fourPixelsLeftover-- > 0)
-    {
-        uint8_t pixel = *pSource8++;
-        *pDestination8++ = (uint8_t)(((pixel - minPixelValue) * scaleFactor) + 0.5f);
+        while(fourPixelsLeftover-- > 0)
+        {
+            *pDestination8++ = lut[*pSource8++];
+        }
     }
 }
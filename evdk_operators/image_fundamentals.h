@@ -54,6 +54,10 @@ image_t *newInt32Image(const uint32_t cols, const uint32_t rows);
 image_t *newFloatImage(const uint32_t cols, const uint32_t rows);
 image_t *newUyvyImage(const uint32_t cols, const uint32_t rows);
 image_t *newBgr888Image(const uint32_t cols, const uint32_t rows);
+image_t *newInt64Image(const uint32_t cols, const uint32_t rows);
+image_t *newComplexImage(const uint32_t cols, const uint32_t rows);
+image_t *newBin1Image(const uint32_t cols, const uint32_t rows);
+image_t *newPaddedImage(const eImageType type, const uint32_t cols, const uint32_t rows);
 /// \}
 
 /// \name Functions for creating new images without data allocation
@@ -66,8 +70,24 @@ image_t *newEmptyUyvyImage(const uint32_t cols, const uint32_t rows);
 image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows);
 /// \}
 
+/// \name Functions for region of interest (ROI) views
+/// \{
+uint32_t getPixelSize(const eImageType type);
+uint32_t getPaddedStride(const eImageType type, const uint32_t cols);
+uint8_t isAlignedImage(const image_t *img);
+image_t roiImage(const image_t *img, const int32_t x, const int32_t y, const int32_t cols, const int32_t rows);
+/// \}
+
+/// \name Functions for border handling
+/// \{
+int32_t getBorderCoordinate(int32_t i, const int32_t size, const eBorder border);
+int32_t nextBorderColumn(const image_t *img, const int32_t x, const int32_t y, const int32_t r);
+void copyWithBorder(const image_t *src, image_t *dst, const eBorder border, const int32_t value);
+/// \}
+
 /// \name Functions for deleting images
 /// \{
+void deleteImage(image_t *img);
 void deleteUint8Image(image_t *img);
 void deleteInt16Image(image_t *img);
 void deleteInt32Image(image_t *img);
@@ -77,6 +97,13 @@ void deleteBgr888Image(image_t *img);
 void deleteAllImages(void);
 /// \}
 
+/// \name Functions for managing the image pool
+/// \{
+uint32_t imagePoolMark(void);
+void imagePoolRelease(const uint32_t mark);
+void imagePoolTrim(void);
+/// \}
+
 /// \name Functions for copying images
 /// \{
 void copyUint8Image(const image_t *src, image_t *dst);
@@ -127,6 +154,8 @@ void convertUyvyToBgr888(image_t *src, image_t *dst);
 void convertUint8ToBgr888(image_t *src, image_t *dst);
 void convertBgr888ToUint8(image_t *src, image_t *dst);
 void convertBgr888ToInt16(image_t *src, image_t *dst);
+void convertUint8ToBin1(const image_t *src, image_t *dst);
+void convertBin1ToUint8(const image_t *src, image_t *dst);
 
 extern void convertUyvyToUint8_cm33(image_t *src, image_t *dst);
 /// \}
@@ -138,8 +167,18 @@ void convertToUyvy(image_t *src, image_t *dst);
 void convertToBgr888(image_t *src, image_t *dst);
 /// \}
 
+/// \name Functions for integral images
+/// \{
+void integralImage(const image_t *src, image_t *dst);
+void integralSquaredImage(const image_t *src, image_t *dst);
+void integralImageUpdate(const image_t *src, image_t *dst, const int32_t y, const int32_t rows);
+void integralSquaredImageUpdate(const image_t *src, image_t *dst, const int32_t y, const int32_t rows);
+int64_t integralRectSum(const image_t *integral, const int32_t x, const int32_t y, const int32_t cols, const int32_t rows);
+/// \}
+
 // Functions are documented in the source file
 
+void applyLut(const image_t *src, image_t *dst, const uint8_pixel_t *lut);
 void setSelectedToValue(const image_t *src, image_t *dst, const uint8_pixel_t selected, const uint8_pixel_t value);
 uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y, const uint8_pixel_t p, const eConnected c);
 void scale(const image_t *src, image_t *dst);
@@ -147,8 +186,12 @@ void scaleInt16ToUint8(const image_t *src, image_t *dst);
 void scaleFloatToUint8(const image_t *src ,image_t *dst);
 void scaleFast(const image_t *src, image_t *dst);
 void convolve(const image_t *src, image_t *dst, const image_t *msk);
+void convolveBorder(const image_t *src, image_t *dst, const image_t *msk, const eBorder border);
+void convolveSeparable(const image_t *src, image_t *dst, const int16_t *rowKernel, const int16_t *colKernel, const uint8_t n, const uint8_t shift, const eBorder border);
 void convolveFast(const image_t *src, image_t *dst, const image_t *msk);
 void correlate(const image_t *src, image_t *dst, const image_t *msk);
+void correlateBorder(const image_t *src, image_t *dst, const image_t *msk, const eBorder border);
+void correlatePadded(const image_t *pad, image_t *dst, const image_t *msk);
 
 #endif // _IMAGE_FUNDAMENTALS_H_
 
@@ -71,16 +71,19 @@ void area(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
 
-    uint32_t imsize = img->rows * img->cols;
-    uint8_pixel_t *p = (uint8_pixel_t *)img->data;
     uint32_t cnt = 0;
 
     // Scan input image for blobnr
-    for(uint32_t i=0; i<imsize; ++i)
+    for(int32_t y=0; y<img->rows; ++y)
     {
-        if(*p++ == blobnr)
+        uint8_pixel_t *p = (uint8_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        for(int32_t x=0; x<img->cols; ++x)
         {
-            ++cnt;
+            if(*p++ == blobnr)
+            {
+                ++cnt;
+            }
         }
     }
 
@@ -444,6 +447,8 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
     // Create local variables for efficiency
     uint32_t width = src->cols;
     uint32_t height = src->rows;
+    uint32_t srcStride = IMAGE_STRIDE(src);
+    uint32_t dstStride = IMAGE_STRIDE(dst);
     uint8_t *sourcePixel = (uint8_t *)src->data;
     uint8_t *destinationPixel = (uint8_t *)dst->data;
     uint32_t nextAvailableLabel = 1;
@@ -453,7 +458,7 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
     {
         for (uint32_t x = 0; x < width; x++)
         {
-            uint32_t pixelPosition = y * width + x;
+            uint32_t pixelPosition = y * dstStride + x;
             
             // Set border pixels to 0
             if (x == 0 || x == width-1 || y == 0 || y == height-1)
@@ -463,7 +468,7 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
             }
             
             // Skip background pixels
-            if (sourcePixel[pixelPosition] == 0)
+            if (sourcePixel[y * srcStride + x] == 0)
             {
                 destinationPixel[pixelPosition] = 0;
                 continue;
@@ -480,9 +485,9 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
             }
 
             // Check upper neighbor 
-            if (destinationPixel[pixelPosition - width] > 0)
+            if (destinationPixel[pixelPosition - dstStride] > 0)
             {
-                uint32_t upLabel = destinationPixel[pixelPosition - width];
+                uint32_t upLabel = destinationPixel[pixelPosition - dstStride];
                 if (hasNeighbor)
                 {
                     if (upLabel < currentLabel)
@@ -506,9 +511,9 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
             if (connected == CONNECTED_EIGHT)
             {
                 // Check upper-left diagonal
-                if (destinationPixel[pixelPosition - width - 1] > 0)
+                if (destinationPixel[pixelPosition - dstStride - 1] > 0)
                 {
-                    uint32_t diagonalLabel = destinationPixel[pixelPosition - width - 1];
+                    uint32_t diagonalLabel = destinationPixel[pixelPosition - dstStride - 1];
                     if (hasNeighbor)
                     {
                         if (diagonalLabel < currentLabel)
@@ -529,9 +534,9 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
                 }
 
                 // Check upper-right diagonal
-                if (destinationPixel[pixelPosition - width + 1] > 0)
+                if (destinationPixel[pixelPosition - dstStride + 1] > 0)
                 {
-                    uint32_t diagonalLabel = destinationPixel[pixelPosition - width + 1];
+                    uint32_t diagonalLabel = destinationPixel[pixelPosition - dstStride + 1];
                     if (hasNeighbor)
                     {
                         if (diagonalLabel < currentLabel)
@@ -596,11 +601,16 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
     }
 
     // Second pass: Replace temporary labels with final labels
-    for (uint32_t i = 0; i < width * height; i++)
+    for (uint32_t y = 0; y < height; y++)
     {
-        if (destinationPixel[i] > 0)
+        uint8_t *d = destinationPixel + (y * dstStride);
+
+        for (uint32_t x = 0; x < width; x++)
         {
-            destinationPixel[i] = finalLabels[labelEquivalenceTable[destinationPixel[i]]];
+            if (d[x] > 0)
+            {
+                d[x] = finalLabels[labelEquivalenceTable[d[x]]];
+            }
         }
     }
 
@@ -826,17 +836,20 @@ void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
     const int32_t width = img->cols;
     const int32_t height = img->rows;
     const uint8_t *srcPixels = (uint8_t *)img->data;
+    const uint32_t srcStride = IMAGE_STRIDE(img);
     const uint32_t stride = width;
 
-    // Allocate edge-only temporary image
-    uint8_t *edges = (uint8_t *)calloc(width * height, sizeof(uint8_t));
-    if (edges == NULL) {
+    // Acquire edge-only temporary image from the image pool
+    image_t *edgeImage = newUint8Image(width, height);
+    if (edgeImage == NULL) {
         return;
     }
+    uint8_t *edges = edgeImage->data;
+    memset(edges, 0, width * height * sizeof(uint8_t));
 
     // Edge pixel detection - optimized direct memory access
     for (int32_t y = 1; y < height-1; y++) {
-        const uint32_t rowOffset = y * stride;
+        const uint32_t rowOffset = y * srcStride;
         for (int32_t x = 1; x < width-1; x++) {
             const uint32_t pos = rowOffset + x;
             
@@ -845,10 +858,10 @@ void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
                 // Optimized 4-connected neighbor check using pointer arithmetic
                 if (srcPixels[pos - 1] != blobnr ||      // Left
                     srcPixels[pos + 1] != blobnr ||      // Right  
-                    srcPixels[pos - stride] != blobnr ||  // Up
-                    srcPixels[pos + stride] != blobnr)    // Down
+                    srcPixels[pos - srcStride] != blobnr ||  // Up
+                    srcPixels[pos + srcStride] != blobnr)    // Down
                 {
-                    edges[pos] = 1;
+                    edges[y * stride + x] = 1;
                 }
             }
         }
@@ -896,7 +909,7 @@ void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
     }
 
     // Cleanup and store result
-    free(edges);
+    deleteUint8Image(edgeImage);
     blobinfo->perimeter = perimeterLength;
 }
 
@@ -925,7 +938,8 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     ASSERT(y < 0, "y-value is out of range");
     ASSERT(y >= img->rows, "y-value is out of range");
 
-    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * img->cols + x));
+    register int32_t stride = IMAGE_STRIDE(img);
+    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * stride + x));
 
     uint8_pixel_t val = UINT8_PIXEL_MAX;
     uint8_pixel_t pixel;
@@ -935,12 +949,12 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     {
         pixel = *(s + sizeof(uint8_pixel_t)); // right
         if((pixel < val) && (pixel > 1)){ val = pixel; }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + (stride * sizeof(uint8_pixel_t))); // down
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) + 1); // down-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
@@ -949,26 +963,26 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     {
         pixel = *(s - sizeof(uint8_pixel_t)); // left
         if((pixel < val) && (pixel > 1)){ val = pixel; }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + (stride * sizeof(uint8_pixel_t))); // down
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) - 1); // down-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
     // Left-bottom pixel
     else if(x == 0 && y == img->rows-1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - (stride * sizeof(uint8_pixel_t))); // up
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s + sizeof(uint8_pixel_t)); // right
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) + 1); // up-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
 
@@ -976,14 +990,14 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     // Right-bottom pixel
     else if(x == img->cols-1 && y == img->rows-1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - (stride * sizeof(uint8_pixel_t))); // up
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s - sizeof(uint8_pixel_t)); // left
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) - 1); // up-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
@@ -994,21 +1008,21 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s + sizeof(uint8_pixel_t)); // right
         if((pixel < val) && (pixel > 1)){ val = pixel; }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + (stride * sizeof(uint8_pixel_t))); // down
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) - 1); // down-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) + 1); // down-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
     // Bottom border pixels
     else if(y == img->rows-1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - (stride * sizeof(uint8_pixel_t))); // up
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s - sizeof(uint8_pixel_t)); // left
         if((pixel < val) && (pixel > 1)){ val = pixel; }
@@ -1017,69 +1031,69 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1);  // up-left
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) - 1);  // up-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1);  // up-right
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) + 1);  // up-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
     // Left border pixels
     else if(x == 0)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - (stride * sizeof(uint8_pixel_t))); // up
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s + sizeof(uint8_pixel_t)); // right
         if((pixel < val) && (pixel > 1)){ val = pixel; }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + (stride * sizeof(uint8_pixel_t))); // down
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) + 1); // up-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) + 1); // down-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
     // Right border pixels
     else if(x == img->cols-1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t)));// up
+        pixel = *(s - (stride * sizeof(uint8_pixel_t)));// up
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s - sizeof(uint8_pixel_t)); // left
         if((pixel < val) && (pixel > 1)){ val = pixel; }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + (stride * sizeof(uint8_pixel_t))); // down
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) - 1); // up-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) - 1); // down-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
     else
     {
         // Inner pixels
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - (stride * sizeof(uint8_pixel_t))); // up
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s - sizeof(uint8_pixel_t)); // left
         if((pixel < val) && (pixel > 1)){ val = pixel; }
         pixel = *(s + sizeof(uint8_pixel_t)); // right
         if((pixel < val) && (pixel > 1)){ val = pixel; }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + (stride * sizeof(uint8_pixel_t))); // down
         if((pixel < val) && (pixel > 1)){ val = pixel; }
 
         if(c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) - 1); // up-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - (stride * sizeof(uint8_pixel_t)) + 1); // up-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) - 1); // down-left
             if((pixel < val) && (pixel > 1)){ val = pixel; }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + (stride * sizeof(uint8_pixel_t)) + 1); // down-right
             if((pixel < val) && (pixel > 1)){ val = pixel; }
         }
     }
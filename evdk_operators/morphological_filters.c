@@ -39,12 +39,171 @@
 
 #include <string.h>
 
+/*!
+ * \brief Copies a row of a binary image into a line buffer with one word of
+ *        border at both sides
+ *
+ * Rows outside the image and the bits after the last column are set to
+ * \p fill, so shifted words can be read without checking the borders.
+ *
+ * \param[in]  img    A pointer to an IMGTYPE_BIN1 image
+ * \param[in]  y      The row to copy, may be outside the image
+ * \param[out] line   A pointer to BIN1_WORDS(img->cols) + 2 words
+ * \param[in]  fill   The value of the bits outside the image
+ * \param[in]  invert Is XOR-ed with the bits inside the image
+ */
+static void bin1Line(const image_t *img, const int32_t y, bin1_word_t *line,
+                     const bin1_word_t fill, const bin1_word_t invert)
+{
+    const int32_t words = BIN1_WORDS(img->cols);
+
+    line[0] = fill;
+    line[words + 1] = fill;
+
+    if((y < 0) || (y >= img->rows))
+    {
+        for(int32_t k=1; k<=words; k++)
+        {
+            line[k] = fill;
+        }
+
+        return;
+    }
+
+    const bin1_word_t *s = (bin1_word_t *)img->data + (y * (IMAGE_STRIDE(img) / 64));
+
+    for(int32_t k=0; k<words; k++)
+    {
+        line[k + 1] = s[k] ^ invert;
+    }
+
+    const int32_t used = img->cols % 64;
+
+    if(used != 0)
+    {
+        const bin1_word_t outside = ~(bin1_word_t)0 << used;
+
+        line[words] = (line[words] & ~outside) | (fill & outside);
+    }
+}
+
+/*!
+ * \brief Word-parallel binary erosion or dilation of an IMGTYPE_BIN1 image
+ *
+ * For every element of the mask, the source rows are shifted by the offset of
+ * the element and combined with the result using AND (erosion) or OR
+ * (dilation), so 64 pixels are processed by a few instructions. Pixels outside
+ * the image are 1 for erosion and 0 for dilation, as for the uint8 images.
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dst    A pointer to the destination image
+ * \param[in]  mask   A pointer to a square mask of size \p n
+ * \param[in]  n      The size of the mask, at most 127
+ * \param[in]  erode  1 for erosion, 0 for dilation
+ * \param[in]  invert ~0 to use the complement of the source image, 0
+ *                    otherwise
+ */
+static void bin1Morph(const image_t *src, image_t *dst, const uint8_t *mask,
+                      const uint8_t n, const uint8_t erode, const bin1_word_t invert)
+{
+    const int32_t r = n/2;
+
+    ASSERT(r >= 64, "mask is too large for an IMGTYPE_BIN1 image");
+
+    const int32_t words = BIN1_WORDS(src->cols);
+    const bin1_word_t fill = erode ? ~(bin1_word_t)0 : 0;
+
+    // Line buffer with border and the result of a row
+    image_t *buf = newBin1Image((2 * words + 2) * 64, 1);
+    ASSERT(buf == NULL, "unable to allocate memory for the line buffer");
+
+    bin1_word_t *line = (bin1_word_t *)buf->data;
+    bin1_word_t *acc = line + words + 2;
+
+    const int32_t used = src->cols % 64;
+    const bin1_word_t outside = (used == 0) ? 0 : (~(bin1_word_t)0 << used);
+
+    for(int32_t y=0; y<src->rows; y++)
+    {
+        // AND starts with all ones, OR with all zeros
+        for(int32_t k=0; k<words; k++)
+        {
+            acc[k] = fill;
+        }
+
+        for(int32_t j=0; j<=(2*r); j++)
+        {
+            const uint8_t *m = mask + (j * n);
+            int32_t set = 0;
+
+            for(int32_t i=0; i<=(2*r); i++)
+            {
+                set |= (m[i] == 1);
+            }
+
+            // Skip mask rows without elements
+            if(set == 0)
+            {
+                continue;
+            }
+
+            bin1Line(src, y + j - r, line, fill, invert);
+
+            for(int32_t i=0; i<=(2*r); i++)
+            {
+                // Is the corresponding cell in the mask set?
+                if(m[i] != 1)
+                {
+                    continue;
+                }
+
+                // Bit b of the shifted word is the pixel dx to the right
+                const int32_t dx = i - r;
+
+                for(int32_t k=0; k<words; k++)
+                {
+                    bin1_word_t w;
+
+                    if(dx == 0)
+                    {
+                        w = line[k + 1];
+                    }
+                    else if(dx > 0)
+                    {
+                        w = (line[k + 1] >> dx) | (line[k + 2] << (64 - dx));
+                    }
+                    else
+                    {
+                        w = (line[k + 1] << -dx) | (line[k] >> (64 + dx));
+                    }
+
+                    acc[k] = erode ? (acc[k] & w) : (acc[k] | w);
+                }
+            }
+        }
+
+        // Store the result, the bits after the last column are left as is
+        bin1_word_t *d = (bin1_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / 64));
+
+        for(int32_t k=0; k<(words - 1); k++)
+        {
+            d[k] = acc[k];
+        }
+
+        d[words - 1] = (d[words - 1] & outside) | (acc[words - 1] & ~outside);
+    }
+
+    deleteImage(buf);
+}
+
 /*!
  * \brief Binary dilation of an object increases its geometrical area
  *
  * Dilation is defined as the union of all vector additions of all pixels a
  * in object A with all pixels b in the structuring function B (\p mask).
  *
+ * IMGTYPE_BIN1 images are processed 64 pixels at a time.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -57,8 +216,8 @@ void dilation(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BIN1), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -69,39 +228,54 @@ void dilation(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
+    if(src->type == IMGTYPE_BIN1)
+    {
+        bin1Morph(src, dst, mask, n, 0, 0);
+        return;
+    }
+
+    const int32_t r = n/2;
+
+    // Pixels outside the image are background, so they never cause dilation
+    image_t *pad = newPaddedImage(IMGTYPE_UINT8, src->cols + (2*r), src->rows + (2*r));
+    ASSERT(pad == NULL, "unable to allocate memory for the border");
+
+    copyWithBorder(src, pad, BORDER_CONSTANT, 0);
+
+    const int32_t padStride = IMAGE_STRIDE(pad);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
     // Loop all pixels
     for(int32_t y=0; y<src->rows; y++)
     {
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * dstStride);
+
         for(int32_t x=0; x<src->cols; x++)
         {
-            uint32_t smax = 0;
+            uint32_t result = 0;
 
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
+            // The window is always within the image with border
+            for(int32_t j=0; j<=(2*r); j++)
             {
-                for(int32_t i=-n/2; i<=n/2; i++)
+                const uint8_pixel_t *p = (uint8_pixel_t *)pad->data + ((y+j) * padStride) + x;
+                const uint8_t *m = mask + (j * n);
+
+                for(int32_t i=0; i<=(2*r); i++)
                 {
-                    if((x+i) >= 0 &&
-                       (y+j) >= 0 &&
-                       (x+i) <  src->cols &&
-                       (y+j) <  src->rows)
+                    // Is the corresponding cell in the mask set?
+                    if((p[i] == 1) && (m[i] == 1))
                     {
-                        // Is the pixel set and is the corresponding
-                        // cell in the mask set?
-                        if((getUint8Pixel(src,x+i,y+j) == 1) &&
-                           (mask[((j+(n/2))*n) + (i+(n/2))] == 1))
-                        {
-                            // Mark this cell for dilation
-                            smax = 1;
-                        }
+                        result = 1;
                     }
                 }
             }
 
             // Store the result
-            setUint8Pixel(dst,x,y,smax);
+            d[x] = result;
         }
     }
+
+    deleteImage(pad);
 }
 
 /*!
@@ -134,10 +308,45 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Loop all pixels
+    const int32_t r = n/2;
+    const int32_t stride = IMAGE_STRIDE(src);
+
+    // Interior pixels: the window is always within the image
+    for(int32_t y=r; y<(src->rows-r); y++)
+    {
+        for(int32_t x=r; x<(src->cols-r); x++)
+        {
+            int32_t smax = 0;
+
+            for(int32_t j=0; j<=(2*r); j++)
+            {
+                const uint8_pixel_t *p = (uint8_pixel_t *)src->data + ((y-r+j) * stride) + (x-r);
+                const uint8_t *m = mask + (j * n);
+
+                for(int32_t i=0; i<=(2*r); i++)
+                {
+                    int32_t val = p[i] + m[i];
+
+                    if(val > smax)
+                        smax = val;
+                }
+            }
+
+            // Clip the result
+            if(smax > 255)
+            {
+                smax = 255;
+            }
+
+            // Store the result
+            setUint8Pixel(dst,x,y,smax);
+        }
+    }
+
+    // Border pixels: only the pixels within the image are part of the window
     for(int32_t y=0; y<src->rows; y++)
     {
-        for(int32_t x=0; x<src->cols; x++)
+        for(int32_t x=nextBorderColumn(src,-1,y,r); x<src->cols; x=nextBorderColumn(src,x,y,r))
         {
             int32_t smax = 0;
 
@@ -177,6 +386,8 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
  * Erosion is defined as the complement of the resulting dilation of the
  * complement of object A with structuring function B (\p mask).
  *
+ * IMGTYPE_BIN1 images are processed 64 pixels at a time.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -189,8 +400,8 @@ void erosion(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BIN1), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -201,39 +412,54 @@ void erosion(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
+    if(src->type == IMGTYPE_BIN1)
+    {
+        bin1Morph(src, dst, mask, n, 1, 0);
+        return;
+    }
+
+    const int32_t r = n/2;
+
+    // Pixels outside the image are object pixels, so they never cause erosion
+    image_t *pad = newPaddedImage(IMGTYPE_UINT8, src->cols + (2*r), src->rows + (2*r));
+    ASSERT(pad == NULL, "unable to allocate memory for the border");
+
+    copyWithBorder(src, pad, BORDER_CONSTANT, 1);
+
+    const int32_t padStride = IMAGE_STRIDE(pad);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
     // Loop all pixels
     for(int32_t y=0; y<src->rows; y++)
     {
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * dstStride);
+
         for(int32_t x=0; x<src->cols; x++)
         {
-            uint32_t smin = 1;
+            uint32_t result = 1;
 
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
+            // The window is always within the image with border
+            for(int32_t j=0; j<=(2*r); j++)
             {
-                for(int32_t i=-n/2; i<=n/2; i++)
+                const uint8_pixel_t *p = (uint8_pixel_t *)pad->data + ((y+j) * padStride) + x;
+                const uint8_t *m = mask + (j * n);
+
+                for(int32_t i=0; i<=(2*r); i++)
                 {
-                    if((x+i) >= 0 &&
-                       (y+j) >= 0 &&
-                       (x+i) <  src->cols &&
-                       (y+j) <  src->rows)
+                    // Is the corresponding cell in the mask set?
+                    if((p[i] == 0) && (m[i] == 1))
                     {
-                        // Is the pixel background and is the corresponding
-                        // cell in the mask set?
-                        if((getUint8Pixel(src,x+i,y+j) == 0) &&
-                           (mask[((j+(n/2))*n) + (i+(n/2))] == 1))
-                        {
-                            // Mark this cell for erosion
-                            smin = 0;
-                        }
+                        result = 0;
                     }
                 }
             }
 
             // Store the result
-            setUint8Pixel(dst,x,y,smin);
+            d[x] = result;
         }
     }
+
+    deleteImage(pad);
 }
 
 /*!
@@ -266,10 +492,45 @@ void erosionGray(const image_t *src, image_t *dst, const uint8_t *mask, const ui
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Loop all pixels
+    const int32_t r = n/2;
+    const int32_t stride = IMAGE_STRIDE(src);
+
+    // Interior pixels: the window is always within the image
+    for(int32_t y=r; y<(src->rows-r); y++)
+    {
+        for(int32_t x=r; x<(src->cols-r); x++)
+        {
+            int32_t smin = 255;
+
+            for(int32_t j=0; j<=(2*r); j++)
+            {
+                const uint8_pixel_t *p = (uint8_pixel_t *)src->data + ((y-r+j) * stride) + (x-r);
+                const uint8_t *m = mask + (j * n);
+
+                for(int32_t i=0; i<=(2*r); i++)
+                {
+                    int32_t val = p[i] - m[i];
+
+                    if(val < smin)
+                        smin = val;
+                }
+            }
+
+            // Clip the result
+            if(smin < 0)
+            {
+                smin = 0;
+            }
+
+            // Store the result
+            setUint8Pixel(dst,x,y,smin);
+        }
+    }
+
+    // Border pixels: only the pixels within the image are part of the window
     for(int32_t y=0; y<src->rows; y++)
     {
-        for(int32_t x=0; x<src->cols; x++)
+        for(int32_t x=nextBorderColumn(src,-1,y,r); x<src->cols; x=nextBorderColumn(src,x,y,r))
         {
             int32_t smin = 255;
 
@@ -477,21 +738,26 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
     const uint32_t width = src->cols;
     const uint32_t height = src->rows;
     const uint32_t imageSize = width * height;
+    const uint32_t srcStride = IMAGE_STRIDE(src);
+    const uint32_t dstStride = IMAGE_STRIDE(dst);
 
-    // Allocate memory for label arrays
-    uint32_t *labelMap = (uint32_t *)malloc(imageSize * sizeof(uint32_t));
+    // Allocate memory for label arrays. The label map is taken from the
+    // image pool, because it is as large as the image.
+    image_t *labels = newInt32Image(width, height);
     uint32_t *labelEquivalence = (uint32_t *)malloc(lutSize * sizeof(uint32_t));
     uint8_t *borderFlags = (uint8_t *)malloc(lutSize * sizeof(uint8_t));
 
     // Verify memory allocation
-    if (labelMap == NULL || labelEquivalence == NULL || borderFlags == NULL)
+    if (labels == NULL || labelEquivalence == NULL || borderFlags == NULL)
     {
-        free(labelMap);
+        deleteInt32Image(labels);
         free(labelEquivalence);
         free(borderFlags);
         return 0; // Memory allocation failed
     }
 
+    uint32_t *labelMap = (uint32_t *)labels->data;
+
     // Initialize work arrays
     memset(labelMap, 0, imageSize * sizeof(uint32_t));
     memset(borderFlags, 0, lutSize * sizeof(uint8_t));
@@ -515,7 +781,7 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
             const uint32_t pixelPosition = y * width + x;
             
             // Skip foreground pixels
-            if (sourcePixel[pixelPosition] == 1)
+            if (sourcePixel[y * srcStride + x] == 1)
             {
                 labelMap[pixelPosition] = 0;
                 continue;
@@ -610,7 +876,7 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
             {
                 if (currentLabelID >= lutSize)
                 {
-                    free(labelMap);
+                    deleteInt32Image(labels);
                     free(labelEquivalence);
                     free(borderFlags);
                     return 0; // Label table overflow
@@ -659,32 +925,39 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
     }
 
     // Second pass: Fill holes and create final image
-    for (uint32_t i = 0; i < imageSize; i++)
+    for (uint32_t y = 0; y < height; y++)
     {
-        if (sourcePixel[i] == 1)
-        {
-            destinationPixel[i] = 1; // Preserve foreground pixels
-        }
-        else if (labelMap[i] > 0)
+        const uint8_t *s = sourcePixel + (y * srcStride);
+        uint8_t *d = destinationPixel + (y * dstStride);
+        const uint32_t *l = labelMap + (y * width);
+
+        for (uint32_t x = 0; x < width; x++)
         {
-            // Fill holes not connected to border
-            if (borderFlags[labelEquivalence[labelMap[i]]] == 0)
+            if (s[x] == 1)
             {
-                destinationPixel[i] = 1;
+                d[x] = 1; // Preserve foreground pixels
+            }
+            else if (l[x] > 0)
+            {
+                // Fill holes not connected to border
+                if (borderFlags[labelEquivalence[l[x]]] == 0)
+                {
+                    d[x] = 1;
+                }
+                else
+                {
+                    d[x] = 0;
+                }
             }
             else
             {
-                destinationPixel[i] = 0;
+                d[x] = 0;
             }
         }
-        else
-        {
-            destinationPixel[i] = 0;
-        }
     }
 
     // Release allocated memory
-    free(labelMap);
+    deleteInt32Image(labels);
     free(labelEquivalence);
     free(borderFlags);
 
@@ -697,6 +970,8 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
  * The function uses a hit mask and a miss mask with the requirement that the
  * intersection of the two masks is empty.
  *
+ * IMGTYPE_BIN1 images are processed 64 pixels at a time.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  m1  3x3 Hit mask
@@ -709,8 +984,8 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BIN1), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
 
     // Verifiy mask validity
     ASSERT((m1[0] & m2[0]) == 1 ||
@@ -729,6 +1004,37 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
+    if(src->type == IMGTYPE_BIN1)
+    {
+        const int32_t words = BIN1_WORDS(src->cols);
+        const int32_t used = src->cols % 64;
+        const bin1_word_t outside = (used == 0) ? 0 : (~(bin1_word_t)0 << used);
+
+        image_t *miss = newBin1Image(src->cols, src->rows);
+        ASSERT(miss == NULL, "not enough memory for image allocation");
+
+        bin1Morph(src, dst, m1, 3, 1, 0);
+        bin1Morph(src, miss, m2, 3, 1, ~(bin1_word_t)0);
+
+        // Calculate the intersection
+        for(int32_t y=0; y<src->rows; y++)
+        {
+            bin1_word_t *d = (bin1_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / 64));
+            const bin1_word_t *m = (bin1_word_t *)miss->data + (y * (IMAGE_STRIDE(miss) / 64));
+
+            // The bits after the last column are left as is
+            for(int32_t k=0; k<(words - 1); k++)
+            {
+                d[k] &= m[k];
+            }
+
+            d[words - 1] &= m[words - 1] | outside;
+        }
+
+        deleteImage(miss);
+        return;
+    }
+
     // Create temporary image
     image_t *org = newUint8Image(src->cols, src->rows);
     image_t *tmp = newUint8Image(src->cols, src->rows);
@@ -771,6 +1077,10 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
  * The result is the eroded image subtracted from the original image or the
  * original image subtracted from the dilated image.
  *
+ * IMGTYPE_BIN1 images are processed 64 pixels at a time. For these images
+ * the result is the set difference, so it is 0 where a background pixel is
+ * part of the eroded image.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -783,8 +1093,8 @@ void outline(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BIN1), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -795,6 +1105,32 @@ void outline(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
+    if(src->type == IMGTYPE_BIN1)
+    {
+        const int32_t words = BIN1_WORDS(src->cols);
+        const int32_t used = src->cols % 64;
+        const bin1_word_t outside = (used == 0) ? 0 : (~(bin1_word_t)0 << used);
+
+        bin1Morph(src, dst, mask, n, 1, 0);
+
+        // Subtract the eroded image from the original image
+        for(int32_t y=0; y<src->rows; y++)
+        {
+            const bin1_word_t *o = (bin1_word_t *)src->data + (y * (IMAGE_STRIDE(src) / 64));
+            bin1_word_t *d = (bin1_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / 64));
+
+            for(int32_t k=0; k<(words - 1); k++)
+            {
+                d[k] = o[k] & ~d[k];
+            }
+
+            // The bits after the last column are left as is
+            d[words - 1] = (d[words - 1] & outside) | (o[words - 1] & ~d[words - 1] & ~outside);
+        }
+
+        return;
+    }
+
     erosion(src, dst, mask, n);
 
     // Loop all pixels
@@ -944,6 +1280,8 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
 
     uint32_t width = src->cols;
     uint32_t height = src->rows;
+    uint32_t srcStride = IMAGE_STRIDE(src);
+    uint32_t dstStride = IMAGE_STRIDE(dst);
 
     // Get direct pointers to pixel data for faster access
     const uint8_t *sourcePixel = (const uint8_t *)src->data;
@@ -953,17 +1291,22 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
     // Shapes touching the border get a special label, so we can remove them.
     // Create arrays for storing labels and lookup table
     // LUT is used to track label equivalences
+    // The label map is taken from the image pool, because it is as large as
+    // the image.
     uint32_t *labelEquivalence = (uint32_t *)calloc(lutSize, sizeof(uint32_t));
-    uint32_t *labelMap = (uint32_t *)calloc(width * height, sizeof(uint32_t));
+    image_t *labels = newInt32Image(width, height);
 
     // Check if memory allocation worked
-    if (!labelMap || !labelEquivalence)
+    if (!labels || !labelEquivalence)
     {
         free(labelEquivalence);
-        free(labelMap);
+        deleteInt32Image(labels);
         return 0;
     }
 
+    uint32_t *labelMap = (uint32_t *)labels->data;
+    memset(labelMap, 0, width * height * sizeof(uint32_t));
+
     // Setup initial LUT values:
     // 1 = regular label
     // 2 = special label for border-connected pixels
@@ -985,30 +1328,30 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
     // Process bottom border
     for (uint32_t x = 0; x < width; ++x)
     {
-        if (sourcePixel[(height - 1) * width + x] == 1)
+        if (sourcePixel[(height - 1) * srcStride + x] == 1)
         {
             labelMap[(height - 1) * width + x] = 2;
-            destinationPixel[(height - 1) * width + x] = 2;
+            destinationPixel[(height - 1) * dstStride + x] = 2;
         }
     }
 
     // Process left border
     for (uint32_t y = 0; y < height; ++y)
     {
-        if (sourcePixel[y * width] == 1)
+        if (sourcePixel[y * srcStride] == 1)
         {
             labelMap[y * width] = 2;
-            destinationPixel[y * width] = 2;
+            destinationPixel[y * dstStride] = 2;
         }
     }
 
     // Process right border
     for (uint32_t y = 0; y < height; ++y)
     {
-        if (sourcePixel[y * width + (width - 1)] == 1)
+        if (sourcePixel[y * srcStride + (width - 1)] == 1)
         {
             labelMap[y * width + (width - 1)] = 2;
-            destinationPixel[y * width + (width - 1)] = 2;
+            destinationPixel[y * dstStride + (width - 1)] = 2;
         }
     }
 
@@ -1020,8 +1363,11 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
         for (uint32_t x = 0; x < width; ++x)
         {
 
-            // Here, we calculate the position of the current pixel in the image array.
+            // Here, we calculate the position of the current pixel in the label
+            // map and in the (possibly strided) source and destination images.
             uint32_t pixelPosition = y * width + x;
+            uint32_t sourcePosition = y * srcStride + x;
+            uint32_t destinationPosition = y * dstStride + x;
 
             // We also calculate the positions of neighboring pixels above and to the left (and diagonals if 8-connected).
             uint32_t pixelUp;
@@ -1065,9 +1411,9 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
             }
 
             // Skip background pixels (value 0) because we only label object pixels.
-            if (sourcePixel[pixelPosition] == 0)
+            if (sourcePixel[sourcePosition] == 0)
             {
-                destinationPixel[pixelPosition] = 0;
+                destinationPixel[destinationPosition] = 0;
                 continue;
             }
 
@@ -1132,20 +1478,20 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
                 if (currentLabelID >= lutSize)
                 {
                     free(labelEquivalence);
-                    free(labelMap);
+                    deleteInt32Image(labels);
                     return 0;
                 }
 
                 labelMap[pixelPosition] = currentLabelID;
                 labelEquivalence[currentLabelID] = currentLabelID;
-                destinationPixel[pixelPosition] = currentLabelID;
+                destinationPixel[destinationPosition] = currentLabelID;
                 ++currentLabelID;
             }
             // If neighbors exist, use smallest label and update equivalences
             else
             {
                 labelMap[pixelPosition] = minimalNeighborLabel;
-                destinationPixel[pixelPosition] = minimalNeighborLabel;
+                destinationPixel[destinationPosition] = minimalNeighborLabel;
 
                 // Update label equivalences
                 for (int i = 0; i < neighborCount; ++i)
@@ -1161,7 +1507,7 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
                 if (minimalNeighborLabel == 2 || labelEquivalence[minimalNeighborLabel] == 2)
                 {
                     labelEquivalence[labelMap[pixelPosition]] = 2;
-                    destinationPixel[pixelPosition] = 2;
+                    destinationPixel[destinationPosition] = 2;
                 }
             }
         }
@@ -1195,22 +1541,23 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst, const eConne
         for (uint32_t x = 0; x < width; ++x)
         {
             uint32_t pixelPosition = y * width + x;
+            uint32_t destinationPosition = y * dstStride + x;
             uint32_t label = labelMap[pixelPosition];
 
             if (labelEquivalence[label] == 2)
             {
-                destinationPixel[pixelPosition] = 0;
+                destinationPixel[destinationPosition] = 0;
             }
             else if (label != 0)
             {
-                destinationPixel[pixelPosition] = 1;
+                destinationPixel[destinationPosition] = 1;
             }
         }
     }
 
     // Clean up allocated memory
     free(labelEquivalence);
-    free(labelMap);
+    deleteInt32Image(labels);
 
     return 1; // This means we succeeded.
 }
@@ -37,6 +37,8 @@
 #include "image_fundamentals.h"
 #include "nonlinear_filters.h"
 
+#include <string.h>
+
 /*!
  * \brief Removes positive outliers
  *
@@ -64,10 +66,50 @@ void harmonic(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
+    const int32_t r = n/2;
+    const int32_t stride = IMAGE_STRIDE(src);
+
+    // Interior pixels: the window is always within the image
+    for(int32_t y=r; y<(src->rows-r); y++)
+    {
+        for(int32_t x=r; x<(src->cols-r); x++)
+        {
+            // Initialize filter specific variables
+            float sum = 0;
+            uint8_t zero = 0;
+
+            for(int32_t j=-r; (j<=r) && !zero; j++)
+            {
+                const uint8_pixel_t *p = (uint8_pixel_t *)src->data + ((y+j) * stride) + (x-r);
+
+                for(int32_t i=0; i<=(2*r); i++)
+                {
+                    if(p[i] == 0)
+                    {
+                        zero = 1;
+                        break;
+                    }
+
+                    sum += 1.0f / p[i];
+                }
+            }
+
+            // Calculate and store the result
+            if(zero)
+            {
+                setUint8Pixel(dst,x,y,0);
+            }
+            else
+            {
+                setUint8Pixel(dst,x,y,(uint8_pixel_t)((n*n)/sum + 0.5f));
+            }
+        }
+    }
+
+    // Border pixels: only the pixels within the image are part of the window
     for(int32_t y=0; y<src->rows; y++)
     {
-        for(int32_t x=0; x<src->cols; x++)
+        for(int32_t x=nextBorderColumn(src,-1,y,r); x<src->cols; x=nextBorderColumn(src,x,y,r))
         {
             // Initialize filter specific variables
             float sum = 0;
@@ -118,6 +160,168 @@ void harmonic(const image_t *src, image_t *dst, const uint8_t n)
     }
 }
 
+/*!
+ * \brief Running minimum and maximum of a line of pixels
+ *
+ * Implementation of the van Herk/Gil-Werman algorithm. The line is extended
+ * with \p r pixels at both sides that never change the result and is split
+ * into blocks of the window size w=2r+1. Within every block, the running
+ * minimum is computed from left to right (g) and from right to left (h). A
+ * window that starts at position i covers the end of one block and the start
+ * of the next, so its minimum is min(h[i], g[i+w-1]). This takes three
+ * comparisons per pixel, independent of the window size. The maximum is
+ * computed in the same way.
+ *
+ * The minimum and maximum are computed in one pass. Either can be skipped by
+ * passing NULL for its destination.
+ *
+ * \param[in]  sMin A pointer to the first pixel of the line for the minimum
+ * \param[in]  sMax A pointer to the first pixel of the line for the maximum
+ * \param[in]  sStep Number of pixels between two pixels of the source line
+ * \param[out] dMin A pointer to the first pixel of the minimum line, or NULL
+ * \param[out] dMax A pointer to the first pixel of the maximum line, or NULL
+ * \param[in]  dStep Number of pixels between two pixels of the destination
+ *                   lines
+ * \param[in]  len  Number of pixels in the line
+ * \param[in]  r    Radius of the window
+ * \param[in]  buf  Buffer of at least four times the size of the extended
+ *                  line, rounded up to a multiple of the window size
+ */
+static void minMaxLine(const uint8_pixel_t *sMin, const uint8_pixel_t *sMax,
+                       const int32_t sStep, uint8_pixel_t *dMin,
+                       uint8_pixel_t *dMax, const int32_t dStep,
+                       const int32_t len, const int32_t r, uint8_pixel_t *buf)
+{
+    const int32_t w = (2 * r) + 1;
+    const int32_t size = (((len + (2 * r)) + w - 1) / w) * w;
+
+    uint8_pixel_t *gMin = buf;
+    uint8_pixel_t *hMin = buf + size;
+    uint8_pixel_t *gMax = buf + (2 * size);
+    uint8_pixel_t *hMax = buf + (3 * size);
+
+    if(dMin != NULL)
+    {
+        // Extended line, pixels outside the image never change the minimum
+        for(int32_t p=0; p<size; p++)
+        {
+            hMin[p] = ((p >= r) && ((p - r) < len)) ? sMin[(p - r) * sStep] : UINT8_PIXEL_MAX;
+        }
+
+        for(int32_t b=0; b<size; b+=w)
+        {
+            // Running minimum from left to right
+            gMin[b] = hMin[b];
+            for(int32_t p=b+1; p<(b + w); p++)
+            {
+                gMin[p] = (hMin[p] < gMin[p-1]) ? hMin[p] : gMin[p-1];
+            }
+
+            // Running minimum from right to left
+            for(int32_t p=(b + w - 2); p>=b; p--)
+            {
+                hMin[p] = (hMin[p+1] < hMin[p]) ? hMin[p+1] : hMin[p];
+            }
+        }
+
+        for(int32_t x=0; x<len; x++)
+        {
+            dMin[x * dStep] = (hMin[x] < gMin[x + w - 1]) ? hMin[x] : gMin[x + w - 1];
+        }
+    }
+
+    if(dMax != NULL)
+    {
+        // Extended line, pixels outside the image never change the maximum
+        for(int32_t p=0; p<size; p++)
+        {
+            hMax[p] = ((p >= r) && ((p - r) < len)) ? sMax[(p - r) * sStep] : UINT8_PIXEL_MIN;
+        }
+
+        for(int32_t b=0; b<size; b+=w)
+        {
+            // Running maximum from left to right
+            gMax[b] = hMax[b];
+            for(int32_t p=b+1; p<(b + w); p++)
+            {
+                gMax[p] = (hMax[p] > gMax[p-1]) ? hMax[p] : gMax[p-1];
+            }
+
+            // Running maximum from right to left
+            for(int32_t p=(b + w - 2); p>=b; p--)
+            {
+                hMax[p] = (hMax[p+1] > hMax[p]) ? hMax[p+1] : hMax[p];
+            }
+        }
+
+        for(int32_t x=0; x<len; x++)
+        {
+            dMax[x * dStep] = (hMax[x] > gMax[x + w - 1]) ? hMax[x] : gMax[x + w - 1];
+        }
+    }
+}
+
+/*!
+ * \brief Calculates the minimum and/or maximum of the pixels within the window
+ *
+ * Only the pixels within the image are part of the window. The square window
+ * is separable, so the running minimum and maximum are first computed along
+ * the rows and then along the columns of the result.
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dstMin A pointer to the minimum image, or NULL
+ * \param[out] dstMax A pointer to the maximum image, or NULL
+ * \param[in]  r      Radius of the square window
+ */
+static void minMaxFilter(const image_t *src, image_t *dstMin, image_t *dstMax,
+                         const int32_t r)
+{
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t w = (2 * r) + 1;
+    const int32_t len = (cols > rows) ? cols : rows;
+    const int32_t size = (((len + (2 * r)) + w - 1) / w) * w;
+
+    image_t *buf = newUint8Image(size, 4);
+    image_t *tmpMin = (dstMin != NULL) ? newUint8Image(cols, rows) : NULL;
+    image_t *tmpMax = (dstMax != NULL) ? newUint8Image(cols, rows) : NULL;
+    ASSERT((dstMin != NULL) && (dstMax != NULL) &&
+           (IMAGE_STRIDE(dstMin) != IMAGE_STRIDE(dstMax)), "dst images have different strides");
+    ASSERT((buf == NULL) ||
+           ((dstMin != NULL) && (tmpMin == NULL)) ||
+           ((dstMax != NULL) && (tmpMax == NULL)), "unable to allocate memory");
+
+    const int32_t srcStride = IMAGE_STRIDE(src);
+    uint8_pixel_t *tMin = (tmpMin != NULL) ? tmpMin->data : NULL;
+    uint8_pixel_t *tMax = (tmpMax != NULL) ? tmpMax->data : NULL;
+
+    // Horizontal pass
+    for(int32_t y=0; y<rows; y++)
+    {
+        const uint8_pixel_t *s = src->data + (y * srcStride);
+
+        minMaxLine(s, s, 1,
+                   (tMin != NULL) ? (tMin + (y * cols)) : NULL,
+                   (tMax != NULL) ? (tMax + (y * cols)) : NULL, 1,
+                   cols, r, buf->data);
+    }
+
+    // Vertical pass
+    for(int32_t x=0; x<cols; x++)
+    {
+        minMaxLine((tMin != NULL) ? (tMin + x) : NULL,
+                   (tMax != NULL) ? (tMax + x) : NULL, cols,
+                   (dstMin != NULL) ? (dstMin->data + x) : NULL,
+                   (dstMax != NULL) ? (dstMax->data + x) : NULL,
+                   (dstMin != NULL) ? IMAGE_STRIDE(dstMin) : IMAGE_STRIDE(dstMax),
+                   rows, r, buf->data);
+    }
+
+    deleteImage(tmpMax);
+    deleteImage(tmpMin);
+    deleteImage(buf);
+}
+
 /*!
  * \brief Removes negative outlier noise
  *
@@ -143,41 +347,22 @@ void maximum(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for(int32_t y=0; y<src->rows; y++)
-    {
-        for(int32_t x=0; x<src->cols; x++)
-        {
-            // Initialize filter specific variables
-            uint8_pixel_t max = UINT8_PIXEL_MIN;
-
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
-            {
-                for(int32_t i=-n/2; i<=n/2; i++)
-                {
-                    if((x+i) >= 0 &&
-                        (y+j) >= 0 &&
-                        (x+i) <  src->cols &&
-                        (y+j) <  src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src,x+i,y+j);
-                        max = p > max ? p : max;
-                    }
-                }
-            }
-
-            // Calculate and store the result
-            setUint8Pixel(dst,x,y,max);
-        }
-    }
+    // Pixels outside the image are not part of the window
+    minMaxFilter(src, NULL, dst, n/2);
 }
 
 /*!
  * \brief Calculates the arithmetic mean of the pixels within the window
  *
- * The window is always a square.
+ * The window is always a square. Pixels outside the image are not part of the
+ * window, so the window shrinks at the borders of the image.
+ *
+ * The sums of the window columns are kept for every column of the image and
+ * are updated with one pixel entering and one pixel leaving the window when
+ * moving to the next row. The window sum slides along the column sums in the
+ * same way, so the cost per pixel does not depend on \p n.
+ *
+ * The result is rounded to the nearest integer with halves rounded up.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
@@ -201,38 +386,95 @@ void mean(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for(int32_t y=0; y<src->rows; y++)
+    const int32_t r = n/2;
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t srcStride = IMAGE_STRIDE(src);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    // Sum of the window rows for every column
+    image_t *colSums = newInt32Image(cols, 1);
+    ASSERT(colSums == NULL, "unable to allocate memory for the column sums");
+
+    uint32_t *colSum = (uint32_t *)colSums->data;
+
+    // Initialise the column sums with the window of the first row
+    memset(colSum, 0, cols * sizeof(uint32_t));
+
+    for(int32_t j=0; (j<=r) && (j<rows); j++)
     {
-        for(int32_t x=0; x<src->cols; x++)
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (j * srcStride);
+
+        for(int32_t x=0; x<cols; x++)
         {
-            // Initialize filter specific variables
-            uint32_t sum = 0;
-            uint32_t cnt = 0;
+            colSum[x] += s[x];
+        }
+    }
 
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
+    // Loop all rows
+    for(int32_t y=0; y<rows; y++)
+    {
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * dstStride);
+
+        // Number of window rows within the image
+        int32_t top    = (y-r) > 0 ? (y-r) : 0;
+        int32_t bottom = (y+r) < (rows-1) ? (y+r) : (rows-1);
+        uint32_t rowCnt = bottom - top + 1;
+
+        // Window sum of the first column
+        uint32_t sum = 0;
+        int32_t right = (r < (cols-1)) ? r : (cols-1);
+
+        for(int32_t x=0; x<=right; x++)
+        {
+            sum += colSum[x];
+        }
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            // Number of window columns within the image
+            int32_t left = (x-r) > 0 ? (x-r) : 0;
+            right = (x+r) < (cols-1) ? (x+r) : (cols-1);
+            uint32_t cnt = rowCnt * (right - left + 1);
+
+            // Calculate and store the rounded result
+            d[x] = (uint8_pixel_t)(((2 * sum) + cnt) / (2 * cnt));
+
+            // Slide the window one column to the right
+            if((x+r+1) < cols)
             {
-                for(int32_t i=-n/2; i<=n/2; i++)
-                {
-                    if((x+i) >= 0 &&
-                        (y+j) >= 0 &&
-                        (x+i) <  src->cols &&
-                        (y+j) <  src->rows)
-                    {
-                        // Count the number of valid pixels
-                        cnt++;
+                sum += colSum[x+r+1];
+            }
 
-                        // Calculation for each window cell
-                        sum += getUint8Pixel(src,x+i,y+j);
-                    }
-                }
+            if((x-r) >= 0)
+            {
+                sum -= colSum[x-r];
             }
+        }
 
-            // Calculate and store the result
-            setUint8Pixel(dst,x,y,(uint8_pixel_t)((float)sum/(float)cnt + 0.5f));
+        // Slide the window one row down
+        if((y+r+1) < rows)
+        {
+            const uint8_pixel_t *s = (uint8_pixel_t *)src->data + ((y+r+1) * srcStride);
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                colSum[x] += s[x];
+            }
+        }
+
+        if((y-r) >= 0)
+        {
+            const uint8_pixel_t *s = (uint8_pixel_t *)src->data + ((y-r) * srcStride);
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                colSum[x] -= s[x];
+            }
         }
     }
+
+    deleteImage(colSums);
 }
 
 /*!
@@ -253,6 +495,8 @@ void meanFast(const image_t *src, image_t *dst)
 
     int32_t width = src->cols;
     int32_t height = src->rows;
+    int32_t srcStride = IMAGE_STRIDE(src);
+    int32_t dstStride = IMAGE_STRIDE(dst);
 
     // Loop all pixels
     for (int32_t y = 1; y < height - 1; y++)
@@ -263,27 +507,397 @@ void meanFast(const image_t *src, image_t *dst)
             int32_t sum = 0;
 
             // Calculate the offset for the current pixel
-            sum +=  sourcePixel[(y + 1) * width + (x + 1)] +
-                    sourcePixel[(y + 1) * width + (x    )] +
-                    sourcePixel[(y + 1) * width + (x - 1)] +
-                    sourcePixel[(y    ) * width + (x + 1)] +
-                    sourcePixel[(y    ) * width + (x    )] +
-                    sourcePixel[(y    ) * width + (x - 1)] +
-                    sourcePixel[(y - 1) * width + (x + 1)] +
-                    sourcePixel[(y - 1) * width + (x    )] +
-                    sourcePixel[(y - 1) * width + (x - 1)];
+            sum +=  sourcePixel[(y + 1) * srcStride + (x + 1)] +
+                    sourcePixel[(y + 1) * srcStride + (x    )] +
+                    sourcePixel[(y + 1) * srcStride + (x - 1)] +
+                    sourcePixel[(y    ) * srcStride + (x + 1)] +
+                    sourcePixel[(y    ) * srcStride + (x    )] +
+                    sourcePixel[(y    ) * srcStride + (x - 1)] +
+                    sourcePixel[(y - 1) * srcStride + (x + 1)] +
+                    sourcePixel[(y - 1) * srcStride + (x    )] +
+                    sourcePixel[(y - 1) * srcStride + (x - 1)];
 
             // Calculate the average (mean) and store the result
             float mean = (float)sum / 9.0f + 0.5f;
 
             // Set the destination pixel
-            destinationPixel[y * width + x] = (uint8_pixel_t)mean;
+            destinationPixel[y * dstStride + x] = (uint8_pixel_t)mean;
         }
     }
 
     return;
 }
 
+/*!
+ * \brief Sorts \p values and returns the centre value
+ *
+ * If the number of values is even, which might be the case for border pixels,
+ * the average of the two centre values is returned.
+ *
+ * \param[in,out] values The values, sorted when the function returns
+ * \param[in]     cnt    The number of values
+ *
+ * \return The median
+ */
+static uint8_pixel_t getMedian(uint8_pixel_t *values, const uint32_t cnt)
+{
+    // Use the 'Insertion sort' algorithm to sort the median values
+    // Loop through all elements, starting at second
+    for(uint32_t i=1; i<cnt; i++)
+    {
+        // Copy the element
+        uint8_pixel_t a = values[i];
+
+        // Move 'backwards' and shift all values bigger then the current
+        // value to the next position in the array
+        uint32_t j;
+        for(j=i; j>0 && values[j-1] > a; j--){ values[j] = values[j-1]; }
+
+        // Insert current element at this position in the array
+        values[j] = a;
+    }
+
+    // Check if there is an even number of pixels.
+    if((cnt%2) == 0)
+    {
+        return (uint8_pixel_t)((values[(cnt/2) - 1] + values[cnt/2]) / 2.0f + 0.5f);
+    }
+
+    return values[cnt/2];
+}
+
+/*!
+ * \brief Sorts two values in place, so \p a holds the smallest value
+ */
+#define PIX_SORT(a,b) { uint8_pixel_t t_ = ((a) < (b)) ? (a) : (b); \
+                        (b) = ((a) < (b)) ? (b) : (a); (a) = t_; }
+
+/*!
+ * \brief Returns the median of 9 values with a sorting network
+ *
+ * Only the comparisons needed to find the centre value are done (19 instead of
+ * the 25 of a full sorting network). The values are partially sorted when the
+ * function returns.
+ *
+ * \param[in,out] p The 9 values
+ *
+ * \return The median
+ */
+static uint8_pixel_t getMedian9(uint8_pixel_t *p)
+{
+    PIX_SORT(p[1], p[2]);   PIX_SORT(p[4], p[5]);   PIX_SORT(p[7], p[8]);
+    PIX_SORT(p[0], p[1]);   PIX_SORT(p[3], p[4]);   PIX_SORT(p[6], p[7]);
+    PIX_SORT(p[1], p[2]);   PIX_SORT(p[4], p[5]);   PIX_SORT(p[7], p[8]);
+    PIX_SORT(p[0], p[3]);   PIX_SORT(p[5], p[8]);   PIX_SORT(p[4], p[7]);
+    PIX_SORT(p[3], p[6]);   PIX_SORT(p[1], p[4]);   PIX_SORT(p[2], p[5]);
+    PIX_SORT(p[4], p[7]);   PIX_SORT(p[4], p[2]);   PIX_SORT(p[6], p[4]);
+    PIX_SORT(p[4], p[2]);
+
+    return p[4];
+}
+
+/*!
+ * \brief Returns the median of 25 values with a sorting network
+ *
+ * Only the comparisons needed to find the centre value are done (99). The
+ * values are partially sorted when the function returns.
+ *
+ * \param[in,out] p The 25 values
+ *
+ * \return The median
+ */
+static uint8_pixel_t getMedian25(uint8_pixel_t *p)
+{
+    PIX_SORT(p[0], p[1]);   PIX_SORT(p[3], p[4]);   PIX_SORT(p[2], p[4]);
+    PIX_SORT(p[2], p[3]);   PIX_SORT(p[6], p[7]);   PIX_SORT(p[5], p[7]);
+    PIX_SORT(p[5], p[6]);   PIX_SORT(p[9], p[10]);  PIX_SORT(p[8], p[10]);
+    PIX_SORT(p[8], p[9]);   PIX_SORT(p[12], p[13]); PIX_SORT(p[11], p[13]);
+    PIX_SORT(p[11], p[12]); PIX_SORT(p[15], p[16]); PIX_SORT(p[14], p[16]);
+    PIX_SORT(p[14], p[15]); PIX_SORT(p[18], p[19]); PIX_SORT(p[17], p[19]);
+    PIX_SORT(p[17], p[18]); PIX_SORT(p[21], p[22]); PIX_SORT(p[20], p[22]);
+    PIX_SORT(p[20], p[21]); PIX_SORT(p[23], p[24]); PIX_SORT(p[2], p[5]);
+    PIX_SORT(p[3], p[6]);   PIX_SORT(p[0], p[6]);   PIX_SORT(p[0], p[3]);
+    PIX_SORT(p[4], p[7]);   PIX_SORT(p[1], p[7]);   PIX_SORT(p[1], p[4]);
+    PIX_SORT(p[11], p[14]); PIX_SORT(p[8], p[14]);  PIX_SORT(p[8], p[11]);
+    PIX_SORT(p[12], p[15]); PIX_SORT(p[9], p[15]);  PIX_SORT(p[9], p[12]);
+    PIX_SORT(p[13], p[16]); PIX_SORT(p[10], p[16]); PIX_SORT(p[10], p[13]);
+    PIX_SORT(p[20], p[23]); PIX_SORT(p[17], p[23]); PIX_SORT(p[17], p[20]);
+    PIX_SORT(p[21], p[24]); PIX_SORT(p[18], p[24]); PIX_SORT(p[18], p[21]);
+    PIX_SORT(p[19], p[22]); PIX_SORT(p[8], p[17]);  PIX_SORT(p[9], p[18]);
+    PIX_SORT(p[0], p[18]);  PIX_SORT(p[0], p[9]);   PIX_SORT(p[10], p[19]);
+    PIX_SORT(p[1], p[19]);  PIX_SORT(p[1], p[10]);  PIX_SORT(p[11], p[20]);
+    PIX_SORT(p[2], p[20]);  PIX_SORT(p[2], p[11]);  PIX_SORT(p[12], p[21]);
+    PIX_SORT(p[3], p[21]);  PIX_SORT(p[3], p[12]);  PIX_SORT(p[13], p[22]);
+    PIX_SORT(p[4], p[22]);  PIX_SORT(p[4], p[13]);  PIX_SORT(p[14], p[23]);
+    PIX_SORT(p[5], p[23]);  PIX_SORT(p[5], p[14]);  PIX_SORT(p[15], p[24]);
+    PIX_SORT(p[6], p[24]);  PIX_SORT(p[6], p[15]);  PIX_SORT(p[7], p[16]);
+    PIX_SORT(p[7], p[19]);  PIX_SORT(p[13], p[21]); PIX_SORT(p[15], p[23]);
+    PIX_SORT(p[7], p[13]);  PIX_SORT(p[7], p[15]);  PIX_SORT(p[1], p[9]);
+    PIX_SORT(p[3], p[11]);  PIX_SORT(p[5], p[17]);  PIX_SORT(p[11], p[17]);
+    PIX_SORT(p[9], p[17]);  PIX_SORT(p[4], p[10]);  PIX_SORT(p[6], p[12]);
+    PIX_SORT(p[7], p[14]);  PIX_SORT(p[4], p[6]);   PIX_SORT(p[4], p[7]);
+    PIX_SORT(p[12], p[14]); PIX_SORT(p[10], p[14]); PIX_SORT(p[6], p[7]);
+    PIX_SORT(p[10], p[12]); PIX_SORT(p[6], p[10]);  PIX_SORT(p[6], p[17]);
+    PIX_SORT(p[12], p[17]); PIX_SORT(p[7], p[17]);  PIX_SORT(p[7], p[10]);
+    PIX_SORT(p[12], p[18]); PIX_SORT(p[7], p[12]);  PIX_SORT(p[10], p[18]);
+    PIX_SORT(p[12], p[20]); PIX_SORT(p[10], p[20]); PIX_SORT(p[10], p[12]);
+
+    return p[12];
+}
+
+#undef PIX_SORT
+
+/// Number of fine histogram bins per coarse histogram bin
+#define MEDIAN_FINE_BINS (16)
+
+/*!
+ * \brief Data of the sliding window histogram of the median filter
+ */
+typedef struct
+{
+    const uint8_pixel_t *fine;   ///< Fine (256 bins) histogram per column
+    const uint8_pixel_t *coarse; ///< Coarse (16 bins) histogram per column
+    int32_t cols;                ///< Number of columns in the image
+    int32_t r;                   ///< Window radius
+    uint16_t kernelCoarse[256 / MEDIAN_FINE_BINS]; ///< Coarse window histogram
+    uint16_t kernelFine[256];                      ///< Fine window histogram
+    int32_t synced[256 / MEDIAN_FINE_BINS];        ///< Column for which each
+                                                   ///< part of kernelFine is valid
+}medianHistogram_t;
+
+/*!
+ * \brief Returns the value with rank \p k in the window of column \p x
+ *
+ * The coarse window histogram is always up to date. It is used to find the
+ * coarse bin that holds the value. Only that part of the fine window
+ * histogram is brought up to date, by adding and removing the column
+ * histograms that entered and left the window since the part was last used.
+ * If more columns than the window size have passed, the part is recomputed.
+ *
+ * \param[in,out] h The window histogram
+ * \param[in]     x The column
+ * \param[in]     k The rank, starting at 0 for the smallest value
+ *
+ * \return The value with rank \p k
+ */
+static uint8_pixel_t getHistogramRank(medianHistogram_t *h, const int32_t x, uint32_t k)
+{
+    const int32_t r = h->r;
+
+    // Find the coarse bin
+    uint32_t b = 0;
+    while(k >= h->kernelCoarse[b])
+    {
+        k -= h->kernelCoarse[b];
+        b++;
+    }
+
+    uint16_t *kf = &h->kernelFine[b * MEDIAN_FINE_BINS];
+
+    if((x - h->synced[b]) > ((2 * r) + 1))
+    {
+        // Recompute this part of the fine window histogram
+        int32_t left  = (x-r) > 0 ? (x-r) : 0;
+        int32_t right = (x+r) < (h->cols-1) ? (x+r) : (h->cols-1);
+
+        memset(kf, 0, MEDIAN_FINE_BINS * sizeof(uint16_t));
+
+        for(int32_t c=left; c<=right; c++)
+        {
+            const uint8_pixel_t *f = &h->fine[(c * 256) + (b * MEDIAN_FINE_BINS)];
+
+            for(int32_t i=0; i<MEDIAN_FINE_BINS; i++)
+            {
+                kf[i] += f[i];
+            }
+        }
+    }
+    else
+    {
+        // Update this part of the fine window histogram column by column
+        for(int32_t c=h->synced[b]+1; c<=x; c++)
+        {
+            if((c+r) < h->cols)
+            {
+                const uint8_pixel_t *f = &h->fine[((c+r) * 256) + (b * MEDIAN_FINE_BINS)];
+
+                for(int32_t i=0; i<MEDIAN_FINE_BINS; i++)
+                {
+                    kf[i] += f[i];
+                }
+            }
+
+            if((c-r-1) >= 0)
+            {
+                const uint8_pixel_t *f = &h->fine[((c-r-1) * 256) + (b * MEDIAN_FINE_BINS)];
+
+                for(int32_t i=0; i<MEDIAN_FINE_BINS; i++)
+                {
+                    kf[i] -= f[i];
+                }
+            }
+        }
+    }
+
+    h->synced[b] = x;
+
+    // Find the fine bin
+    uint32_t i = 0;
+    while(k >= kf[i])
+    {
+        k -= kf[i];
+        i++;
+    }
+
+    return (uint8_pixel_t)((b * MEDIAN_FINE_BINS) + i);
+}
+
+/*!
+ * \brief Adds (\p sign is 1) or removes (\p sign is -1) an image row to or
+ *        from the column histograms
+ */
+static void updateColumnHistograms(const uint8_pixel_t *s, uint8_pixel_t *fine,
+                                   uint8_pixel_t *coarse, const int32_t cols,
+                                   const int32_t sign)
+{
+    for(int32_t x=0; x<cols; x++)
+    {
+        fine[(x * 256) + s[x]] += sign;
+        coarse[(x * (256 / MEDIAN_FINE_BINS)) + (s[x] / MEDIAN_FINE_BINS)] += sign;
+    }
+}
+
+/*!
+ * \brief Median filter with a sliding window histogram
+ *
+ * Implementation of Perreault and Hébert, "Median Filtering in Constant
+ * Time". A histogram is kept for every column of the image over the rows of
+ * the window. Moving to the next row adds one pixel to and removes one pixel
+ * from each column histogram. The window histogram is the sum of the column
+ * histograms within the window, which is updated by adding the entering and
+ * removing the leaving column histogram. Two-level histograms limit both the
+ * update and the search to a few bins, so the cost per pixel does not depend
+ * on the window size.
+ *
+ * Column histograms only count the pixels within the image, so the window
+ * shrinks at the border of the image just like median().
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  r   Radius of the square window
+ */
+static void medianHistogram(const image_t *src, image_t *dst, const int32_t r)
+{
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t srcStride = IMAGE_STRIDE(src);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    // The window size is at most 255, so column histogram counts fit in a
+    // byte
+    image_t *fine = newUint8Image(256, cols);
+    image_t *coarse = newUint8Image(256 / MEDIAN_FINE_BINS, cols);
+    ASSERT((fine == NULL) || (coarse == NULL), "unable to allocate memory for the histograms");
+
+    memset(fine->data, 0, cols * 256);
+    memset(coarse->data, 0, cols * (256 / MEDIAN_FINE_BINS));
+
+    medianHistogram_t h;
+    h.fine = fine->data;
+    h.coarse = coarse->data;
+    h.cols = cols;
+    h.r = r;
+
+    // Initialise the column histograms with the window of the first row
+    for(int32_t j=0; (j<=r) && (j<rows); j++)
+    {
+        updateColumnHistograms(src->data + (j * srcStride), fine->data, coarse->data, cols, 1);
+    }
+
+    // Loop all rows
+    for(int32_t y=0; y<rows; y++)
+    {
+        uint8_pixel_t *d = dst->data + (y * dstStride);
+
+        // Number of window rows within the image
+        int32_t top    = (y-r) > 0 ? (y-r) : 0;
+        int32_t bottom = (y+r) < (rows-1) ? (y+r) : (rows-1);
+        uint32_t rowCnt = bottom - top + 1;
+
+        // Coarse window histogram of the first column. The fine window
+        // histogram is computed when needed.
+        memset(h.kernelCoarse, 0, sizeof(h.kernelCoarse));
+
+        for(int32_t c=0; (c<=r) && (c<cols); c++)
+        {
+            for(int32_t i=0; i<(256 / MEDIAN_FINE_BINS); i++)
+            {
+                h.kernelCoarse[i] += h.coarse[(c * (256 / MEDIAN_FINE_BINS)) + i];
+            }
+        }
+
+        for(int32_t i=0; i<(256 / MEDIAN_FINE_BINS); i++)
+        {
+            h.synced[i] = INT32_MIN / 2;
+        }
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            // Number of window columns within the image
+            int32_t left  = (x-r) > 0 ? (x-r) : 0;
+            int32_t right = (x+r) < (cols-1) ? (x+r) : (cols-1);
+            uint32_t cnt  = rowCnt * (right - left + 1);
+
+            // Calculate and store the result. Same rounding as getMedian().
+            if((cnt%2) == 0)
+            {
+                uint32_t a = getHistogramRank(&h, x, (cnt/2) - 1);
+                uint32_t b = getHistogramRank(&h, x, cnt/2);
+                d[x] = (uint8_pixel_t)((a + b + 1) / 2);
+            }
+            else
+            {
+                d[x] = getHistogramRank(&h, x, cnt/2);
+            }
+
+            // Slide the coarse window histogram one column to the right
+            if((x+r+1) < cols)
+            {
+                const uint8_pixel_t *c = &h.coarse[(x+r+1) * (256 / MEDIAN_FINE_BINS)];
+
+                for(int32_t i=0; i<(256 / MEDIAN_FINE_BINS); i++)
+                {
+                    h.kernelCoarse[i] += c[i];
+                }
+            }
+
+            if((x-r) >= 0)
+            {
+                const uint8_pixel_t *c = &h.coarse[(x-r) * (256 / MEDIAN_FINE_BINS)];
+
+                for(int32_t i=0; i<(256 / MEDIAN_FINE_BINS); i++)
+                {
+                    h.kernelCoarse[i] -= c[i];
+                }
+            }
+        }
+
+        // Slide the column histograms one row down
+        if((y+r+1) < rows)
+        {
+            updateColumnHistograms(src->data + ((y+r+1) * srcStride), fine->data, coarse->data, cols, 1);
+        }
+
+        if((y-r) >= 0)
+        {
+            updateColumnHistograms(src->data + ((y-r) * srcStride), fine->data, coarse->data, cols, -1);
+        }
+    }
+
+    deleteImage(coarse);
+    deleteImage(fine);
+}
+
 /*!
  * \brief The median is calculated by sorting the pixels in the \p n x \p n
  * window and selecting the centre value
@@ -293,6 +907,13 @@ void meanFast(const image_t *src, image_t *dst)
  * Can remove outlier noise from images that contain less than 50% of its
  * pixels as outliers
  *
+ * Pixels outside the image are not part of the window. If the number of
+ * pixels in the window is even, the average of the two centre values is
+ * used.
+ *
+ * 3x3 and 5x5 windows use a sorting network. Larger windows use a sliding
+ * window histogram, so the cost per pixel does not depend on \p n.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  n   Size of the square window
@@ -314,14 +935,44 @@ void median(const image_t *src, image_t *dst, const uint8_t n)
 
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
-    ASSERT(n > 11, "window size is too large");
 
-    uint8_pixel_t median[121];
+    const int32_t r = n/2;
+    const int32_t stride = IMAGE_STRIDE(src);
 
-    // Loop all pixels
+    if((n != 3) && (n != 5))
+    {
+        medianHistogram(src, dst, r);
+        return;
+    }
+
+    uint8_pixel_t median[25];
+
+    // Interior pixels: the window is always within the image
+    for(int32_t y=r; y<(src->rows-r); y++)
+    {
+        for(int32_t x=r; x<(src->cols-r); x++)
+        {
+            uint32_t cnt = 0;
+
+            for(int32_t j=-r; j<=r; j++)
+            {
+                const uint8_pixel_t *p = (uint8_pixel_t *)src->data + ((y+j) * stride) + (x-r);
+
+                for(int32_t i=0; i<=(2*r); i++)
+                {
+                    median[cnt++] = p[i];
+                }
+            }
+
+            // Store the result
+            setUint8Pixel(dst,x,y,(n == 3) ? getMedian9(median) : getMedian25(median));
+        }
+    }
+
+    // Border pixels: only the pixels within the image are part of the window
     for(int32_t y=0; y<src->rows; y++)
     {
-        for(int32_t x=0; x<src->cols; x++)
+        for(int32_t x=nextBorderColumn(src,-1,y,r); x<src->cols; x=nextBorderColumn(src,x,y,r))
         {
             // Initialize filter specific variables
             uint32_t cnt = 0;
@@ -345,34 +996,8 @@ void median(const image_t *src, image_t *dst, const uint8_t n)
                 }
             }
 
-            // Use the 'Insertion sort' algorithm to sort the median values
-            // Loop through all elements, starting at second
-            for(uint32_t i=1; i<cnt; i++)
-            {
-                // Copy the element
-                uint8_pixel_t a = median[i];
-
-                // Move 'backwards' and shift all values bigger then the current
-                // value to the next position in the array
-                uint32_t j;
-                for(j=i; j>0 && median[j-1] > a; j--){ median[j] = median[j-1]; }
-
-                // Insert current element at this position in the array
-                median[j] = a;
-            }
-
-            // Check if there is an even number of pixels.
-            // This might be the case for border pixels.
-            if((cnt%2) == 0)
-            {
-                // Store the result
-                setUint8Pixel(dst,x,y,(median[(cnt/2) - 1] + median[cnt/2]) / 2.0f + 0.5f);
-            }
-            else
-            {
-                // Store the result
-                setUint8Pixel(dst,x,y,median[cnt/2]);
-            }
+            // Store the result
+            setUint8Pixel(dst,x,y,getMedian(median, cnt));
         }
     }
 }
@@ -403,37 +1028,33 @@ void midpoint(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for(int32_t y=0; y<src->rows; y++)
-    {
-        for(int32_t x=0; x<src->cols; x++)
-        {
-            // Initialize filter specific variables
-            uint8_pixel_t min = UINT8_PIXEL_MAX;
-            uint8_pixel_t max = UINT8_PIXEL_MIN;
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t dstStride = IMAGE_STRIDE(dst);
 
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
-            {
-                for(int32_t i=-n/2; i<=n/2; i++)
-                {
-                    if((x+i) >= 0 &&
-                        (y+j) >= 0 &&
-                        (x+i) <  src->cols &&
-                        (y+j) <  src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src,x+i,y+j);
-                        min = p < min ? p : min;
-                        max = p > max ? p : max;
-                    }
-                }
-            }
+    image_t *min = newUint8Image(cols, rows);
+    image_t *max = newUint8Image(cols, rows);
+    ASSERT((min == NULL) || (max == NULL), "unable to allocate memory");
+
+    // Pixels outside the image are not part of the window. The minimum and
+    // maximum are computed in the same pass.
+    minMaxFilter(src, min, max, n/2);
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        const uint8_pixel_t *pMin = min->data + (y * cols);
+        const uint8_pixel_t *pMax = max->data + (y * cols);
+        uint8_pixel_t *d = dst->data + (y * dstStride);
 
+        for(int32_t x=0; x<cols; x++)
+        {
             // Calculate and store the result
-            setUint8Pixel(dst,x,y,((min + max)/2.0f) + 0.5f);
+            d[x] = (uint8_pixel_t)((pMin[x] + pMax[x] + 1) / 2);
         }
     }
+
+    deleteImage(max);
+    deleteImage(min);
 }
 
 /*!
@@ -461,35 +1082,8 @@ void minimum(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for(int32_t y=0; y<src->rows; y++)
-    {
-        for(int32_t x=0; x<src->cols; x++)
-        {
-            // Initialize filter specific variables
-            uint8_pixel_t min = UINT8_PIXEL_MAX;
-
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
-            {
-                for(int32_t i=-n/2; i<=n/2; i++)
-                {
-                    if((x+i) >= 0 &&
-                        (y+j) >= 0 &&
-                        (x+i) <  src->cols &&
-                        (y+j) <  src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src,x+i,y+j);
-                        min = p < min ? p : min;
-                    }
-                }
-            }
-
-            // Calculate and store the result
-            setUint8Pixel(dst,x,y,min);
-        }
-    }
+    // Pixels outside the image are not part of the window
+    minMaxFilter(src, dst, NULL, n/2);
 }
 
 /*!
@@ -517,35 +1111,31 @@ void range(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n%2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for(int32_t y=0; y<src->rows; y++)
-    {
-        for(int32_t x=0; x<src->cols; x++)
-        {
-            // Initialize filter specific variables
-            uint8_pixel_t min = UINT8_PIXEL_MAX;
-            uint8_pixel_t max = UINT8_PIXEL_MIN;
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t dstStride = IMAGE_STRIDE(dst);
 
-            // Apply the kernel only for pixels within the image
-            for(int32_t j=-n/2; j<=n/2; j++)
-            {
-                for(int32_t i=-n/2; i<=n/2; i++)
-                {
-                    if((x+i) >= 0 &&
-                        (y+j) >= 0 &&
-                        (x+i) <  src->cols &&
-                        (y+j) <  src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src,x+i,y+j);
-                        min = p < min ? p : min;
-                        max = p > max ? p : max;
-                    }
-                }
-            }
+    image_t *min = newUint8Image(cols, rows);
+    image_t *max = newUint8Image(cols, rows);
+    ASSERT((min == NULL) || (max == NULL), "unable to allocate memory");
+
+    // Pixels outside the image are not part of the window. The minimum and
+    // maximum are computed in the same pass.
+    minMaxFilter(src, min, max, n/2);
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        const uint8_pixel_t *pMin = min->data + (y * cols);
+        const uint8_pixel_t *pMax = max->data + (y * cols);
+        uint8_pixel_t *d = dst->data + (y * dstStride);
 
+        for(int32_t x=0; x<cols; x++)
+        {
             // Calculate and store the result
-            setUint8Pixel(dst,x,y,max - min);
+            d[x] = pMax[x] - pMin[x];
         }
     }
+
+    deleteImage(max);
+    deleteImage(min);
 }
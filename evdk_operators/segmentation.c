@@ -42,6 +42,9 @@
 #include "image_fundamentals.h"
 #include "segmentation.h"
 
+#include <math.h>
+#include <string.h>
+
 /*!
  * \brief Separates object from background
  *
@@ -53,6 +56,8 @@
  * \n
  * The object values are set to 1.
  * The background values are set to 0.
+ * Uint8 destinations are mapped with lutThreshold(). If the destination is an
+ * IMGTYPE_BIN1 image, the result is packed directly into bits.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
@@ -67,69 +72,75 @@ void threshold(const image_t *src, image_t *dst,
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
-
-    // Loop all pixels and set to 1 if the pixel is within thresholding window
-    while(i-- > 0)
+    if(dst->type == IMGTYPE_BIN1)
     {
-        uint8_pixel_t pixel = *s++;
-        *d++ = ((pixel >= min) && (pixel <= max)) ? 1 : 0;
+        for(int32_t y=0; y<src->rows; y++)
+        {
+            const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+            bin1_word_t *d = (bin1_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / 64));
+
+            for(int32_t x=0; x<src->cols; x+=64)
+            {
+                bin1_word_t w = 0;
+                int32_t n = ((src->cols - x) < 64) ? (src->cols - x) : 64;
+
+                for(int32_t i=0; i<n; i++)
+                {
+                    uint8_pixel_t pixel = s[x + i];
+                    w |= (bin1_word_t)((pixel >= min) && (pixel <= max)) << i;
+                }
+
+                d[x / 64] = w;
+            }
+        }
+
+        return;
     }
+
+    // Set to 1 if the pixel is within thresholding window
+    lut_t lut = lutThreshold(min, max);
+
+    applyLut(src, dst, lut.table);
 }
 
 /*!
- * \brief Automatic thresholding by finding the valley between the two peaks
+ * \brief Finds the valley between the two peaks of a histogram
  *
- * The function assumes that the image’s histogram has two predominant peaks.
+ * \param[in] hist1 A pointer to an array of 256 uint32_t
  *
- * \param[in]  src A pointer to the source image
- * \param[out] dst A pointer to the destination image
- * \param[in]  b   Return the bright or the BRIGHTNESS_DARK areas in the source image as
- *                 object. Must be of type ::eBrightness
+ * \return The threshold
  */
-void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
+static uint8_pixel_t optimumSearch(const uint32_t *hist1)
 {
-    // Verify image validity
-    ASSERT(src == NULL, "src image is invalid");
-    ASSERT(dst == NULL, "dst image is invalid");
-    ASSERT(src->data == NULL, "src data is invalid");
-    ASSERT(dst->data == NULL, "dst data is invalid");
-
-    // Verify image consistency
-    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
-    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
-
     int32_t y;
 
-    // Create histogram
-    uint32_t hist1[256];
     float hist2[256];
-    histogram(src, hist1);
 
-    // Apply 31x1 mean filter on the histogram
+    // Cumulative histogram, cum[i] holds the sum of the bins 0..i-1
+    uint32_t cum[257];
+
+    cum[0] = 0;
+
     for(y=0; y<256; y++)
     {
-        uint32_t sum = 0.0f;
-        uint32_t cnt = 0;
+        cum[y + 1] = cum[y] + hist1[y];
+    }
 
-        for(int32_t x=-15; x<=15; ++x)
-        {
-            // Is the calculated index valid?
-            int32_t index = y+x;
+    // Apply 31x1 mean filter on the histogram, each window sum is the
+    // difference of two cumulative values
+    for(y=0; y<256; y++)
+    {
+        int32_t first = (y - 15 < 0) ? 0 : (y - 15);
+        int32_t last = (y + 15 > 255) ? 255 : (y + 15);
 
-            if((index >= 0) && (index <= 255))
-            {
-                ++cnt;
-                sum += hist1[index];
-            }
-        }
+        uint32_t sum = cum[last + 1] - cum[first];
+        uint32_t cnt = last - first + 1;
 
         hist2[y] = (float)sum / (float)cnt;
     }
@@ -158,11 +169,48 @@ void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
         ++y;
     }
 
+    return t;
+}
+
+/*!
+ * \brief Automatic thresholding by finding the valley between the two peaks
+ *
+ * The function assumes that the image’s histogram has two predominant peaks.
+ * The histogram is smoothed with a 31x1 mean filter using a cumulative
+ * histogram, so the cost does not depend on the filter size.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  b   Return the bright or the BRIGHTNESS_DARK areas in the source image as
+ *                 object. Must be of type ::eBrightness
+ *
+ * \return The threshold
+ */
+uint8_pixel_t thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    // Create histogram
+    uint32_t hist[256];
+    histogram(src, hist);
+
+    uint8_pixel_t t = optimumSearch(hist);
+
     // Threshold the image
     if(b == BRIGHTNESS_DARK)
         threshold(src, dst, 0, t);
     else
         threshold(src, dst, t, 255);
+
+    return t;
 }
 
 /*!
@@ -170,23 +218,33 @@ void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
  *        pixels
  *
  * Uses the iterative K-means algorithm to minimize the overlap between the
- * graylevel object and background.
+ * graylevel object and background. The image is read once to create the
+ * histogram. The number and sum of the pixels in the first cluster are kept
+ * while the threshold moves, so each iteration only reads the histogram bins
+ * between the previous and the new threshold.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  b   Return the bright or the BRIGHTNESS_DARK areas in the source image as
  *                 object. Must be of type ::eBrightness
  *
- * \todo Implement this function
+ * \return The converged threshold
  */
-void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
+uint8_pixel_t threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
 {
-    // Init pointers
-    uint8_t *sourcePixel = (uint8_t *)src->data;
-    uint8_t *destinationPixel = (uint8_t *)dst->data;
-    uint32_t pixelAmount = src->cols * src->rows;
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     // Init variables
+    uint32_t pixelAmount = src->cols * src->rows;
+
     uint32_t newThreshold = 0;
     uint32_t maxIterations = 32;
     uint32_t iteration = 0;
@@ -195,45 +253,42 @@ void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
     float mean2 = 255.0f;
 
     // Calculate an initial threshold guess
-    uint32_t pixelSum = 0;
+    uint32_t hist[256];
+    histogramStats_t stats = histogramStats(src, NULL, hist);
 
-    for (uint32_t i = 0; i < pixelAmount; i++)
-    {
-        pixelSum += sourcePixel[i];
-    }
+    uint32_t currentThreshold = (uint32_t)(stats.sum / pixelAmount);
 
-    uint32_t threshold = pixelSum / pixelAmount;
+    // Number and sum of the pixels with a value below bound
+    uint32_t bound = 0;
+    uint32_t count1 = 0;
+    uint64_t sum1 = 0;
 
     // Loop until the threshold are the same for two runs, or until max iterations
     while (iteration < maxIterations)
     {
-        uint32_t sum1 = 0;
-        uint32_t sum2 = 0;
-        uint32_t count1 = 0;
-        uint32_t count2 = 0;
-
-        // Partition pixels into two clusters
-        for (uint32_t i = 0; i < pixelAmount; i++)
+        // Partition pixels into two clusters, the first up to and including
+        // the threshold
+        while(bound <= currentThreshold)
         {
-            // printf("pixel %d has value %d\n", i, sourcePixel[i]);
-            // printf("threshold is now: %d\n", threshold);
+            count1 += hist[bound];
+            sum1 += (uint64_t)bound * hist[bound];
+            bound++;
+        }
 
-            if (sourcePixel[i] <= threshold)
-            {
-                sum1 += sourcePixel[i];
-                count1++;
-            }
-            else
-            {
-                sum2 += sourcePixel[i];
-                count2++;
-            }
+        while(bound > (currentThreshold + 1))
+        {
+            bound--;
+            count1 -= hist[bound];
+            sum1 -= (uint64_t)bound * hist[bound];
         }
 
+        uint32_t count2 = stats.count - count1;
+        uint64_t sum2 = stats.sum - sum1;
+
         // Calculate means for both clusters
         if (count1 == 0)
         {
-            mean1 = (float)threshold;
+            mean1 = (float)currentThreshold;
         }
         else
         {
@@ -242,7 +297,7 @@ void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
 
         if (count2 == 0)
         {
-            mean2 = (float)threshold;
+            mean2 = (float)currentThreshold;
         }
         else
         {
@@ -252,10 +307,8 @@ void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
         // Calculate new threshold
         newThreshold = (uint32_t)((mean1 + mean2) / 2.0f);
 
-        // printf("count1: %03d\tcount2: %03d\tmean1: %0f\tmean2: %0f\tthreshold: %03d\tnewThreshold: %03d\n", count1, count2, mean1, mean2, threshold, newThreshold);
-
         // Check if threshold has been the same for 2 runs
-        if (newThreshold == threshold)
+        if (newThreshold == currentThreshold)
         {
             consecutiveMatches++;
             if (consecutiveMatches == 2)
@@ -268,66 +321,39 @@ void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
             consecutiveMatches = 0;
         }
 
-        threshold = newThreshold;
+        currentThreshold = newThreshold;
 
         iteration++;
     }
 
     // Apply the threshold to destination image
-    for (uint32_t i = 0; i < pixelAmount; i++)
+    if (b == BRIGHTNESS_DARK)
     {
-        if (b == BRIGHTNESS_DARK)
-        {
-            // For dark objects, set pixels below threshold to 1
-            if (sourcePixel[i] <= threshold)
-            {
-                destinationPixel[i] = 1;
-            }
-            else
-            {
-                destinationPixel[i] = 0;
-            }
-        }
-        else
-        {
-            // For bright objects, set pixels above threshold to 1
-            if (sourcePixel[i] >= threshold)
-            {
-                destinationPixel[i] = 1;
-            }
-            else
-            {
-                destinationPixel[i] = 0;
-            }
-        }
+        // For dark objects, set pixels below threshold to 1
+        threshold(src, dst, 0, currentThreshold);
     }
+    else
+    {
+        // For bright objects, set pixels above threshold to 1
+        threshold(src, dst, currentThreshold, 255);
+    }
+
+    return currentThreshold;
 }
 
 /*!
- * \brief Automatic thresholding using Otsu's method
+ * \brief Finds the threshold with the highest between class variance
  *
- * Otsu's method assumes that the histogram shows two clusters and that these
- * clusters are normal distributions. The threshold with the two ‘best’ normal
- * distributions gives the optimum threshold. The two ‘best’ normal
- * distributions have the lowest sum of variances. Or, as stated by Otsu:
- * "The Between Class Variance (BCV) is as high as possible".
+ * \param[in] hist        A pointer to an array of 256 uint32_t
+ * \param[in] pixelAmount The number of pixels in the histogram
+ * \param[in] pixelSum    The sum of the pixel values in the histogram
  *
- * \param[in]  src A pointer to the source image
- * \param[out] dst A pointer to the destination image
- * \param[in]  b   Return the bright or the BRIGHTNESS_DARK areas in the source image as
- *                 object. Must be of type ::eBrightness
- *
- * \todo Implement this function
+ * \return The threshold
  */
-void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
+static uint8_pixel_t otsuSearch(const uint32_t *hist, const uint32_t pixelAmount,
+                                const uint32_t pixelSum)
 {
-    // Init variables and pointers
-    uint8_pixel_t *sourcePixel = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *destinationPixel = (uint8_pixel_t *)dst->data;
-
-    uint32_t histogram[256] = {0};
-    uint32_t pixelAmount = src->rows * src->cols;
-    uint32_t pixelSum = 0;
+    // Init variables
     uint32_t backgroundSum = 0;
     uint32_t backgroundWeight = 0;
     uint32_t foregroundWeight = 0;
@@ -335,23 +361,16 @@ void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
     float maxVariance = 0.0;
     uint8_pixel_t optimalThreshold = 0;
 
-    // Calculate histogram and sum of all pixel values
-    for (uint32_t i = 0; i < pixelAmount; i++)
-    {
-        pixelSum += sourcePixel[i];
-        histogram[sourcePixel[i]]++;
-    }
-
     // Check all possible thresholds (0-255)
     for (uint32_t threshold = 0; threshold < 256; threshold++)
     {
         // Calculate weights
-        backgroundWeight += histogram[threshold];
+        backgroundWeight += hist[threshold];
 
         foregroundWeight = pixelAmount - backgroundWeight;
 
         // Update background sum
-        backgroundSum += threshold * histogram[threshold];
+        backgroundSum += threshold * hist[threshold];
 
         // Calculate mean values for background and foreground
         float meanBackground = (float)backgroundSum / backgroundWeight;
@@ -369,40 +388,517 @@ void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
         }
     }
 
+    return optimalThreshold;
+}
+
+/*!
+ * \brief Automatic thresholding using Otsu's method
+ *
+ * Otsu's method assumes that the histogram shows two clusters and that these
+ * clusters are normal distributions. The threshold with the two ‘best’ normal
+ * distributions gives the optimum threshold. The two ‘best’ normal
+ * distributions have the lowest sum of variances. Or, as stated by Otsu:
+ * "The Between Class Variance (BCV) is as high as possible".
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  b   Return the bright or the BRIGHTNESS_DARK areas in the source image as
+ *                 object. Must be of type ::eBrightness
+ *
+ * \return The threshold
+ */
+uint8_pixel_t thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
+{
+    // Calculate histogram and sum of all pixel values in a single pass
+    uint32_t hist[256];
+    histogramStats_t stats = histogramStats(src, NULL, hist);
+
+    uint8_pixel_t optimalThreshold = otsuSearch(hist, stats.count, (uint32_t)stats.sum);
+
     // Apply the threshold to destination image
-    for (uint32_t i = 0; i < pixelAmount; i++)
+    if (b == BRIGHTNESS_DARK)
+    {
+        // For dark objects, set pixels below threshold to 1 (white)
+        threshold(src, dst, 0, optimalThreshold);
+    }
+    else
+    {
+        // For bright objects, set pixels above threshold to 1 (white)
+        threshold(src, dst, optimalThreshold, 255);
+    }
+
+    return optimalThreshold;
+}
+
+/*!
+ * \brief Multi-level thresholding using Otsu's method
+ *
+ * The histogram is divided into \p n + 1 classes by \p n thresholds, such that
+ * the between class variance is as high as possible. This is the same as
+ * maximizing the sum of S_c^2 / P_c over the classes c, where P_c is the
+ * fraction of the pixels in class c and S_c the sum of their values divided
+ * by the number of pixels.
+ *
+ * Trying all combinations of thresholds takes O(256^n) steps. With the
+ * cumulative tables of P and S, the sum of a class is found in one step and
+ * the best thresholds are found by dynamic programming in O(n * 256^2) steps:
+ * the best division of the bins 0..j into c + 1 classes is the best division
+ * of 0..i into c classes plus the class i+1..j, for the best i.
+ *
+ * The destination image is a label image. Pixels with a value up to and
+ * including thresholds[0] get label 0, pixels above thresholds[n-1] get label
+ * \p n. The source and destination image may be the same image.
+ *
+ * \param[in]  src        A pointer to the source image
+ * \param[out] dst        A pointer to the destination image
+ * \param[out] thresholds A pointer to an array of \p n thresholds, sorted
+ *                        from low to high
+ * \param[in]  n          The number of thresholds, 1 to OTSU_MAX_THRESHOLDS
+ */
+void thresholdMultiOtsu(const image_t *src, image_t *dst,
+                        uint8_pixel_t *thresholds, const uint32_t n)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    // Verify parameters
+    ASSERT(thresholds == NULL, "thresholds is invalid");
+    ASSERT((n == 0) || (n > OTSU_MAX_THRESHOLDS), "n is invalid");
+
+    uint32_t hist[256];
+    histogramStats_t stats = histogramStats(src, NULL, hist);
+
+    // The tables are allocated from the image pool to keep them off the stack
+    image_t *tables = newFloatImage(257, 3);
+    image_t *splits = newUint8Image(256, OTSU_MAX_THRESHOLDS + 1);
+    ASSERT((tables == NULL) || (splits == NULL), "unable to allocate memory for the tables");
+
+    // Cumulative tables, P[j] and S[j] cover the bins 0..j-1
+    float_pixel_t *P = (float_pixel_t *)tables->data;
+    float_pixel_t *S = P + 257;
+
+    P[0] = 0.0f;
+    S[0] = 0.0f;
+
+    for(uint32_t j=0; j<256; ++j)
+    {
+        P[j + 1] = P[j] + ((float)hist[j] / (float)stats.count);
+        S[j + 1] = S[j] + (((float)j * (float)hist[j]) / (float)stats.count);
+    }
+
+    // best[j] is the highest sum for the bins 0..j divided into c + 1 classes,
+    // split[c * 256 + j] the last bin of the first c classes of that division
+    float_pixel_t *best = S + 257;
+    uint8_pixel_t *split = (uint8_pixel_t *)splits->data;
+
+    for(uint32_t j=0; j<256; ++j)
     {
-        if (b == BRIGHTNESS_DARK)
+        best[j] = (P[j + 1] > 0.0f) ? ((S[j + 1] * S[j + 1]) / P[j + 1]) : 0.0f;
+    }
+
+    for(uint32_t c=1; c<=n; ++c)
+    {
+        // Only the last bin is needed for the last class
+        uint32_t first = (c == n) ? 255 : c;
+
+        // From high to low, so best[i] for i < j still holds the division
+        // into c classes
+        for(uint32_t j=255; j>=first; --j)
         {
-            // For dark objects, set pixels below threshold to 1 (white)
-            if (sourcePixel[i] <= optimalThreshold)
-            {
-                destinationPixel[i] = 1;
-            }
-            else
+            float max = -1.0f;
+
+            for(uint32_t i=(c - 1); i<j; ++i)
             {
-                destinationPixel[i] = 0;
+                float w = P[j + 1] - P[i + 1];
+                float m = S[j + 1] - S[i + 1];
+                float v = best[i] + ((w > 0.0f) ? ((m * m) / w) : 0.0f);
+
+                if(v > max)
+                {
+                    max = v;
+                    split[(c * 256) + j] = i;
+                }
             }
+
+            best[j] = max;
         }
-        else
+    }
+
+    // Trace the thresholds back from the last bin
+    uint32_t j = 255;
+
+    for(uint32_t c=n; c>0; --c)
+    {
+        j = split[(c * 256) + j];
+        thresholds[c - 1] = j;
+    }
+
+    deleteImage(splits);
+    deleteImage(tables);
+
+    // Label the pixels with a lookup table
+    uint8_pixel_t lut[256];
+    uint32_t label = 0;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        lut[i] = label;
+
+        if((label < n) && (i == thresholds[label]))
+        {
+            ++label;
+        }
+    }
+
+    applyLut(src, dst, lut);
+}
+
+/*!
+ * \brief Creates the scratch buffers of thresholdAdaptive()
+ *
+ * Use deleteAdaptiveBuffers() to free the buffers.
+ *
+ * \param[in] cols Number of columns of the images to process
+ * \param[in] rows Number of rows of the images to process
+ *
+ * \return The scratch buffers
+ */
+adaptiveBuffers_t newAdaptiveBuffers(const uint32_t cols, const uint32_t rows)
+{
+    adaptiveBuffers_t buffers =
+    {
+        .cols       = cols,
+        .rows       = rows,
+        .integral   = newInt32Image(cols + 1, rows + 1),
+        .integralSq = newInt64Image(cols + 1, rows + 1),
+    };
+
+    ASSERT((buffers.integral == NULL) || (buffers.integralSq == NULL),
+           "unable to allocate memory for the buffers");
+
+    return buffers;
+}
+
+/*!
+ * \brief Deletes the scratch buffers of thresholdAdaptive()
+ *
+ * \param[in,out] buffers A pointer to the scratch buffers
+ */
+void deleteAdaptiveBuffers(adaptiveBuffers_t *buffers)
+{
+    deleteImage(buffers->integralSq);
+    deleteImage(buffers->integral);
+
+    memset(buffers, 0, sizeof(adaptiveBuffers_t));
+}
+
+/*!
+ * \brief Automatic thresholding with a threshold per pixel
+ *
+ * The global thresholds fail when the lighting is uneven. This function
+ * calculates a threshold for each pixel from the mean m and the standard
+ * deviation s of the \p size x \p size window around it, see ::eAdaptiveMethod.
+ * Near the border, the window only covers the pixels inside the image.
+ *
+ * m and s are found with integral images, so the time per pixel does not
+ * depend on the size of the window. The integral image of the squared pixels
+ * is 64-bit, so the variance is exact for any window size. ADAPTIVE_BRADLEY
+ * only needs the mean and skips the integral image of the squared pixels.
+ *
+ * For dark objects, a pixel is set to 1 if its value is at most the
+ * threshold. For bright objects, the formulas are applied to the inverted
+ * image, so \p k moves the threshold from the mean towards the objects for
+ * both. Typical values of \p k are 0.2 for ADAPTIVE_NIBLACK, 0.34 for
+ * ADAPTIVE_SAUVOLA and 0.15 for ADAPTIVE_BRADLEY.
+ *
+ * \param[in]  src     A pointer to the source image
+ * \param[out] dst     A pointer to the destination image
+ * \param[in]  b       Return the bright or the dark areas in the source image
+ *                     as object. Must be of type ::eBrightness
+ * \param[in]  method  The formula of the threshold. Must be of type
+ *                     ::eAdaptiveMethod
+ * \param[in]  size    The width and height of the window. Must be odd.
+ * \param[in]  k       The weight of the standard deviation or the mean
+ * \param[in]  buffers A pointer to scratch buffers created by
+ *                     newAdaptiveBuffers() for the size of \p src. If this
+ *                     is a NULL pointer, the buffers are created and
+ *                     deleted by this function.
+ */
+void thresholdAdaptive(const image_t *src, image_t *dst, const eBrightness b,
+                       const eAdaptiveMethod method, const uint32_t size,
+                       const float k, adaptiveBuffers_t *buffers)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    // Verify parameters
+    ASSERT((size % 2) == 0, "size must be odd");
+    ASSERT((method != ADAPTIVE_NIBLACK) && (method != ADAPTIVE_SAUVOLA) &&
+           (method != ADAPTIVE_BRADLEY), "method is invalid");
+
+    adaptiveBuffers_t tmp;
+    adaptiveBuffers_t *buf = buffers;
+
+    if(buf == NULL)
+    {
+        tmp = newAdaptiveBuffers(src->cols, src->rows);
+        buf = &tmp;
+    }
+
+    ASSERT((buf->cols != src->cols) || (buf->rows != src->rows), "buffers have a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t r = size / 2;
+    const int32_t stride = IMAGE_STRIDE(buf->integral);
+    const int32_t needSq = (method != ADAPTIVE_BRADLEY);
+    const int32_t bright = (b == BRIGHTNESS_BRIGHT);
+
+    integralImage(src, buf->integral);
+
+    if(needSq)
+    {
+        integralSquaredImage(src, buf->integralSq);
+    }
+
+    for(int32_t y=0; y<rows; ++y)
+    {
+        const int32_t y0 = (y - r < 0) ? 0 : (y - r);
+        const int32_t y1 = (y + r + 1 > rows) ? rows : (y + r + 1);
+
+        // Unsigned arithmetic cancels any wrap around of the integral values
+        const uint32_t *top = (uint32_t *)buf->integral->data + (y0 * stride);
+        const uint32_t *bottom = (uint32_t *)buf->integral->data + (y1 * stride);
+
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        for(int32_t x=0; x<cols; ++x)
         {
-            // For bright objects, set pixels above threshold to 1 (white)
-            if (sourcePixel[i] >= optimalThreshold)
+            const int32_t x0 = (x - r < 0) ? 0 : (x - r);
+            const int32_t x1 = (x + r + 1 > cols) ? cols : (x + r + 1);
+            const int32_t n = (x1 - x0) * (y1 - y0);
+            const uint32_t sum = bottom[x1] - bottom[x0] - top[x1] + top[x0];
+
+            // Bright objects are dark objects of the inverted image
+            const float m = (float)(bright ? ((255 * n) - sum) : sum) / (float)n;
+            const float p = (float)(bright ? (255 - s[x]) : s[x]);
+            float t;
+
+            if(method == ADAPTIVE_BRADLEY)
             {
-                destinationPixel[i] = 1;
+                t = m * (1.0f - k);
             }
             else
             {
-                destinationPixel[i] = 0;
+                // n^2 times the variance, exact in integers. The variance
+                // does not change when the image is inverted.
+                const int64_t sumSq = integralRectSum(buf->integralSq, x0, y0, x1 - x0, y1 - y0);
+                const int64_t var = (n * sumSq) - ((int64_t)sum * sum);
+                const float sd = sqrtf((float)var) / (float)n;
+
+                if(method == ADAPTIVE_NIBLACK)
+                {
+                    t = m - (k * sd);
+                }
+                else
+                {
+                    t = m * (1.0f + (k * ((sd / 128.0f) - 1.0f)));
+                }
             }
+
+            d[x] = (p <= t) ? 1 : 0;
         }
     }
+
+    if(buffers == NULL)
+    {
+        deleteAdaptiveBuffers(&tmp);
+    }
+}
+
+/*!
+ * \brief Creates the state of thresholdTracked()
+ *
+ * \param[in] method     The method that searches the threshold. Must be of
+ *                       type ::eThresholdMethod
+ * \param[in] step       Only every step-th pixel of every step-th row is
+ *                       counted. 1 counts all pixels, 2 a quarter of them.
+ * \param[in] smoothing  Weight (0-1] of a newly found threshold. 1 uses the
+ *                       new threshold immediately, smaller values suppress
+ *                       flicker.
+ * \param[in] driftLimit Fraction (0-1) of the pixels that must have moved to
+ *                       another histogram bin, since the last search, before
+ *                       the threshold is searched again. 0 searches every
+ *                       frame.
+ *
+ * \return The initial state
+ */
+thresholdTracker_t newThresholdTracker(const eThresholdMethod method,
+                                       const uint32_t step,
+                                       const float smoothing,
+                                       const float driftLimit)
+{
+    // Verify parameters
+    ASSERT((method != THRESHOLD_OTSU) && (method != THRESHOLD_OPTIMUM), "method is invalid");
+    ASSERT(step == 0, "step is invalid");
+    ASSERT((smoothing <= 0.0f) || (smoothing > 1.0f), "smoothing is invalid");
+    ASSERT((driftLimit < 0.0f) || (driftLimit >= 1.0f), "driftLimit is invalid");
+
+    thresholdTracker_t tracker =
+    {
+        .method     = method,
+        .step       = step,
+        .smoothing  = smoothing,
+        .driftLimit = driftLimit,
+        .searches   = 0,
+        .found      = 0,
+        .threshold  = 0.0f,
+    };
+
+    memset(tracker.reference, 0, sizeof(tracker.reference));
+
+    return tracker;
+}
+
+/*!
+ * \brief Automatic thresholding of a video frame, using the threshold of
+ *        previous frames
+ *
+ * Consecutive video frames have nearly the same histogram, so searching the
+ * threshold in every frame costs time and makes the threshold flicker. This
+ * function creates the histogram of a grid of pixels, see
+ * newThresholdTracker(), and compares it with the histogram of the frame in
+ * which the threshold was last searched. Only if more than the drift limit
+ * of the pixels moved to another bin is the threshold searched again.
+ * Every frame, the applied threshold moves towards the last search result by
+ * the smoothing factor.
+ *
+ * \param[in]     src     A pointer to the source image
+ * \param[out]    dst     A pointer to the destination image
+ * \param[in]     b       Return the bright or the dark areas in the source
+ *                        image as object. Must be of type ::eBrightness
+ * \param[in,out] tracker A pointer to the state created by
+ *                        newThresholdTracker()
+ *
+ * \return The threshold that is applied
+ */
+uint8_pixel_t thresholdTracked(const image_t *src, image_t *dst,
+                               const eBrightness b, thresholdTracker_t *tracker)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    // Verify state validity
+    ASSERT(tracker == NULL, "tracker is invalid");
+
+    uint32_t hist[256];
+    const uint32_t step = tracker->step;
+
+    // Create the histogram of the grid of pixels
+    if(step == 1)
+    {
+        histogram(src, hist);
+    }
+    else
+    {
+        memset(hist, 0, sizeof(hist));
+
+        for(int32_t y=0; y<src->rows; y+=step)
+        {
+            const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+
+            for(int32_t x=0; x<src->cols; x+=step)
+            {
+                hist[s[x]]++;
+            }
+        }
+    }
+
+    uint32_t count = 0;
+    uint64_t sum = 0;
+    uint32_t moved = 0;
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        count += hist[i];
+        sum += (uint64_t)i * hist[i];
+        moved += (hist[i] > tracker->reference[i]) ?
+                 (hist[i] - tracker->reference[i]) : (tracker->reference[i] - hist[i]);
+    }
+
+    // Each pixel that moved to another bin is counted twice
+    const float drift = (float)moved / (float)(2 * count);
+
+    if((tracker->searches == 0) || (drift > tracker->driftLimit))
+    {
+        if(tracker->method == THRESHOLD_OTSU)
+        {
+            tracker->found = otsuSearch(hist, count, (uint32_t)sum);
+        }
+        else
+        {
+            tracker->found = optimumSearch(hist);
+        }
+
+        if(tracker->searches == 0)
+        {
+            tracker->threshold = tracker->found;
+        }
+
+        memcpy(tracker->reference, hist, sizeof(hist));
+        tracker->searches++;
+    }
+
+    tracker->threshold += tracker->smoothing * ((float)tracker->found - tracker->threshold);
+
+    uint8_pixel_t t = (uint8_pixel_t)(tracker->threshold + 0.5f);
+
+    if(b == BRIGHTNESS_DARK)
+    {
+        threshold(src, dst, 0, t);
+    }
+    else
+    {
+        threshold(src, dst, t, 255);
+    }
+
+    return t;
 }
 
 /*!
  * \brief For finding line discontinuities within an image
  *
- * This function is a spatial filter of the source image with a 3x3 mask.
+ * This function is a spatial filter of the source image with a 3x3 mask. It
+ * marks line pixels, but does not give the line parameters. Use houghLines()
+ * to find the equations of straight lines.
  * Use the following masks for finding lines in specific directions:
  *
  * <table>
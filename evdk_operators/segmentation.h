@@ -41,13 +41,56 @@ extern "C" {
 
 #include "image.h"
 
+/// Maximum number of thresholds of thresholdMultiOtsu()
+#define OTSU_MAX_THRESHOLDS (4)
+
+/// Scratch buffers of thresholdAdaptive()
+typedef struct
+{
+    int32_t  cols;       ///< Number of columns of the source image
+    int32_t  rows;       ///< Number of rows of the source image
+    image_t *integral;   ///< Integral image of the source image
+    image_t *integralSq; ///< 64-bit integral image of the squared source image
+
+}adaptiveBuffers_t;
+
+/// State of thresholdTracked() that is kept from one video frame to the next
+typedef struct
+{
+    eThresholdMethod method;         ///< Method that searches the threshold
+    uint32_t         step;           ///< Only every step-th pixel of every
+                                     ///< step-th row is counted
+    float            smoothing;      ///< Weight (0-1] of a new threshold
+    float            driftLimit;     ///< Fraction of the pixels that must move
+                                     ///< to another bin before the threshold
+                                     ///< is searched again
+    uint32_t         reference[256]; ///< Histogram at the last search
+    uint32_t         searches;       ///< Number of searches done
+    uint8_pixel_t    found;          ///< Threshold found by the last search
+    float            threshold;      ///< Smoothed threshold
+
+}thresholdTracker_t;
+
 // Functions are documented in the source file
 
 void threshold(const image_t *src, image_t *dst,
                const uint8_pixel_t min, const uint8_pixel_t max);
-void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b);
-void threshold2Means(const image_t *src, image_t *dst, const eBrightness b);
-void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b);
+uint8_pixel_t thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b);
+uint8_pixel_t threshold2Means(const image_t *src, image_t *dst, const eBrightness b);
+uint8_pixel_t thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b);
+void thresholdMultiOtsu(const image_t *src, image_t *dst,
+                        uint8_pixel_t *thresholds, const uint32_t n);
+adaptiveBuffers_t newAdaptiveBuffers(const uint32_t cols, const uint32_t rows);
+void deleteAdaptiveBuffers(adaptiveBuffers_t *buffers);
+void thresholdAdaptive(const image_t *src, image_t *dst, const eBrightness b,
+                       const eAdaptiveMethod method, const uint32_t size,
+                       const float k, adaptiveBuffers_t *buffers);
+thresholdTracker_t newThresholdTracker(const eThresholdMethod method,
+                                       const uint32_t step,
+                                       const float smoothing,
+                                       const float driftLimit);
+uint8_pixel_t thresholdTracked(const image_t *src, image_t *dst,
+                               const eBrightness b, thresholdTracker_t *tracker);
 void lineDetector(const image_t *src, image_t *dst, int16_t mask[][3]);
 
 #endif // _SEGMENTATION_H_
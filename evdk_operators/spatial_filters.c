@@ -38,6 +38,7 @@
 #include "spatial_filters.h"
 
 #include <math.h>
+#include <string.h>
 
 /*!
  * \brief Applies a 3x3 Gaussian filter
@@ -62,24 +63,13 @@ void gaussianFilter_3x3(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Define mask
-    int16_pixel_t msk_data[3 * 3] =
-        {
-            1,2,1,
-            2,4,2,
-            1,2,1,
-        };
-
-    // Create the mask image
-    image_t msk =
-        {
-            .cols=3,
-            .rows=3,
-            .type=IMGTYPE_INT16,
-            .data=(uint8_t *)msk_data,
-        };
+    // Define kernel. The mask is the outer product of the kernel with itself:
+    //   1 2 1
+    //   2 4 2
+    //   1 2 1
+    const int16_t kernel[3] = {1,2,1};
 
-    convolve(src, dst, &msk);
+    convolveSeparable(src, dst, kernel, kernel, 3, 0, BORDER_CONSTANT);
 }
 
 /*!
@@ -105,26 +95,16 @@ void gaussianFilter_5x5(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Define mask
-    int16_pixel_t msk_data[5 * 5] =
-        {
-            1, 4, 7, 4, 1,
-            4,16,26,16, 4,
-            7,26,41,26, 7,
-            4,16,26,16, 4,
-            1, 4, 7, 4, 1,
-        };
-
-    // Create the mask image
-    image_t msk =
-        {
-            .cols=5,
-            .rows=5,
-            .type=IMGTYPE_INT16,
-            .data=(uint8_t *)msk_data,
-        };
+    // Define kernel. The mask is the outer product of the binomial kernel
+    // with itself:
+    //   1  4  6  4  1
+    //   4 16 24 16  4
+    //   6 24 36 24  6
+    //   4 16 24 16  4
+    //   1  4  6  4  1
+    const int16_t kernel[5] = {1,4,6,4,1};
 
-    convolve(src, dst, &msk);
+    convolveSeparable(src, dst, kernel, kernel, 5, 0, BORDER_CONSTANT);
 }
 
 /*!
@@ -246,6 +226,19 @@ void sobel(const image_t *src, image_t *mag, image_t *dir)
     ASSERT(src->rows != mag->rows, "src and mag have different number of rows");
     ASSERT(src == mag, "src and dst are the same images");
 
+    if(dir == NULL)
+    {
+        // Only the magnitude is needed, which is computed in a single pass
+        sobelGradient(src, mag, NULL, NORM_L1, 0);
+        return;
+    }
+
+    ASSERT(dir->data == NULL, "dir data is invalid");
+    ASSERT(dir->type != IMGTYPE_FLOAT, "dir type is invalid");
+
+    // Verify image consistency
+    ASSERT(dir->cols != mag->cols, "dir and mag have different number of columns");
+
     // Define Sobel masks
     int16_pixel_t gh_msk_data[3 * 3] =
         {
@@ -305,42 +298,19 @@ void sobel(const image_t *src, image_t *mag, image_t *dir)
     correlate(src, gv, &msk);
 
     // Loop all pixels
-    if(dir == NULL)
-    {
-        for(int32_t y=0; y<src->rows; y++)
-        {
-            for(int32_t x=0; x<src->cols; x++)
-            {
-                // Msobel = |Gh| + |Gv|
-                int16_pixel_t m = abs(getInt16Pixel(gh,x,y)) +
-                                  abs(getInt16Pixel(gv,x,y));
-                setInt16Pixel(mag,x,y,m);
-            }
-        }
-    }
-    else
+    for(int32_t y=0; y<src->rows; y++)
     {
-        ASSERT(dir == NULL, "dir image is invalid");
-        ASSERT(dir->data == NULL, "dir data is invalid");
-        ASSERT(dir->type != IMGTYPE_FLOAT, "dir type is invalid");
-
-        // Verify image consistency
-        ASSERT(dir->cols != mag->cols, "dir and mag have different number of columns");
-
-        for(int32_t y=0; y<src->rows; y++)
+        for(int32_t x=0; x<src->cols; x++)
         {
-            for(int32_t x=0; x<src->cols; x++)
-            {
-                // Msobel = |Gh| + |Gv|
-                int16_pixel_t m = abs(getInt16Pixel(gh,x,y)) +
-                                  abs(getInt16Pixel(gv,x,y));
-                setInt16Pixel(mag,x,y,m);
-
-                // PHIsobel = tan-1(Gv/Gh)
-                float_pixel_t phi = atanf(((float)getInt16Pixel(gv,x,y)) /
-                                          (float)getInt16Pixel(gh,x,y));
-                setFloatPixel(dir,x,y,phi);
-            }
+            // Msobel = |Gh| + |Gv|
+            int16_pixel_t m = abs(getInt16Pixel(gh,x,y)) +
+                              abs(getInt16Pixel(gv,x,y));
+            setInt16Pixel(mag,x,y,m);
+
+            // PHIsobel = tan-1(Gv/Gh)
+            float_pixel_t phi = atanf(((float)getInt16Pixel(gv,x,y)) /
+                                      (float)getInt16Pixel(gh,x,y));
+            setFloatPixel(dir,x,y,phi);
         }
     }
 
@@ -391,6 +361,8 @@ void sobelFast(const image_t *src, image_t *mag)
 
     uint32_t height = src->rows;
     uint32_t width = src->cols;
+    uint32_t srcStride = IMAGE_STRIDE(src);
+    uint32_t dstStride = IMAGE_STRIDE(mag);
 
     int16_t *sourcePixel = (int16_t *)src->data;
     int16_t *destinationPixel = (int16_t *)mag->data;
@@ -405,32 +377,466 @@ void sobelFast(const image_t *src, image_t *mag)
             int32_t sobelY = 0;
 
             // Calculate the offset for the current pixel
-            sobelX +=  sourcePixel[(y + 1) * width + (x + 1)] * gh_msk_data[0] +
-                       sourcePixel[(y + 1) * width + (x    )] * gh_msk_data[1] +
-                       sourcePixel[(y + 1) * width + (x - 1)] * gh_msk_data[2] +
-                       sourcePixel[(y    ) * width + (x + 1)] * gh_msk_data[3] +
-                       sourcePixel[(y    ) * width + (x    )] * gh_msk_data[4] +
-                       sourcePixel[(y    ) * width + (x - 1)] * gh_msk_data[5] +
-                       sourcePixel[(y - 1) * width + (x + 1)] * gh_msk_data[6] +
-                       sourcePixel[(y - 1) * width + (x    )] * gh_msk_data[7] +
-                       sourcePixel[(y - 1) * width + (x - 1)] * gh_msk_data[8];
-
-            sobelY +=  sourcePixel[(y + 1) * width + (x + 1)] * gv_msk_data[0] +
-                       sourcePixel[(y + 1) * width + (x    )] * gv_msk_data[1] +
-                       sourcePixel[(y + 1) * width + (x - 1)] * gv_msk_data[2] +
-                       sourcePixel[(y    ) * width + (x + 1)] * gv_msk_data[3] +
-                       sourcePixel[(y    ) * width + (x    )] * gv_msk_data[4] +
-                       sourcePixel[(y    ) * width + (x - 1)] * gv_msk_data[5] +
-                       sourcePixel[(y - 1) * width + (x + 1)] * gv_msk_data[6] +
-                       sourcePixel[(y - 1) * width + (x    )] * gv_msk_data[7] +
-                       sourcePixel[(y - 1) * width + (x - 1)] * gv_msk_data[8];
+            sobelX +=  sourcePixel[(y + 1) * srcStride + (x + 1)] * gh_msk_data[0] +
+                       sourcePixel[(y + 1) * srcStride + (x    )] * gh_msk_data[1] +
+                       sourcePixel[(y + 1) * srcStride + (x - 1)] * gh_msk_data[2] +
+                       sourcePixel[(y    ) * srcStride + (x + 1)] * gh_msk_data[3] +
+                       sourcePixel[(y    ) * srcStride + (x    )] * gh_msk_data[4] +
+                       sourcePixel[(y    ) * srcStride + (x - 1)] * gh_msk_data[5] +
+                       sourcePixel[(y - 1) * srcStride + (x + 1)] * gh_msk_data[6] +
+                       sourcePixel[(y - 1) * srcStride + (x    )] * gh_msk_data[7] +
+                       sourcePixel[(y - 1) * srcStride + (x - 1)] * gh_msk_data[8];
+
+            sobelY +=  sourcePixel[(y + 1) * srcStride + (x + 1)] * gv_msk_data[0] +
+                       sourcePixel[(y + 1) * srcStride + (x    )] * gv_msk_data[1] +
+                       sourcePixel[(y + 1) * srcStride + (x - 1)] * gv_msk_data[2] +
+                       sourcePixel[(y    ) * srcStride + (x + 1)] * gv_msk_data[3] +
+                       sourcePixel[(y    ) * srcStride + (x    )] * gv_msk_data[4] +
+                       sourcePixel[(y    ) * srcStride + (x - 1)] * gv_msk_data[5] +
+                       sourcePixel[(y - 1) * srcStride + (x + 1)] * gv_msk_data[6] +
+                       sourcePixel[(y - 1) * srcStride + (x    )] * gv_msk_data[7] +
+                       sourcePixel[(y - 1) * srcStride + (x - 1)] * gv_msk_data[8];
 
             // Calculate the magnitude
             int32_t sobelZ = abs(sobelX) + abs(sobelY);
 
             // Set the destination pixel value
-            destinationPixel[y * width + x] = (int16_t)sobelZ;
+            destinationPixel[y * dstStride + x] = (int16_t)sobelZ;
+        }
+    }
+
+}
+
+/*!
+ * \brief Arc tangent of i/64 for i=0..64 in binary angle units
+ *
+ * A full circle is 256 units, so 45 degrees is 32 units.
+ */
+static const uint8_t atanTable[65] =
+{
+     0,  1,  1,  2,  3,  3,  4,  4,  5,  6,  6,  7,  8,  8,  9,  9,
+    10, 11, 11, 12, 12, 13, 13, 14, 15, 15, 16, 16, 17, 17, 18, 18,
+    19, 19, 20, 20, 21, 21, 22, 22, 23, 23, 24, 24, 25, 25, 25, 26,
+    26, 27, 27, 27, 28, 28, 29, 29, 29, 30, 30, 30, 31, 31, 31, 32,
+    32,
+};
+
+/*!
+ * \brief Integer approximation of atan2(\p gy, \p gx)
+ *
+ * The angle is folded into the first octant, where it is looked up in
+ * atanTable, and then unfolded again. The resolution is 1.4 degrees.
+ *
+ * \param[in] gy The vertical component
+ * \param[in] gx The horizontal component
+ *
+ * \return The angle in binary angle units (256 is a full circle), counting
+ *         from the positive x-axis towards the positive y-axis. 0 if both
+ *         components are 0.
+ */
+static uint8_t getAngle(const int32_t gy, const int32_t gx)
+{
+    uint32_t ax = (uint32_t)abs(gx);
+    uint32_t ay = (uint32_t)abs(gy);
+    uint32_t a;
+
+    if((ax == 0) && (ay == 0))
+    {
+        return 0;
+    }
+
+    // First quadrant
+    if(ay <= ax)
+    {
+        a = atanTable[((ay * 64) + (ax / 2)) / ax];
+    }
+    else
+    {
+        a = 64 - atanTable[((ax * 64) + (ay / 2)) / ay];
+    }
+
+    // Other quadrants
+    if(gx < 0)
+    {
+        a = 128 - a;
+    }
+
+    if(gy < 0)
+    {
+        a = 256 - a;
+    }
+
+    return (uint8_t)a;
+}
+
+/*!
+ * \brief Sobel gradient magnitude and quantized direction of an image with a
+ *        border
+ *
+ * See sobelGradient().
+ *
+ * \param[in]  pad  A pointer to the source image with a border of one pixel
+ * \param[out] mag  A pointer to the magnitude destination image
+ * \param[out] dir  A pointer to the direction destination image, or NULL
+ * \param[in]  norm The norm of the magnitude. Must be of type ::eNorm.
+ * \param[in]  bins Number of direction bins, 4 or 8
+ */
+static void sobelGradientBorder(const image_t *pad, image_t *mag, image_t *dir,
+                                const eNorm norm, const uint8_t bins)
+{
+    const int32_t cols = mag->cols;
+    const int32_t padStride = IMAGE_STRIDE(pad);
+    const int32_t magStride = IMAGE_STRIDE(mag);
+
+    // For 4 bins, opposite directions are in the same bin
+    const uint8_t angleMask = (bins == 4) ? 127 : 255;
+
+    for(int32_t y=0; y<mag->rows; y++)
+    {
+        const int16_pixel_t *above  = (int16_pixel_t *)pad->data + (y * padStride) + 1;
+        const int16_pixel_t *centre = above + padStride;
+        const int16_pixel_t *below  = centre + padStride;
+        int16_pixel_t *m = (int16_pixel_t *)mag->data + (y * magStride);
+        uint8_pixel_t *d = (dir != NULL) ? (dir->data + (y * IMAGE_STRIDE(dir))) : NULL;
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            int32_t gx = (above[x+1] + (2 * centre[x+1]) + below[x+1]) -
+                         (above[x-1] + (2 * centre[x-1]) + below[x-1]);
+            int32_t gy = (below[x-1] + (2 * below[x]) + below[x+1]) -
+                         (above[x-1] + (2 * above[x]) + above[x+1]);
+
+            int32_t ax = abs(gx);
+            int32_t ay = abs(gy);
+            int32_t val;
+
+            if(norm == NORM_L1)
+            {
+                val = ax + ay;
+            }
+            else
+            {
+                int32_t max = (ax > ay) ? ax : ay;
+                int32_t min = (ax > ay) ? ay : ax;
+                val = max + ((3 * min) >> 3);
+            }
+
+            m[x] = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : (int16_pixel_t)val;
+
+            if(d != NULL)
+            {
+                // Bins are 32 units wide and centred at multiples of 32
+                uint8_t a = getAngle(gy, gx) & angleMask;
+                d[x] = (uint8_pixel_t)(((a + 16) >> 5) & (bins - 1));
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Sobel gradient magnitude and quantized direction in a single pass
+ *
+ * For every pixel, the horizontal gradient gx (right minus left) and the
+ * vertical gradient gy (bottom minus top) are computed with the Sobel masks
+ * and directly combined into the magnitude and the direction. Pixels outside
+ * the image are 0, like in sobel().
+ *
+ * The direction is the angle atan2(gy, gx), with the y-axis pointing down,
+ * quantized into \p bins bins:
+ * - 4 bins: the orientation of the gradient regardless of its sign, centred
+ *   at 0 (horizontal), 45, 90 (vertical) and 135 degrees. This is what
+ *   non-maximum suppression of edges needs.
+ * - 8 bins: the direction of the gradient, centred at 0, 45, ... 315
+ *   degrees.
+ *
+ * Pixels without a gradient are in bin 0.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] mag  A pointer to the magnitude destination image
+ * \param[out] dir  A pointer to the direction destination image with the bin
+ *                  numbers. If this is a NULL pointer, the direction is not
+ *                  calculated.
+ * \param[in]  norm The norm of the magnitude. Must be of type ::eNorm.
+ * \param[in]  bins Number of direction bins, 4 or 8. Ignored if \p dir is
+ *                  a NULL pointer.
+ */
+void sobelGradient(const image_t *src, image_t *mag, image_t *dir,
+                   const eNorm norm, const uint8_t bins)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(mag == NULL, "mag image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(mag->data == NULL, "mag data is invalid");
+    ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
+    ASSERT(mag->type != IMGTYPE_INT16, "mag type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != mag->cols, "src and mag have different number of columns");
+    ASSERT(src->rows != mag->rows, "src and mag have different number of rows");
+    ASSERT(src == mag, "src and mag are the same images");
+
+    if(dir != NULL)
+    {
+        ASSERT(dir->data == NULL, "dir data is invalid");
+        ASSERT(dir->type != IMGTYPE_UINT8, "dir type is invalid");
+        ASSERT(dir->cols != mag->cols, "dir and mag have different number of columns");
+        ASSERT(dir->rows != mag->rows, "dir and mag have different number of rows");
+        ASSERT((bins != 4) && (bins != 8), "number of bins must be 4 or 8");
+    }
+
+    // Verify parameters
+    ASSERT((norm != NORM_L1) && (norm != NORM_L2), "norm is invalid");
+
+    // Pixels outside the image are 0
+    image_t *pad = newPaddedImage(IMGTYPE_INT16, src->cols + 2, src->rows + 2);
+    ASSERT(pad == NULL, "unable to allocate memory for the border");
+
+    copyWithBorder(src, pad, BORDER_CONSTANT, 0);
+
+    sobelGradientBorder(pad, mag, dir, norm, bins);
+
+    deleteImage(pad);
+}
+
+/*!
+ * \brief Creates the scratch buffers of canny() for images of \p cols x
+ *        \p rows pixels
+ *
+ * Create the buffers once and pass them to every call of canny(), so no
+ * memory is allocated per frame. Delete the buffers with
+ * deleteCannyBuffers() when they are not needed any more.
+ *
+ * \param[in] cols The number of columns of the images
+ * \param[in] rows The number of rows of the images
+ *
+ * \return The scratch buffers
+ */
+cannyBuffers_t newCannyBuffers(const uint32_t cols, const uint32_t rows)
+{
+    cannyBuffers_t buffers =
+    {
+        .cols   = cols,
+        .rows   = rows,
+        .pad    = newPaddedImage(IMGTYPE_UINT8, cols + 6, rows + 6),
+        .hsum   = newPaddedImage(IMGTYPE_INT16, cols + 2, rows + 6),
+        .smooth = newPaddedImage(IMGTYPE_INT16, cols + 2, rows + 2),
+        .mag    = newPaddedImage(IMGTYPE_INT16, cols + 2, rows + 2),
+        .dir    = newUint8Image(cols, rows),
+        .edges  = newPaddedImage(IMGTYPE_UINT8, cols + 2, rows + 2),
+        .stack  = newInt32Image(cols, rows),
+    };
+
+    ASSERT((buffers.pad == NULL) || (buffers.hsum == NULL) ||
+           (buffers.smooth == NULL) || (buffers.mag == NULL) ||
+           (buffers.dir == NULL) || (buffers.edges == NULL) ||
+           (buffers.stack == NULL), "unable to allocate memory for the buffers");
+
+    // Only the inside of these images is written by canny(), so the border
+    // stays 0
+    clearInt16Image(buffers.mag);
+    clearUint8Image(buffers.edges);
+
+    return buffers;
+}
+
+/*!
+ * \brief Deletes the scratch buffers of canny()
+ *
+ * \param[in,out] buffers A pointer to the scratch buffers
+ */
+void deleteCannyBuffers(cannyBuffers_t *buffers)
+{
+    deleteImage(buffers->stack);
+    deleteImage(buffers->edges);
+    deleteImage(buffers->dir);
+    deleteImage(buffers->mag);
+    deleteImage(buffers->smooth);
+    deleteImage(buffers->hsum);
+    deleteImage(buffers->pad);
+
+    memset(buffers, 0, sizeof(cannyBuffers_t));
+}
+
+/*!
+ * \brief Canny edge detector
+ *
+ * The edges are found in four steps:
+ * 1. The image is smoothed with the 5x5 binomial filter [1 4 6 4 1]/16 in both
+ *    directions. Pixels outside the image are replicated.
+ * 2. The Sobel gradient magnitude (::NORM_L2) and orientation (4 bins) are
+ *    computed with the same kernel as sobelGradient().
+ * 3. Non-maximum suppression keeps pixels whose magnitude is a local maximum
+ *    across the edge, which thins the edges to one pixel.
+ * 4. Hysteresis: remaining pixels with a magnitude of at least \p high are
+ *    edges. Pixels with a magnitude above \p low are edges if they are
+ *    8-connected to an edge. These are found by following the edges from a
+ *    stack of strong pixels, so every pixel is visited at most once.
+ *
+ * The edges are set to 1. All other pixels are set to 0.
+ *
+ * \param[in]     src     A pointer to the source image
+ * \param[out]    dst     A pointer to the destination image
+ * \param[in]     low     Magnitude above which a pixel can be part of an edge
+ * \param[in]     high    Magnitude from which a pixel is an edge
+ * \param[in,out] buffers A pointer to scratch buffers created by
+ *                        newCannyBuffers() for the size of \p src. If this
+ *                        is a NULL pointer, the buffers are created and
+ *                        deleted by this function.
+ */
+void canny(const image_t *src, image_t *dst, const int16_t low,
+           const int16_t high, cannyBuffers_t *buffers)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    // Verify parameters
+    ASSERT(low > high, "low threshold is larger than high threshold");
+
+    cannyBuffers_t tmp;
+    cannyBuffers_t *b = buffers;
+
+    if(b == NULL)
+    {
+        tmp = newCannyBuffers(src->cols, src->rows);
+        b = &tmp;
+    }
+
+    ASSERT((b->cols != src->cols) || (b->rows != src->rows), "buffers have a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+
+    // Step 1: smoothing
+    copyWithBorder(src, b->pad, BORDER_REPLICATE, 0);
+
+    const int32_t padStride = IMAGE_STRIDE(b->pad);
+    const int32_t hsumStride = IMAGE_STRIDE(b->hsum);
+    const int32_t smoothStride = IMAGE_STRIDE(b->smooth);
+
+    for(int32_t y=0; y<b->hsum->rows; y++)
+    {
+        const uint8_pixel_t *p = b->pad->data + (y * padStride);
+        int16_pixel_t *h = (int16_pixel_t *)b->hsum->data + (y * hsumStride);
+
+        for(int32_t x=0; x<b->hsum->cols; x++)
+        {
+            h[x] = p[x] + (4 * p[x+1]) + (6 * p[x+2]) + (4 * p[x+3]) + p[x+4];
+        }
+    }
+
+    // The smoothed image includes a border of one pixel for the gradient
+    for(int32_t y=0; y<b->smooth->rows; y++)
+    {
+        const int16_pixel_t *h = (int16_pixel_t *)b->hsum->data + (y * hsumStride);
+        int16_pixel_t *s = (int16_pixel_t *)b->smooth->data + (y * smoothStride);
+
+        for(int32_t x=0; x<b->smooth->cols; x++)
+        {
+            int32_t sum = h[x] + (4 * h[x + hsumStride]) + (6 * h[x + (2 * hsumStride)]) +
+                          (4 * h[x + (3 * hsumStride)]) + h[x + (4 * hsumStride)];
+
+            s[x] = (int16_pixel_t)((sum + 128) >> 8);
+        }
+    }
+
+    // Step 2: gradient magnitude and orientation
+    image_t mag = roiImage(b->mag, 1, 1, cols, rows);
+    sobelGradientBorder(b->smooth, &mag, b->dir, NORM_L2, 4);
+
+    // Step 3: non-maximum suppression. Candidates are 2, strong edge pixels
+    // are set to 1 and pushed on the stack.
+    const int32_t stride = IMAGE_STRIDE(b->mag);
+    const int32_t edgesStride = IMAGE_STRIDE(b->edges);
+    const int32_t dirStride = IMAGE_STRIDE(b->dir);
+
+    // Offsets of the neighbours across the edge for each orientation bin
+    const int32_t across[4] = {1, stride + 1, stride, stride - 1};
+
+    int32_t *stack = (int32_t *)b->stack->data;
+    int32_t top = 0;
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        const int16_pixel_t *m = (int16_pixel_t *)b->mag->data + ((y + 1) * stride) + 1;
+        const uint8_pixel_t *d = b->dir->data + (y * dirStride);
+        uint8_pixel_t *e = b->edges->data + ((y + 1) * edgesStride) + 1;
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            int16_pixel_t val = m[x];
+            int32_t o = across[d[x]];
+
+            if((val > low) && (val > m[x - o]) && (val >= m[x + o]))
+            {
+                if(val >= high)
+                {
+                    e[x] = 1;
+                    stack[top++] = ((y + 1) * edgesStride) + x + 1;
+                }
+                else
+                {
+                    e[x] = 2;
+                }
+            }
+            else
+            {
+                e[x] = 0;
+            }
+        }
+    }
+
+    // Step 4: hysteresis by following the edges from the strong pixels
+    const int32_t neighbours[8] =
+    {
+        -edgesStride - 1, -edgesStride, -edgesStride + 1,
+        -1,                              1,
+         edgesStride - 1,  edgesStride,  edgesStride + 1,
+    };
+
+    uint8_pixel_t *edges = b->edges->data;
+
+    while(top > 0)
+    {
+        int32_t o = stack[--top];
+
+        for(int32_t i=0; i<8; i++)
+        {
+            int32_t n = o + neighbours[i];
+
+            if(edges[n] == 2)
+            {
+                edges[n] = 1;
+                stack[top++] = n;
+            }
+        }
+    }
+
+    // Candidates that are not connected to a strong pixel are no edges
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        const uint8_pixel_t *e = edges + ((y + 1) * edgesStride) + 1;
+        uint8_pixel_t *d = dst->data + (y * dstStride);
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            d[x] = (e[x] == 1) ? 1 : 0;
         }
     }
 
+    if(buffers == NULL)
+    {
+        deleteCannyBuffers(&tmp);
+    }
 }
@@ -42,6 +42,24 @@ extern "C" {
 
 #include "image.h"
 
+/// Scratch buffers of canny()
+///
+/// The buffers are created once by newCannyBuffers() and reused for every
+/// frame, so canny() does not allocate memory.
+typedef struct
+{
+    int32_t  cols;   ///< Number of columns of the source image
+    int32_t  rows;   ///< Number of rows of the source image
+    image_t *pad;    ///< Source image with a replicated border of three pixels
+    image_t *hsum;   ///< Horizontally smoothed image
+    image_t *smooth; ///< Smoothed image with a border of one pixel
+    image_t *mag;    ///< Gradient magnitude with a border of zeros
+    image_t *dir;    ///< Quantized gradient orientation
+    image_t *edges;  ///< Edge map with a border of zeros
+    image_t *stack;  ///< Stack of edge pixels that are followed
+
+}cannyBuffers_t;
+
 // Functions are documented in the source file
 
 void gaussianFilter_3x3(const image_t *src, image_t *dst);
@@ -50,6 +68,10 @@ void laplacianFilter_3x3(const image_t *src, image_t *dst);
 void laplacianFilter_5x5(const image_t *src, image_t *dst);
 void sobel(const image_t *src, image_t *mag, image_t *dir);
 void sobelFast(const image_t *src, image_t *mag);
+void sobelGradient(const image_t *src, image_t *mag, image_t *dir, const eNorm norm, const uint8_t bins);
+cannyBuffers_t newCannyBuffers(const uint32_t cols, const uint32_t rows);
+void deleteCannyBuffers(cannyBuffers_t *buffers);
+void canny(const image_t *src, image_t *dst, const int16_t low, const int16_t high, cannyBuffers_t *buffers);
 
 #endif // _SPATIAL_FILTERS_H_
 
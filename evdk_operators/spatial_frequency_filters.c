@@ -36,3 +36,249 @@
 #include "image_fundamentals.h"
 #include "spatial_frequency_filters.h"
 
+#include <math.h>
+#include <string.h>
+
+/*!
+ * \brief Calculates the gain of a low-pass or band-pass transfer function
+ *
+ * \param[in] shape  The shape of the transfer function
+ * \param[in] band   0 for a low-pass and 1 for a band-pass filter
+ * \param[in] d      The distance to the zero frequency
+ * \param[in] cutoff The cutoff frequency or the centre of the band
+ * \param[in] width  The width of the band
+ * \param[in] order  The order of a Butterworth filter
+ *
+ * \return The gain in the range 0 to 1
+ */
+static float filterGain(const eFilterShape shape, const int32_t band, const float d,
+                        const float cutoff, const float width, const uint8_t order)
+{
+    if(band == 0)
+    {
+        switch(shape)
+        {
+        case FILTER_IDEAL:
+            return (d <= cutoff) ? 1.0f : 0.0f;
+        case FILTER_BUTTERWORTH:
+            return 1.0f / (1.0f + powf(d / cutoff, 2.0f * order));
+        case FILTER_GAUSSIAN:
+            return expf(-(d * d) / (2.0f * cutoff * cutoff));
+        }
+    }
+    else
+    {
+        // Band-pass filters are the complement of the band-reject filters of
+        // Gonzalez & Woods
+        const float q = (d * d) - (cutoff * cutoff);
+
+        switch(shape)
+        {
+        case FILTER_IDEAL:
+            return (fabsf(d - cutoff) <= (0.5f * width)) ? 1.0f : 0.0f;
+        case FILTER_BUTTERWORTH:
+            if(q == 0.0f)
+            {
+                return 1.0f;
+            }
+            return 1.0f - (1.0f / (1.0f + powf((d * width) / q, 2.0f * order)));
+        case FILTER_GAUSSIAN:
+            if(d == 0.0f)
+            {
+                return (cutoff == 0.0f) ? 1.0f : 0.0f;
+            }
+            return expf(-((q / (d * width)) * (q / (d * width))));
+        }
+    }
+
+    return 0.0f;
+}
+
+/*!
+ * \brief Creates a frequency domain filter for images of \p cols x \p rows
+ *        pixels
+ *
+ * The transfer function H(u,v) depends on the distance D(u,v) of frequency
+ * (u,v) to the zero frequency, measured in samples of the spectrum. For a
+ * cutoff D0, width W and order n:
+ *
+ * <table>
+ * <caption id="transfer_functions">Transfer functions</caption>
+ * <tr><th> shape              <th> low-pass            <th> band-pass
+ * <tr><th> FILTER_IDEAL       <td> D <= D0             <td> abs(D - D0) <= W/2
+ * <tr><th> FILTER_BUTTERWORTH <td> 1 / (1 + (D/D0)^2n) <td> 1 - 1 / (1 + (DW / (D^2-D0^2))^2n)
+ * <tr><th> FILTER_GAUSSIAN    <td> exp(-D^2 / 2D0^2)   <td> exp(-((D^2-D0^2) / DW)^2)
+ * </table>
+ *
+ * A high-pass filter is 1 minus the low-pass filter.
+ *
+ * The transfer function, the spectrum buffer and the FFT plan are created
+ * once. Pass the filter to every call of frequencyFilter() and delete it with
+ * deleteFrequencyFilter() when it is not needed any more.
+ *
+ * \param[in] cols   The number of columns of the images
+ * \param[in] rows   The number of rows of the images
+ * \param[in] shape  The shape of the transfer function
+ * \param[in] pass   The frequencies that pass the filter
+ * \param[in] cutoff The cutoff frequency, or the centre of the band of a
+ *                   band-pass filter
+ * \param[in] width  The width of the band of a band-pass filter. Ignored by
+ *                   other filters.
+ * \param[in] order  The order of a Butterworth filter. Ignored by other
+ *                   filters.
+ *
+ * \return The filter
+ */
+frequencyFilter_t newFrequencyFilter(const uint32_t cols, const uint32_t rows,
+                                     const eFilterShape shape, const eFilterPass pass,
+                                     const float cutoff, const float width,
+                                     const uint8_t order)
+{
+    // Verify parameters
+    ASSERT(cutoff < 0.0f, "cutoff is negative");
+    ASSERT((shape != FILTER_IDEAL) && (pass != FILTER_BANDPASS) && (cutoff == 0.0f), "cutoff is 0");
+    ASSERT((pass == FILTER_BANDPASS) && (width <= 0.0f), "width must be larger than 0");
+    ASSERT((shape == FILTER_BUTTERWORTH) && (order == 0), "order must be larger than 0");
+
+    frequencyFilter_t filter =
+    {
+        .cols     = cols,
+        .rows     = rows,
+        .shape    = shape,
+        .pass     = pass,
+        .cutoff   = cutoff,
+        .width    = width,
+        .order    = order,
+        .transfer = newFloatImage(cols, rows),
+        .spectrum = newComplexImage(cols, rows),
+        .plan     = newFftPlan(cols, rows),
+    };
+
+    ASSERT((filter.transfer == NULL) || (filter.spectrum == NULL),
+           "unable to allocate memory for the filter");
+
+    const int32_t band = (pass == FILTER_BANDPASS);
+    float_pixel_t *h = (float_pixel_t *)filter.transfer->data;
+
+    for(int32_t v=0; v<(int32_t)rows; v++)
+    {
+        // Frequencies above half the size are the negative frequencies
+        const float fv = (float)(((2 * v) <= (int32_t)rows) ? v : ((int32_t)rows - v));
+
+        for(int32_t u=0; u<(int32_t)cols; u++)
+        {
+            const float fu = (float)(((2 * u) <= (int32_t)cols) ? u : ((int32_t)cols - u));
+            const float d = sqrtf((fu * fu) + (fv * fv));
+            float gain = filterGain(shape, band, d, cutoff, width, order);
+
+            if(pass == FILTER_HIGHPASS)
+            {
+                gain = 1.0f - gain;
+            }
+
+            h[(v * cols) + u] = gain;
+        }
+    }
+
+    return filter;
+}
+
+/*!
+ * \brief Deletes a frequency domain filter
+ *
+ * \param[in,out] filter A pointer to the filter
+ */
+void deleteFrequencyFilter(frequencyFilter_t *filter)
+{
+    deleteFftPlan(&filter->plan);
+    deleteImage(filter->spectrum);
+    deleteImage(filter->transfer);
+
+    memset(filter, 0, sizeof(frequencyFilter_t));
+}
+
+/*!
+ * \brief Filters an image in the frequency domain
+ *
+ * The spectrum of \p src is calculated with fft2dReal(), multiplied by the
+ * transfer function of the filter and transformed back with ifft2d(). The
+ * cost does not depend on the cutoff, which makes this faster than spatial
+ * convolution with large kernels. The image is treated as periodic, so the
+ * result near the border is influenced by the opposite border.
+ *
+ * A high-pass or band-pass result is negative at about half of the pixels.
+ * Use a destination image of type ::IMGTYPE_FLOAT to keep these values.
+ *
+ * \param[in]     src    A pointer to the source image
+ * \param[out]    dst    A pointer to the destination image. Values are
+ *                       rounded and clipped to 0 - 255 for an
+ *                       ::IMGTYPE_UINT8 image.
+ * \param[in,out] filter A pointer to the filter created by
+ *                       newFrequencyFilter() for the size of \p src
+ *
+ * \pre \p src is of type ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ * \pre \p dst is of type ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ * \pre \p src and \p dst have the same size
+ */
+void frequencyFilter(const image_t *src, image_t *dst, frequencyFilter_t *filter)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_FLOAT), "src type is invalid");
+    ASSERT((dst->type != IMGTYPE_UINT8) && (dst->type != IMGTYPE_FLOAT), "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    // Verify parameters
+    ASSERT(filter == NULL, "filter is invalid");
+    ASSERT((filter->cols != src->cols) || (filter->rows != src->rows), "filter has a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    fft2dReal(src, filter->spectrum, &filter->plan);
+
+    // Pointwise multiplication by the real transfer function
+    complex_pixel_t *s = (complex_pixel_t *)filter->spectrum->data;
+    const float_pixel_t *h = (float_pixel_t *)filter->transfer->data;
+
+    for(int32_t i=0; i<(cols * rows); i++)
+    {
+        s[i].real *= h[i];
+        s[i].imaginary *= h[i];
+    }
+
+    ifft2d(filter->spectrum, filter->spectrum, &filter->plan);
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        const complex_pixel_t *r = s + (y * cols);
+
+        if(dst->type == IMGTYPE_UINT8)
+        {
+            uint8_pixel_t *d = dst->data + (y * dstStride);
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                const float val = r[x].real + 0.5f;
+
+                d[x] = (val <= 0.0f) ? 0 : ((val >= 255.0f) ? 255 : (uint8_pixel_t)val);
+            }
+        }
+        else
+        {
+            float_pixel_t *d = (float_pixel_t *)dst->data + (y * dstStride);
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                d[x] = r[x].real;
+            }
+        }
+    }
+}
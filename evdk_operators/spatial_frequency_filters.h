@@ -40,9 +40,37 @@ extern "C" {
 #define _SPATIAL_FREQUENCY_FILTERS_H_
 
 #include "image.h"
+#include "transforms.h"
+
+/// A frequency domain filter for images of a fixed size
+///
+/// The filter is created once by newFrequencyFilter() and reused for every
+/// frame, so the transfer function is calculated only once and filtering a
+/// frame costs a forward FFT, a pointwise multiplication and an inverse FFT.
+typedef struct
+{
+    int32_t      cols;     ///< Number of columns of the images
+    int32_t      rows;     ///< Number of rows of the images
+    eFilterShape shape;    ///< Shape of the transfer function
+    eFilterPass  pass;     ///< Frequencies that pass the filter
+    float        cutoff;   ///< Cutoff or centre frequency
+    float        width;    ///< Width of the band of a band-pass filter
+    uint8_t      order;    ///< Order of a Butterworth filter
+    image_t     *transfer; ///< Transfer function with the zero frequency at (0,0)
+    image_t     *spectrum; ///< Spectrum of the image that is filtered
+    fftPlan_t    plan;     ///< Plan of the FFT
+
+}frequencyFilter_t;
 
 // Functions are documented in the source file
 
+frequencyFilter_t newFrequencyFilter(const uint32_t cols, const uint32_t rows,
+                                     const eFilterShape shape, const eFilterPass pass,
+                                     const float cutoff, const float width,
+                                     const uint8_t order);
+void deleteFrequencyFilter(frequencyFilter_t *filter);
+void frequencyFilter(const image_t *src, image_t *dst, frequencyFilter_t *filter);
+
 #endif // _SPATIAL_FREQUENCY_FILTERS_H_
 
 #ifdef __cplusplus
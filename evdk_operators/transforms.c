@@ -37,6 +37,7 @@
 #include "transforms.h"
 
 #include <math.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -44,10 +45,1921 @@
 
 complex_pixel_t getComplexPixel(const image_t *img, const int32_t c, const int32_t r)
 {
-    return (*((complex_pixel_t *)(img->data) + (r * img->cols + c)));
+    return (*((complex_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
 }
 
 void setComplexPixel(const image_t *img, const int32_t c, const int32_t r, const complex_pixel_t value)
 {
-    *((complex_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    *((complex_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+// ----------------------------------------------------------------------------
+// Fast Fourier transform
+// ----------------------------------------------------------------------------
+
+/// Data of a one dimensional transform that is shared by the butterflies
+typedef struct
+{
+    int32_t                n;         ///< Length of the transform
+    const int32_t         *factors;   ///< Pairs of radix and remaining length
+    const complex_pixel_t *twiddles;  ///< exp(-2*pi*i*k/n) for k = 0..n-1
+    complex_pixel_t       *scratch;   ///< Scratch buffer of the generic butterfly
+
+}fftLine_t;
+
+static inline complex_pixel_t complexMul(const complex_pixel_t a, const complex_pixel_t b)
+{
+    complex_pixel_t c =
+    {
+        .real      = (a.real * b.real) - (a.imaginary * b.imaginary),
+        .imaginary = (a.real * b.imaginary) + (a.imaginary * b.real),
+    };
+
+    return c;
+}
+
+/*!
+ * \brief Splits \p n in radices, preferring 4, then 2, 3, 5 and the other odd
+ *        numbers
+ *
+ * Every factor is stored as a pair of the radix and the length that remains
+ * after dividing by it, which is the layout fftWork() walks through.
+ *
+ * \param[in]  n       The transform length
+ * \param[out] factors The pairs of radix and remaining length
+ */
+static void fftFactorize(int32_t n, int32_t *factors)
+{
+    int32_t p = 4;
+    int32_t i = 0;
+
+    while(n > 1)
+    {
+        while((n % p) != 0)
+        {
+            switch(p)
+            {
+            case 4:  p = 2; break;
+            case 2:  p = 3; break;
+            default: p += 2; break;
+            }
+
+            // A prime factor
+            if((p * p) > n)
+            {
+                p = n;
+            }
+        }
+
+        n /= p;
+        factors[i++] = p;
+        factors[i++] = n;
+    }
+}
+
+/*!
+ * \brief Radix-2 butterflies of \p m pairs of sub-transforms
+ */
+static void butterfly2(complex_pixel_t *out, const fftLine_t *line,
+                       const int32_t fstride, const int32_t m)
+{
+    complex_pixel_t *out2 = out + m;
+
+    for(int32_t k=0; k<m; k++)
+    {
+        complex_pixel_t t = complexMul(out2[k], line->twiddles[k * fstride]);
+
+        out2[k].real = out[k].real - t.real;
+        out2[k].imaginary = out[k].imaginary - t.imaginary;
+        out[k].real += t.real;
+        out[k].imaginary += t.imaginary;
+    }
+}
+
+/*!
+ * \brief Radix-4 butterflies of \p m groups of four sub-transforms
+ */
+static void butterfly4(complex_pixel_t *out, const fftLine_t *line,
+                       const int32_t fstride, const int32_t m)
+{
+    for(int32_t k=0; k<m; k++)
+    {
+        complex_pixel_t s0 = complexMul(out[k + m], line->twiddles[k * fstride]);
+        complex_pixel_t s1 = complexMul(out[k + (2 * m)], line->twiddles[2 * k * fstride]);
+        complex_pixel_t s2 = complexMul(out[k + (3 * m)], line->twiddles[3 * k * fstride]);
+
+        complex_pixel_t a = out[k];
+
+        // Sums and differences of the even and odd sub-transforms
+        complex_pixel_t s3 = { s0.real + s2.real, s0.imaginary + s2.imaginary };
+        complex_pixel_t s4 = { s0.real - s2.real, s0.imaginary - s2.imaginary };
+        complex_pixel_t s5 = { a.real - s1.real, a.imaginary - s1.imaginary };
+
+        a.real += s1.real;
+        a.imaginary += s1.imaginary;
+
+        out[k].real = a.real + s3.real;
+        out[k].imaginary = a.imaginary + s3.imaginary;
+        out[k + (2 * m)].real = a.real - s3.real;
+        out[k + (2 * m)].imaginary = a.imaginary - s3.imaginary;
+
+        // Multiplication of s4 by -i and i
+        out[k + m].real = s5.real + s4.imaginary;
+        out[k + m].imaginary = s5.imaginary - s4.real;
+        out[k + (3 * m)].real = s5.real - s4.imaginary;
+        out[k + (3 * m)].imaginary = s5.imaginary + s4.real;
+    }
+}
+
+/*!
+ * \brief Butterflies of any radix \p p, used for the radices 3, 5 and larger
+ *        prime factors
+ */
+static void butterflyGeneric(complex_pixel_t *out, const fftLine_t *line,
+                             const int32_t fstride, const int32_t m, const int32_t p)
+{
+    const int32_t n = line->n;
+    complex_pixel_t *s = line->scratch;
+
+    for(int32_t u=0; u<m; u++)
+    {
+        for(int32_t q=0; q<p; q++)
+        {
+            s[q] = out[u + (q * m)];
+        }
+
+        for(int32_t q1=0; q1<p; q1++)
+        {
+            const int32_t k = u + (q1 * m);
+            complex_pixel_t sum = s[0];
+            int32_t t = 0;
+
+            for(int32_t q=1; q<p; q++)
+            {
+                t += fstride * k;
+
+                if(t >= n)
+                {
+                    t %= n;
+                }
+
+                complex_pixel_t v = complexMul(s[q], line->twiddles[t]);
+                sum.real += v.real;
+                sum.imaginary += v.imaginary;
+            }
+
+            out[k] = sum;
+        }
+    }
+}
+
+/*!
+ * \brief Recursive mixed radix decimation in time
+ *
+ * The input elements \p in, \p in + \p fstride, ... are transformed into
+ * \p out. The first factor splits the input in radix sub-sequences, which are
+ * transformed recursively and combined by the butterflies.
+ */
+static void fftWork(complex_pixel_t *out, const complex_pixel_t *in,
+                    const int32_t fstride, const int32_t *factors,
+                    const fftLine_t *line)
+{
+    const int32_t p = factors[0];
+    const int32_t m = factors[1];
+    complex_pixel_t *o = out;
+    complex_pixel_t *end = out + (p * m);
+
+    if(m == 1)
+    {
+        do
+        {
+            *o = *in;
+            in += fstride;
+        }
+        while(++o != end);
+    }
+    else
+    {
+        do
+        {
+            fftWork(o, in, fstride * p, factors + 2, line);
+            in += fstride;
+        }
+        while((o += m) != end);
+    }
+
+    switch(p)
+    {
+    case 2:  butterfly2(out, line, fstride, m); break;
+    case 4:  butterfly4(out, line, fstride, m); break;
+    default: butterflyGeneric(out, line, fstride, m, p); break;
+    }
+}
+
+/*!
+ * \brief Forward transform of a single row or column
+ *
+ * \param[in]  line The transform data
+ * \param[in]  in   The input elements
+ * \param[out] out  The output elements. Must not overlap \p in.
+ */
+static void fftLine(const fftLine_t *line, const complex_pixel_t *in, complex_pixel_t *out)
+{
+    if(line->n == 1)
+    {
+        out[0] = in[0];
+        return;
+    }
+
+    fftWork(out, in, 1, line->factors, line);
+}
+
+/*!
+ * \brief Fills \p twiddles with exp(-2*pi*i*k/n) for k = 0..n-1
+ */
+static void fftTwiddles(complex_pixel_t *twiddles, const int32_t n)
+{
+    for(int32_t k=0; k<n; k++)
+    {
+        const double phase = (-2.0 * M_PI * k) / n;
+
+        twiddles[k].real = (float)cos(phase);
+        twiddles[k].imaginary = (float)sin(phase);
+    }
+}
+
+/*!
+ * \brief Creates the plan of the FFT of images of \p cols x \p rows pixels
+ *
+ * The transform lengths are factorized in radices 4, 2, 3 and 5, so next to
+ * powers of two also sizes like 160x120 are transformed in O(N log N). Other
+ * prime factors are supported by a slower generic butterfly.
+ *
+ * Create the plan once and pass it to every call of fft2d(), fft2dReal() and
+ * ifft2d(), so the twiddle factors are calculated only once and no memory is
+ * allocated per frame. Delete the plan with deleteFftPlan() when it is not
+ * needed any more.
+ *
+ * \param[in] cols The number of columns of the images
+ * \param[in] rows The number of rows of the images
+ *
+ * \return The plan
+ */
+fftPlan_t newFftPlan(const uint32_t cols, const uint32_t rows)
+{
+    ASSERT((cols == 0) || (rows == 0), "invalid size");
+
+    const uint32_t n = (cols > rows) ? cols : rows;
+
+    fftPlan_t plan =
+    {
+        .cols        = cols,
+        .rows        = rows,
+        .colTwiddles = newComplexImage(cols, 1),
+        .rowTwiddles = newComplexImage(rows, 1),
+        .line        = newComplexImage(n, 2),
+        .scratch     = newComplexImage(n, 1),
+    };
+
+    ASSERT((plan.colTwiddles == NULL) || (plan.rowTwiddles == NULL) ||
+           (plan.line == NULL) || (plan.scratch == NULL),
+           "unable to allocate memory for the plan");
+
+    fftFactorize(cols, plan.colFactors);
+    fftFactorize(rows, plan.rowFactors);
+
+    fftTwiddles((complex_pixel_t *)plan.colTwiddles->data, cols);
+    fftTwiddles((complex_pixel_t *)plan.rowTwiddles->data, rows);
+
+    return plan;
+}
+
+/*!
+ * \brief Deletes the plan of an FFT
+ *
+ * \param[in,out] plan A pointer to the plan
+ */
+void deleteFftPlan(fftPlan_t *plan)
+{
+    deleteImage(plan->scratch);
+    deleteImage(plan->line);
+    deleteImage(plan->rowTwiddles);
+    deleteImage(plan->colTwiddles);
+
+    memset(plan, 0, sizeof(fftPlan_t));
+}
+
+/*!
+ * \brief Transforms the columns \p first up to \p last of \p dst in place
+ *
+ * The inverse transform is obtained with the forward transform as
+ * conj(fft(conj(x))) / N. The conjugate of the input is taken by the caller,
+ * the conjugate and scaling of the output are done here if \p scale is not 0.
+ */
+static void fftColumns(image_t *dst, const fftPlan_t *plan, const int32_t first,
+                       const int32_t last, const float scale)
+{
+    const int32_t stride = IMAGE_STRIDE(dst);
+    const int32_t rows = dst->rows;
+
+    complex_pixel_t *in = (complex_pixel_t *)plan->line->data;
+    complex_pixel_t *out = in + IMAGE_STRIDE(plan->line);
+
+    fftLine_t line =
+    {
+        .n        = rows,
+        .factors  = plan->rowFactors,
+        .twiddles = (complex_pixel_t *)plan->rowTwiddles->data,
+        .scratch  = (complex_pixel_t *)plan->scratch->data,
+    };
+
+    for(int32_t x=first; x<=last; x++)
+    {
+        complex_pixel_t *d = (complex_pixel_t *)dst->data + x;
+
+        for(int32_t y=0; y<rows; y++)
+        {
+            in[y] = d[y * stride];
+        }
+
+        fftLine(&line, in, out);
+
+        if(scale == 0.0f)
+        {
+            for(int32_t y=0; y<rows; y++)
+            {
+                d[y * stride] = out[y];
+            }
+        }
+        else
+        {
+            for(int32_t y=0; y<rows; y++)
+            {
+                d[y * stride].real = out[y].real * scale;
+                d[y * stride].imaginary = -out[y].imaginary * scale;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Forward or inverse transform of a complex image
+ */
+static void fftComplex(const image_t *src, image_t *dst, fftPlan_t *plan, const int32_t inverse)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_COMPLEX, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_COMPLEX, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    fftPlan_t tmp;
+    fftPlan_t *p = plan;
+
+    if(p == NULL)
+    {
+        tmp = newFftPlan(src->cols, src->rows);
+        p = &tmp;
+    }
+
+    ASSERT((p->cols != src->cols) || (p->rows != src->rows), "plan has a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t srcStride = IMAGE_STRIDE(src);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    complex_pixel_t *in = (complex_pixel_t *)p->line->data;
+
+    fftLine_t line =
+    {
+        .n        = cols,
+        .factors  = p->colFactors,
+        .twiddles = (complex_pixel_t *)p->colTwiddles->data,
+        .scratch  = (complex_pixel_t *)p->scratch->data,
+    };
+
+    // Rows. The row is copied first, so src and dst can be the same image.
+    for(int32_t y=0; y<src->rows; y++)
+    {
+        const complex_pixel_t *s = (complex_pixel_t *)src->data + (y * srcStride);
+        complex_pixel_t *d = (complex_pixel_t *)dst->data + (y * dstStride);
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            in[x].real = s[x].real;
+            in[x].imaginary = inverse ? -s[x].imaginary : s[x].imaginary;
+        }
+
+        fftLine(&line, in, d);
+    }
+
+    // Columns
+    const float scale = inverse ? (1.0f / ((float)cols * src->rows)) : 0.0f;
+
+    fftColumns(dst, p, 0, cols - 1, scale);
+
+    if(plan == NULL)
+    {
+        deleteFftPlan(&tmp);
+    }
+}
+
+/*!
+ * \brief Calculates the two dimensional discrete Fourier transform of a
+ *        complex image
+ *
+ * Uses a mixed radix FFT, first on all rows and then on all columns. The
+ * result is not scaled and the zero frequency is at pixel (0,0).
+ *
+ * \param[in]     src  A pointer to the source image
+ * \param[out]    dst  A pointer to the destination image. Can be the same as
+ *                     \p src.
+ * \param[in,out] plan A pointer to the plan created by newFftPlan() for the
+ *                     size of \p src. If NULL, a plan is created and deleted
+ *                     for this call only.
+ *
+ * \pre \p src and \p dst are of type ::IMGTYPE_COMPLEX
+ * \pre \p src and \p dst have the same size
+ */
+void fft2d(const image_t *src, image_t *dst, fftPlan_t *plan)
+{
+    fftComplex(src, dst, plan, 0);
+}
+
+/*!
+ * \brief Calculates the inverse two dimensional discrete Fourier transform of
+ *        a complex image
+ *
+ * The result is scaled by 1/(cols*rows), so ifft2d() undoes fft2d().
+ *
+ * \param[in]     src  A pointer to the source image
+ * \param[out]    dst  A pointer to the destination image. Can be the same as
+ *                     \p src.
+ * \param[in,out] plan A pointer to the plan created by newFftPlan() for the
+ *                     size of \p src. If NULL, a plan is created and deleted
+ *                     for this call only.
+ *
+ * \pre \p src and \p dst are of type ::IMGTYPE_COMPLEX
+ * \pre \p src and \p dst have the same size
+ */
+void ifft2d(const image_t *src, image_t *dst, fftPlan_t *plan)
+{
+    fftComplex(src, dst, plan, 1);
+}
+
+/*!
+ * \brief Calculates the two dimensional discrete Fourier transform of a real
+ *        image
+ *
+ * The spectrum of a real image is conjugate symmetric, which is used twice.
+ * Two rows are transformed at once as the real and imaginary part of a single
+ * complex row and separated afterwards. Only the columns 0 up to cols/2 are
+ * transformed, the other columns are the complex conjugate of their mirrored
+ * counterparts. This takes about half the time of fft2d().
+ *
+ * \param[in]     src  A pointer to the source image
+ * \param[out]    dst  A pointer to the destination image with the complete
+ *                     spectrum
+ * \param[in,out] plan A pointer to the plan created by newFftPlan() for the
+ *                     size of \p src. If NULL, a plan is created and deleted
+ *                     for this call only.
+ *
+ * \pre \p src is of type ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ * \pre \p dst is of type ::IMGTYPE_COMPLEX
+ * \pre \p src and \p dst have the same size
+ */
+void fft2dReal(const image_t *src, image_t *dst, fftPlan_t *plan)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_FLOAT), "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_COMPLEX, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    fftPlan_t tmp;
+    fftPlan_t *p = plan;
+
+    if(p == NULL)
+    {
+        tmp = newFftPlan(src->cols, src->rows);
+        p = &tmp;
+    }
+
+    ASSERT((p->cols != src->cols) || (p->rows != src->rows), "plan has a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t half = cols / 2;
+    const int32_t srcStride = IMAGE_STRIDE(src);
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    complex_pixel_t *in = (complex_pixel_t *)p->line->data;
+    complex_pixel_t *out = in + IMAGE_STRIDE(p->line);
+
+    fftLine_t line =
+    {
+        .n        = cols,
+        .factors  = p->colFactors,
+        .twiddles = (complex_pixel_t *)p->colTwiddles->data,
+        .scratch  = (complex_pixel_t *)p->scratch->data,
+    };
+
+    // Rows in pairs: z = a + i*b
+    for(int32_t y=0; y<rows; y+=2)
+    {
+        const int32_t pair = (y + 1) < rows;
+
+        if(src->type == IMGTYPE_UINT8)
+        {
+            const uint8_pixel_t *a = src->data + (y * srcStride);
+            const uint8_pixel_t *b = a + srcStride;
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                in[x].real = a[x];
+                in[x].imaginary = pair ? b[x] : 0.0f;
+            }
+        }
+        else
+        {
+            const float_pixel_t *a = (float_pixel_t *)src->data + (y * srcStride);
+            const float_pixel_t *b = a + srcStride;
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                in[x].real = a[x];
+                in[x].imaginary = pair ? b[x] : 0.0f;
+            }
+        }
+
+        fftLine(&line, in, out);
+
+        // A[k] = (Z[k] + conj(Z[n-k])) / 2 and B[k] = (Z[k] - conj(Z[n-k])) / 2i
+        complex_pixel_t *da = (complex_pixel_t *)dst->data + (y * dstStride);
+        complex_pixel_t *db = da + dstStride;
+
+        for(int32_t k=0; k<=half; k++)
+        {
+            const complex_pixel_t z = out[k];
+            const complex_pixel_t w = out[(k == 0) ? 0 : (cols - k)];
+
+            da[k].real = 0.5f * (z.real + w.real);
+            da[k].imaginary = 0.5f * (z.imaginary - w.imaginary);
+
+            if(pair)
+            {
+                db[k].real = 0.5f * (z.imaginary + w.imaginary);
+                db[k].imaginary = 0.5f * (w.real - z.real);
+            }
+        }
+    }
+
+    // Columns of the non-negative frequencies
+    fftColumns(dst, p, 0, half, 0.0f);
+
+    // The other columns: X(u,v) = conj(X(cols-u, rows-v))
+    for(int32_t y=0; y<rows; y++)
+    {
+        complex_pixel_t *d = (complex_pixel_t *)dst->data + (y * dstStride);
+        const complex_pixel_t *m = (complex_pixel_t *)dst->data +
+                                   (((rows - y) % rows) * dstStride);
+
+        for(int32_t x=half+1; x<cols; x++)
+        {
+            d[x].real = m[cols - x].real;
+            d[x].imaginary = -m[cols - x].imaginary;
+        }
+    }
+
+    if(plan == NULL)
+    {
+        deleteFftPlan(&tmp);
+    }
+}
+
+/*!
+ * \brief Returns the smallest transform length of at least \p n that only has
+ *        the factors 2, 3 and 5
+ *
+ * Zero padding an image to this length keeps the FFT on the fast butterflies.
+ *
+ * \param[in] n The minimum length
+ *
+ * \return The transform length
+ */
+uint32_t fftFastSize(const uint32_t n)
+{
+    uint32_t m = (n < 1) ? 1 : n;
+
+    while(1)
+    {
+        uint32_t r = m;
+
+        while((r % 2) == 0){ r /= 2; }
+        while((r % 3) == 0){ r /= 3; }
+        while((r % 5) == 0){ r /= 5; }
+
+        if(r == 1)
+        {
+            return m;
+        }
+
+        m++;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Correlation in the frequency domain
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Copies a region of \p src into the float image \p tile and sets the
+ *        remaining pixels of \p tile to 0
+ */
+static void fillTile(const image_t *src, image_t *tile, const int32_t x0,
+                     const int32_t y0, const int32_t cols, const int32_t rows)
+{
+    const int32_t srcStride = IMAGE_STRIDE(src);
+
+    for(int32_t y=0; y<tile->rows; y++)
+    {
+        float_pixel_t *t = (float_pixel_t *)tile->data + (y * tile->cols);
+        int32_t x = 0;
+
+        if(y < rows)
+        {
+            if(src->type == IMGTYPE_UINT8)
+            {
+                const uint8_pixel_t *s = src->data + ((y0 + y) * srcStride) + x0;
+
+                for(; x<cols; x++)
+                {
+                    t[x] = s[x];
+                }
+            }
+            else if(src->type == IMGTYPE_INT16)
+            {
+                const int16_pixel_t *s = (int16_pixel_t *)src->data + ((y0 + y) * srcStride) + x0;
+
+                for(; x<cols; x++)
+                {
+                    t[x] = s[x];
+                }
+            }
+            else
+            {
+                const float_pixel_t *s = (float_pixel_t *)src->data + ((y0 + y) * srcStride) + x0;
+
+                for(; x<cols; x++)
+                {
+                    t[x] = s[x];
+                }
+            }
+        }
+
+        for(; x<tile->cols; x++)
+        {
+            t[x] = 0.0f;
+        }
+    }
+}
+
+/*!
+ * \brief Returns the FFT tile size in one direction for a mask of \p mskSize
+ *        and images of \p size pixels, with tiles of at most \p maxTile
+ *        pixels or twice the mask size for very large masks
+ */
+static uint32_t tileSize(const uint32_t mskSize, const uint32_t size, const uint32_t maxTile)
+{
+    const uint32_t max = ((2 * mskSize) < maxTile) ? maxTile : (2 * mskSize);
+
+    return fftFastSize((size < max) ? size : max);
+}
+
+/*!
+ * \brief Creates the cached spectrum of the mask \p msk for the valid
+ *        correlation of images of \p cols x \p rows pixels of type \p type
+ *
+ * The images are split in tiles of at most \p maxTile pixels, or twice the
+ * mask size for very large masks. No border image is allocated.
+ */
+static correlationTemplate_t newTemplate(const image_t *msk, const eImageType type,
+                                         const uint32_t cols, const uint32_t rows,
+                                         const uint32_t maxTile)
+{
+    const uint32_t tileCols = tileSize(msk->cols, cols, maxTile);
+    const uint32_t tileRows = tileSize(msk->rows, rows, maxTile);
+
+    correlationTemplate_t tmpl =
+    {
+        .cols     = cols,
+        .rows     = rows,
+        .mskCols  = msk->cols,
+        .mskRows  = msk->rows,
+        .type     = type,
+        .mask     = NULL,
+        .spectrum = newComplexImage(tileCols, tileRows),
+        .pad      = NULL,
+        .tile     = newFloatImage(tileCols, tileRows),
+        .product  = newComplexImage(tileCols, tileRows),
+        .plan     = newFftPlan(tileCols, tileRows),
+    };
+
+    ASSERT((tmpl.spectrum == NULL) || (tmpl.tile == NULL) || (tmpl.product == NULL),
+           "unable to allocate memory for the template");
+
+    // Correlation is a multiplication by the complex conjugate of the
+    // spectrum of the mask
+    fillTile(msk, tmpl.tile, 0, 0, msk->cols, msk->rows);
+    fft2dReal(tmpl.tile, tmpl.spectrum, &tmpl.plan);
+
+    complex_pixel_t *m = (complex_pixel_t *)tmpl.spectrum->data;
+
+    for(uint32_t i=0; i<(tileCols * tileRows); i++)
+    {
+        m[i].imaginary = -m[i].imaginary;
+    }
+
+    return tmpl;
+}
+
+/*!
+ * \brief Valid correlation of \p src with the mask of \p tmpl
+ *
+ * Pixel (x,y) of \p dst is the sum of the products of the mask and the window
+ * of \p src with its top-left pixel at (x,y), so \p dst is smaller than
+ * \p src by the mask size minus 1.
+ *
+ * \p src is processed in tiles with the overlap-save method. Each tile is
+ * transformed, multiplied by the cached spectrum of the mask and transformed
+ * back. The outputs that are not disturbed by the circular wrap around of the
+ * FFT are stored, and the next tile starts where these outputs end.
+ *
+ * The sums are rounded and clipped for an ::IMGTYPE_UINT8 or
+ * ::IMGTYPE_INT16 \p dst and stored unchanged for an ::IMGTYPE_FLOAT \p dst.
+ */
+static void correlateValid(const image_t *src, image_t *dst, correlationTemplate_t *tmpl)
+{
+    const int32_t tileCols = tmpl->tile->cols;
+    const int32_t tileRows = tmpl->tile->rows;
+    const int32_t stepCols = tileCols - tmpl->mskCols + 1;
+    const int32_t stepRows = tileRows - tmpl->mskRows + 1;
+    const int32_t dstStride = IMAGE_STRIDE(dst);
+
+    const float lo = (dst->type == IMGTYPE_UINT8) ? UINT8_PIXEL_MIN : INT16_PIXEL_MIN;
+    const float hi = (dst->type == IMGTYPE_UINT8) ? UINT8_PIXEL_MAX : INT16_PIXEL_MAX;
+
+    const complex_pixel_t *m = (complex_pixel_t *)tmpl->spectrum->data;
+    complex_pixel_t *p = (complex_pixel_t *)tmpl->product->data;
+
+    for(int32_t y0=0; y0<dst->rows; y0+=stepRows)
+    {
+        const int32_t outRows = ((dst->rows - y0) < stepRows) ? (dst->rows - y0) : stepRows;
+        const int32_t inRows = outRows + tmpl->mskRows - 1;
+
+        for(int32_t x0=0; x0<dst->cols; x0+=stepCols)
+        {
+            const int32_t outCols = ((dst->cols - x0) < stepCols) ? (dst->cols - x0) : stepCols;
+            const int32_t inCols = outCols + tmpl->mskCols - 1;
+
+            fillTile(src, tmpl->tile, x0, y0, inCols, inRows);
+            fft2dReal(tmpl->tile, tmpl->product, &tmpl->plan);
+
+            for(int32_t i=0; i<(tileCols * tileRows); i++)
+            {
+                const complex_pixel_t a = p[i];
+
+                p[i].real = (a.real * m[i].real) - (a.imaginary * m[i].imaginary);
+                p[i].imaginary = (a.real * m[i].imaginary) + (a.imaginary * m[i].real);
+            }
+
+            ifft2d(tmpl->product, tmpl->product, &tmpl->plan);
+
+            // Store the outputs of this tile
+            for(int32_t y=0; y<outRows; y++)
+            {
+                const complex_pixel_t *r = p + (y * tileCols);
+
+                if(dst->type == IMGTYPE_FLOAT)
+                {
+                    float_pixel_t *d = (float_pixel_t *)dst->data + ((y0 + y) * dstStride) + x0;
+
+                    for(int32_t x=0; x<outCols; x++)
+                    {
+                        d[x] = r[x].real;
+                    }
+
+                    continue;
+                }
+
+                for(int32_t x=0; x<outCols; x++)
+                {
+                    float val = floorf(r[x].real + 0.5f);
+
+                    val = (val < lo) ? lo : ((val > hi) ? hi : val);
+
+                    if(dst->type == IMGTYPE_UINT8)
+                    {
+                        *(dst->data + ((y0 + y) * dstStride) + x0 + x) = (uint8_pixel_t)val;
+                    }
+                    else
+                    {
+                        *((int16_pixel_t *)dst->data + ((y0 + y) * dstStride) + x0 + x) = (int16_pixel_t)val;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Creates the cached mask or mask spectrum for correlating images of
+ *        \p cols x \p rows pixels
+ *
+ * Direct correlation takes O(K) operations per pixel for a mask of K pixels,
+ * correlation in the frequency domain O(log N) with a much larger constant.
+ * The crossover is at about 15x15 pixels, so masks of at least
+ * CORRELATE_FFT_MIN_SIZE pixels are correlated in the frequency domain and
+ * smaller masks directly.
+ *
+ * For the FFT, the image with a border is split in tiles of at most
+ * CORRELATE_FFT_TILE pixels, or twice the mask size for very large masks.
+ * The tiles are halved until the spectrum, product and tile buffers fit in
+ * CORRELATE_FFT_MAX_MEMORY bytes. If even tiles of twice the mask size do not
+ * fit, the mask is correlated directly.
+ *
+ * \param[in] msk  A pointer to the mask image. The mask is not needed any
+ *                 more after the template is created.
+ * \param[in] cols The number of columns of the images
+ * \param[in] rows The number of rows of the images
+ *
+ * \return The template
+ */
+correlationTemplate_t newCorrelationTemplate(const image_t *msk, const uint32_t cols,
+                                             const uint32_t rows)
+{
+    // Verify image validity
+    ASSERT(msk == NULL, "msk image is invalid");
+    ASSERT(msk->data == NULL, "msk data is invalid");
+    ASSERT((msk->type != IMGTYPE_INT16) && (msk->type != IMGTYPE_UINT8), "msk type is invalid");
+    ASSERT(msk->rows % 2 == 0, "mask rows must be odd");
+    ASSERT(msk->cols % 2 == 0, "mask cols must be odd");
+
+    const uint32_t padCols = cols + msk->cols - 1;
+    const uint32_t padRows = rows + msk->rows - 1;
+    const uint32_t mskSize = (msk->cols > msk->rows) ? msk->cols : msk->rows;
+
+    uint32_t fft = ((msk->cols * msk->rows) >= CORRELATE_FFT_MIN_SIZE);
+    uint32_t maxTile = CORRELATE_FFT_TILE;
+
+    // Halve the tiles until the buffers fit in the memory budget
+    while(fft)
+    {
+        const uint32_t tilePixels = tileSize(msk->cols, padCols, maxTile) *
+                                    tileSize(msk->rows, padRows, maxTile);
+        const uint32_t bytes = tilePixels * ((2 * sizeof(complex_pixel_t)) + sizeof(float_pixel_t));
+
+        if(bytes <= CORRELATE_FFT_MAX_MEMORY)
+        {
+            break;
+        }
+
+        if(maxTile <= (2 * mskSize))
+        {
+            fft = 0;
+        }
+
+        maxTile /= 2;
+    }
+
+    correlationTemplate_t tmpl =
+    {
+        .cols    = cols,
+        .rows    = rows,
+        .mskCols = msk->cols,
+        .mskRows = msk->rows,
+        .type    = msk->type,
+    };
+
+    if(fft)
+    {
+        tmpl = newTemplate(msk, msk->type, padCols, padRows, maxTile);
+        tmpl.cols = cols;
+        tmpl.rows = rows;
+    }
+    else if(msk->type == IMGTYPE_UINT8)
+    {
+        tmpl.mask = newUint8Image(msk->cols, msk->rows);
+        ASSERT(tmpl.mask == NULL, "unable to allocate memory for the mask");
+        copyUint8Image(msk, tmpl.mask);
+    }
+    else
+    {
+        tmpl.mask = newInt16Image(msk->cols, msk->rows);
+        ASSERT(tmpl.mask == NULL, "unable to allocate memory for the mask");
+        copyInt16Image(msk, tmpl.mask);
+    }
+
+    tmpl.pad = newPaddedImage(msk->type, padCols, padRows);
+    ASSERT(tmpl.pad == NULL, "unable to allocate memory for the border");
+
+    return tmpl;
+}
+
+/*!
+ * \brief Deletes a correlation template
+ *
+ * \param[in,out] tmpl A pointer to the template
+ */
+void deleteCorrelationTemplate(correlationTemplate_t *tmpl)
+{
+    deleteFftPlan(&tmpl->plan);
+    deleteImage(tmpl->product);
+    deleteImage(tmpl->tile);
+    deleteImage(tmpl->pad);
+    deleteImage(tmpl->spectrum);
+    deleteImage(tmpl->mask);
+
+    memset(tmpl, 0, sizeof(correlationTemplate_t));
+}
+
+/*!
+ * \brief Compares two images mathematically with a cached template
+ *
+ * Calculates the same result as correlateBorder() with the mask of the
+ * template, without allocating memory. Templates of large masks correlate in
+ * the frequency domain, see newCorrelationTemplate(), which takes O(log N)
+ * instead of O(K) operations per pixel for a mask of K pixels. These sums are
+ * calculated in single precision floating point, so results can differ by one
+ * from correlateBorder() due to rounding.
+ *
+ * \param[in]     src    A pointer to the source image
+ * \param[out]    dst    A pointer to the destination image
+ * \param[in,out] tmpl   A pointer to the template created by
+ *                       newCorrelationTemplate() for the size of \p src
+ * \param[in]     border The border mode. Must be of type ::eBorder. Constant
+ *                       border pixels are 0.
+ */
+void correlateTemplate(const image_t *src, image_t *dst, correlationTemplate_t *tmpl,
+                       const eBorder border)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
+    ASSERT(src->type != dst->type, "dst type is invalid");
+
+    // Verify parameters
+    ASSERT(tmpl == NULL, "template is invalid");
+    ASSERT(tmpl->pad == NULL, "template is invalid");
+    ASSERT(src->type != tmpl->type, "src type is invalid");
+    ASSERT((tmpl->cols != src->cols) || (tmpl->rows != src->rows), "template has a different size");
+
+    copyWithBorder(src, tmpl->pad, border, 0);
+
+    if(tmpl->mask != NULL)
+    {
+        correlatePadded(tmpl->pad, dst, tmpl->mask);
+    }
+    else
+    {
+        correlateValid(tmpl->pad, dst, tmpl);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Template matching
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Creates the cached data of matchTemplateNCC() for the template
+ *        \p tmpl and images of \p cols x \p rows pixels
+ *
+ * The template is made zero-mean and its spectrum is cached, together with
+ * its energy and the buffers of the integral images and the score map. Create
+ * the data once and pass it to every call of matchTemplateNCC(). Delete it
+ * with deleteNccTemplate() when it is not needed any more.
+ *
+ * \param[in] tmpl A pointer to the template image. The template is not needed
+ *                 any more after the data is created.
+ * \param[in] cols The number of columns of the images
+ * \param[in] rows The number of rows of the images
+ *
+ * \return The cached data
+ */
+nccTemplate_t newNccTemplate(const image_t *tmpl, const uint32_t cols, const uint32_t rows)
+{
+    // Verify image validity
+    ASSERT(tmpl == NULL, "tmpl image is invalid");
+    ASSERT(tmpl->data == NULL, "tmpl data is invalid");
+    ASSERT(tmpl->type != IMGTYPE_UINT8, "tmpl type is invalid");
+
+    // Verify parameters
+    ASSERT((tmpl->cols > (int32_t)cols) || (tmpl->rows > (int32_t)rows), "tmpl is larger than the images");
+
+    const int32_t n = tmpl->cols * tmpl->rows;
+    const int32_t stride = IMAGE_STRIDE(tmpl);
+
+    // Mean of the template
+    int64_t sum = 0;
+
+    for(int32_t y=0; y<tmpl->rows; y++)
+    {
+        for(int32_t x=0; x<tmpl->cols; x++)
+        {
+            sum += tmpl->data[(y * stride) + x];
+        }
+    }
+
+    const float mean = (float)sum / n;
+
+    // Zero-mean template and its energy
+    image_t *zero = newFloatImage(tmpl->cols, tmpl->rows);
+    ASSERT(zero == NULL, "unable to allocate memory for the template");
+
+    float_pixel_t *z = (float_pixel_t *)zero->data;
+    double energy = 0.0;
+
+    for(int32_t y=0; y<tmpl->rows; y++)
+    {
+        for(int32_t x=0; x<tmpl->cols; x++)
+        {
+            const float v = tmpl->data[(y * stride) + x] - mean;
+
+            z[(y * tmpl->cols) + x] = v;
+            energy += (double)v * v;
+        }
+    }
+
+    // A 32-bit window sum of squares is exact for templates up to 66051
+    // pixels, larger templates need a 64-bit integral image of squares
+    const uint32_t wide = ((uint64_t)n * 255 * 255) > UINT32_MAX;
+
+    nccTemplate_t ncc =
+    {
+        .cols        = cols,
+        .rows        = rows,
+        .tmplCols    = tmpl->cols,
+        .tmplRows    = tmpl->rows,
+        .energy      = (float)energy,
+        .correlation = newTemplate(zero, IMGTYPE_UINT8, cols, rows, CORRELATE_FFT_TILE),
+        .integral    = newInt32Image(cols + 1, rows + 1),
+        .integralSq  = wide ? newInt64Image(cols + 1, rows + 1) : newInt32Image(cols + 1, rows + 1),
+        .scores      = newFloatImage(cols - tmpl->cols + 1, rows - tmpl->rows + 1),
+    };
+
+    ASSERT((ncc.integral == NULL) || (ncc.integralSq == NULL) || (ncc.scores == NULL),
+           "unable to allocate memory for the template");
+
+    deleteImage(zero);
+
+    return ncc;
+}
+
+/*!
+ * \brief Deletes the cached data of matchTemplateNCC()
+ *
+ * \param[in,out] ncc A pointer to the cached data
+ */
+void deleteNccTemplate(nccTemplate_t *ncc)
+{
+    deleteImage(ncc->scores);
+    deleteImage(ncc->integralSq);
+    deleteImage(ncc->integral);
+    deleteCorrelationTemplate(&ncc->correlation);
+
+    memset(ncc, 0, sizeof(nccTemplate_t));
+}
+
+/*!
+ * \brief Finds a template in an image by zero-mean normalized
+ *        cross-correlation
+ *
+ * The score of the window with its top-left pixel at (x,y) is
+ *
+ *     sum((I - mean(I)) * (T - mean(T))) /
+ *     sqrt(sum((I - mean(I))^2) * sum((T - mean(T))^2))
+ *
+ * which is 1 for a perfect match and does not change if the brightness or
+ * contrast of the image changes. The numerator equals the correlation of the
+ * image with the zero-mean template, which is calculated in the frequency
+ * domain with the cached template spectrum. The window energy in the
+ * denominator is calculated from an integral image and an integral image of
+ * squares, in constant time per window. The integral image of squares is
+ * 64-bit for templates larger than 66051 pixels, so the energy is exact for
+ * any template size. Windows without contrast get score 0.
+ *
+ * Up to \p n matches are returned in order of decreasing score. A match is
+ * only returned if its window does not overlap the window of a better match
+ * and its score is at least \p minScore.
+ *
+ * \param[in]     src      A pointer to the source image
+ * \param[out]    scores   A pointer to the score map of
+ *                         (cols - tmplCols + 1) x (rows - tmplRows + 1)
+ *                         pixels of type ::IMGTYPE_FLOAT. If NULL, the score
+ *                         map is kept in \p ncc.
+ * \param[in,out] ncc      A pointer to the data created by newNccTemplate()
+ *                         for the size of \p src
+ * \param[out]    matches  Array of at least \p n elements that receives the
+ *                         top-left pixels of the matches
+ * \param[in]     n        The maximum number of matches
+ * \param[in]     minScore The minimum score of a match
+ *
+ * \return The number of matches found
+ */
+uint32_t matchTemplateNCC(const image_t *src, image_t *scores, nccTemplate_t *ncc,
+                          point_t *matches, const uint32_t n, const float minScore)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+
+    // Verify parameters
+    ASSERT(ncc == NULL, "ncc is invalid");
+    ASSERT((ncc->cols != src->cols) || (ncc->rows != src->rows), "ncc has a different size");
+    ASSERT((n > 0) && (matches == NULL), "matches is invalid");
+
+    image_t *s = (scores == NULL) ? ncc->scores : scores;
+
+    ASSERT(s->type != IMGTYPE_FLOAT, "scores type is invalid");
+    ASSERT((s->cols != ncc->scores->cols) || (s->rows != ncc->scores->rows), "scores has an invalid size");
+
+    const int32_t tc = ncc->tmplCols;
+    const int32_t tr = ncc->tmplRows;
+    const int64_t cnt = tc * tr;
+    const int32_t stride = IMAGE_STRIDE(s);
+
+    // Numerator
+    correlateValid(src, s, &ncc->correlation);
+
+    // Denominator
+    integralImage(src, ncc->integral);
+    integralSquaredImage(src, ncc->integralSq);
+
+    for(int32_t y=0; y<s->rows; y++)
+    {
+        float_pixel_t *d = (float_pixel_t *)s->data + (y * stride);
+
+        for(int32_t x=0; x<s->cols; x++)
+        {
+            const int64_t sum = integralRectSum(ncc->integral, x, y, tc, tr);
+            const int64_t sumSq = integralRectSum(ncc->integralSq, x, y, tc, tr);
+
+            // cnt times the energy of the zero-mean window
+            const int64_t var = (cnt * sumSq) - (sum * sum);
+            const float den = sqrtf(((float)var / cnt) * ncc->energy);
+
+            float score = (den > 0.0f) ? (d[x] / den) : 0.0f;
+
+            d[x] = (score > 1.0f) ? 1.0f : ((score < -1.0f) ? -1.0f : score);
+        }
+    }
+
+    // Best matches with non-overlapping windows
+    uint32_t found = 0;
+
+    while(found < n)
+    {
+        float best = minScore;
+        int32_t bx = -1;
+        int32_t by = -1;
+
+        for(int32_t y=0; y<s->rows; y++)
+        {
+            const float_pixel_t *d = (float_pixel_t *)s->data + (y * stride);
+
+            for(int32_t x=0; x<s->cols; x++)
+            {
+                if((d[x] < best) || ((bx >= 0) && (d[x] == best)))
+                {
+                    continue;
+                }
+
+                uint32_t overlap = 0;
+
+                for(uint32_t i=0; (i<found) && (overlap == 0); i++)
+                {
+                    overlap = (abs(matches[i].x - x) < tc) && (abs(matches[i].y - y) < tr);
+                }
+
+                if(overlap == 0)
+                {
+                    best = d[x];
+                    bx = x;
+                    by = y;
+                }
+            }
+        }
+
+        if(bx < 0)
+        {
+            break;
+        }
+
+        matches[found].x = bx;
+        matches[found].y = by;
+        found++;
+    }
+
+    return found;
+}
+
+// ----------------------------------------------------------------------------
+// Image registration
+// ----------------------------------------------------------------------------
+
+/// Regularization of the cross-power spectrum of phaseCorrelate(), as a
+/// fraction of the mean magnitude
+#define PHASE_REGULARIZATION (0.1f)
+
+/*!
+ * \brief Creates the plan and buffers of phaseCorrelate() for images of
+ *        \p cols x \p rows pixels
+ *
+ * The Hann windows and the FFT plan are calculated once. Create the data once
+ * and pass it to every call of phaseCorrelationReference() and
+ * phaseCorrelate(). Delete it with deletePhaseCorrelation() when it is not
+ * needed any more.
+ *
+ * \param[in] cols The number of columns of the images
+ * \param[in] rows The number of rows of the images
+ *
+ * \return The plan and buffers
+ */
+phaseCorrelation_t newPhaseCorrelation(const uint32_t cols, const uint32_t rows)
+{
+    phaseCorrelation_t pc =
+    {
+        .cols      = cols,
+        .rows      = rows,
+        .windowX   = newFloatImage(cols, 1),
+        .windowY   = newFloatImage(rows, 1),
+        .windowed  = newFloatImage(cols, rows),
+        .reference = newComplexImage(cols, rows),
+        .spectrum  = newComplexImage(cols, rows),
+        .product   = newComplexImage(cols, rows),
+        .plan      = newFftPlan(cols, rows),
+    };
+
+    ASSERT((pc.windowX == NULL) || (pc.windowY == NULL) || (pc.windowed == NULL) ||
+           (pc.reference == NULL) || (pc.spectrum == NULL) || (pc.product == NULL),
+           "unable to allocate memory for the phase correlation");
+
+    // The window suppresses the edges of the image, which would otherwise
+    // dominate the spectrum because the FFT treats the image as periodic
+    float_pixel_t *wx = (float_pixel_t *)pc.windowX->data;
+    float_pixel_t *wy = (float_pixel_t *)pc.windowY->data;
+
+    for(uint32_t x=0; x<cols; x++)
+    {
+        wx[x] = (float)(0.5 - (0.5 * cos((2.0 * M_PI * (x + 0.5)) / cols)));
+    }
+
+    for(uint32_t y=0; y<rows; y++)
+    {
+        wy[y] = (float)(0.5 - (0.5 * cos((2.0 * M_PI * (y + 0.5)) / rows)));
+    }
+
+    // No reference yet
+    memset(pc.reference->data, 0, cols * rows * sizeof(complex_pixel_t));
+
+    return pc;
+}
+
+/*!
+ * \brief Deletes the plan and buffers of phaseCorrelate()
+ *
+ * \param[in,out] pc A pointer to the plan and buffers
+ */
+void deletePhaseCorrelation(phaseCorrelation_t *pc)
+{
+    deleteFftPlan(&pc->plan);
+    deleteImage(pc->product);
+    deleteImage(pc->spectrum);
+    deleteImage(pc->reference);
+    deleteImage(pc->windowed);
+    deleteImage(pc->windowY);
+    deleteImage(pc->windowX);
+
+    memset(pc, 0, sizeof(phaseCorrelation_t));
+}
+
+/*!
+ * \brief Calculates the spectrum of the windowed zero-mean image \p src into
+ *        \p spectrum
+ */
+static void phaseSpectrum(const image_t *src, image_t *spectrum, phaseCorrelation_t *pc)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_FLOAT), "src type is invalid");
+
+    // Verify parameters
+    ASSERT(pc == NULL, "pc is invalid");
+    ASSERT((pc->cols != src->cols) || (pc->rows != src->rows), "pc has a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t stride = IMAGE_STRIDE(src);
+
+    const float_pixel_t *wx = (float_pixel_t *)pc->windowX->data;
+    const float_pixel_t *wy = (float_pixel_t *)pc->windowY->data;
+    float_pixel_t *w = (float_pixel_t *)pc->windowed->data;
+
+    // Copy the image and remove the mean, so the window does not leave a
+    // strong low frequency component
+    uint32_t isum = 0;
+    float fsum = 0.0f;
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        float_pixel_t *d = w + (y * cols);
+
+        if(src->type == IMGTYPE_UINT8)
+        {
+            const uint8_pixel_t *s = src->data + (y * stride);
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                d[x] = s[x];
+                isum += s[x];
+            }
+        }
+        else
+        {
+            const float_pixel_t *s = (float_pixel_t *)src->data + (y * stride);
+
+            for(int32_t x=0; x<cols; x++)
+            {
+                d[x] = s[x];
+                fsum += s[x];
+            }
+        }
+    }
+
+    const float sum = (src->type == IMGTYPE_UINT8) ? (float)isum : fsum;
+    const float mean = sum / ((float)cols * rows);
+
+    for(int32_t y=0; y<rows; y++)
+    {
+        float_pixel_t *d = w + (y * cols);
+
+        for(int32_t x=0; x<cols; x++)
+        {
+            d[x] = (d[x] - mean) * wx[x] * wy[y];
+        }
+    }
+
+    fft2dReal(pc->windowed, spectrum, &pc->plan);
+}
+
+/*!
+ * \brief Sets the reference image of phaseCorrelate()
+ *
+ * \param[in]     ref A pointer to the reference image
+ * \param[in,out] pc  A pointer to the data created by newPhaseCorrelation()
+ *                    for the size of \p ref
+ *
+ * \pre \p ref is of type ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ */
+void phaseCorrelationReference(const image_t *ref, phaseCorrelation_t *pc)
+{
+    phaseSpectrum(ref, pc->reference, pc);
+}
+
+/*!
+ * \brief Returns the sub-pixel offset of a peak from the values \p left,
+ *        \p centre and \p right by fitting a parabola
+ */
+static float peakOffset(const float left, const float centre, const float right)
+{
+    const float den = left - (2.0f * centre) + right;
+
+    if(den >= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    const float offset = (0.5f * (left - right)) / den;
+
+    return (offset < -0.5f) ? -0.5f : ((offset > 0.5f) ? 0.5f : offset);
+}
+
+/*!
+ * \brief Estimates the translation of an image with respect to the reference
+ *        image by phase correlation
+ *
+ * Both images are made zero-mean and multiplied by a Hann window. The
+ * normalized cross-power spectrum F(src) * conj(F(ref)) / |F(src) * F(ref)|
+ * only holds the phase difference of the images, so its inverse transform is
+ * a sharp peak at the translation, independent of the image content and
+ * brightness. A small regularization term in the denominator keeps
+ * frequencies without energy from adding noise to the result. The position
+ * of the peak is refined to sub-pixel precision by fitting a parabola through
+ * the peak and its neighbours in each direction.
+ *
+ * For a translation (dx,dy), pixel (x,y) of the reference image is found at
+ * (x+dx,y+dy) in \p src. Translations are found up to half the image size.
+ *
+ * Each call takes one forward and one inverse FFT. To estimate the motion
+ * between consecutive frames, set \p update to 1, so \p src becomes the
+ * reference of the next call without calculating its spectrum again.
+ *
+ * \param[in]     src    A pointer to the source image
+ * \param[in,out] pc     A pointer to the data created by
+ *                       newPhaseCorrelation() for the size of \p src, with a
+ *                       reference image set by phaseCorrelationReference()
+ *                       or a previous call with \p update set
+ * \param[out]    dx     The translation in horizontal direction
+ * \param[out]    dy     The translation in vertical direction
+ * \param[in]     update If 1, \p src becomes the reference image
+ *
+ * \return The height of the correlation peak, from 0 for unrelated images to
+ *         1 for a perfect match
+ *
+ * \pre \p src is of type ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ */
+float phaseCorrelate(const image_t *src, phaseCorrelation_t *pc, float *dx, float *dy,
+                     const uint8_t update)
+{
+    // Verify parameters
+    ASSERT((dx == NULL) || (dy == NULL), "dx or dy is invalid");
+
+    phaseSpectrum(src, pc->spectrum, pc);
+
+    const int32_t cols = pc->cols;
+    const int32_t rows = pc->rows;
+
+    const complex_pixel_t *a = (complex_pixel_t *)pc->spectrum->data;
+    const complex_pixel_t *b = (complex_pixel_t *)pc->reference->data;
+    complex_pixel_t *p = (complex_pixel_t *)pc->product->data;
+
+    // Cross-power spectrum
+    float total = 0.0f;
+
+    for(int32_t i=0; i<(cols * rows); i++)
+    {
+        const float re = (a[i].real * b[i].real) + (a[i].imaginary * b[i].imaginary);
+        const float im = (a[i].imaginary * b[i].real) - (a[i].real * b[i].imaginary);
+
+        p[i].real = re;
+        p[i].imaginary = im;
+        total += sqrtf((re * re) + (im * im));
+    }
+
+    // Normalize. Frequencies without energy only hold noise, which is not
+    // amplified thanks to a regularization term of a fraction of the mean
+    // magnitude. The gain is summed to scale the peak of a perfect match to 1.
+    const float eps = ((PHASE_REGULARIZATION * total) / ((float)cols * rows)) + FLT_MIN;
+    float gain = 0.0f;
+
+    for(int32_t i=0; i<(cols * rows); i++)
+    {
+        const float mag = sqrtf((p[i].real * p[i].real) + (p[i].imaginary * p[i].imaginary));
+
+        p[i].real /= (mag + eps);
+        p[i].imaginary /= (mag + eps);
+        gain += mag / (mag + eps);
+    }
+
+    ifft2d(pc->product, pc->product, &pc->plan);
+
+    // Find the peak
+    int32_t px = 0;
+    int32_t py = 0;
+
+    for(int32_t i=1; i<(cols * rows); i++)
+    {
+        if(p[i].real > p[(py * cols) + px].real)
+        {
+            px = i % cols;
+            py = i / cols;
+        }
+    }
+
+    const float peak = (gain > 0.0f) ? ((p[(py * cols) + px].real * cols * rows) / gain) : 0.0f;
+
+    // Neighbours wrap around, just like the shifts
+    const float centre = p[(py * cols) + px].real;
+    const float left  = p[(py * cols) + ((px + cols - 1) % cols)].real;
+    const float right = p[(py * cols) + ((px + 1) % cols)].real;
+    const float up    = p[(((py + rows - 1) % rows) * cols) + px].real;
+    const float down  = p[(((py + 1) % rows) * cols) + px].real;
+
+    // Shifts above half the image size are negative shifts
+    *dx = (float)(((2 * px) > cols) ? (px - cols) : px) + peakOffset(left, centre, right);
+    *dy = (float)(((2 * py) > rows) ? (py - rows) : py) + peakOffset(up, centre, down);
+
+    if(update)
+    {
+        image_t *tmp = pc->reference;
+        pc->reference = pc->spectrum;
+        pc->spectrum = tmp;
+    }
+
+    return (peak < 0.0f) ? 0.0f : ((peak > 1.0f) ? 1.0f : peak);
+}
+
+// ----------------------------------------------------------------------------
+// Hough transform
+// ----------------------------------------------------------------------------
+
+/// Number of fraction bits of the trigonometry tables of the Hough transform
+#define HOUGH_FRACTION_BITS (14)
+
+/// Largest number of columns and rows of the images of the Hough transform
+#define HOUGH_MAX_SIZE (4096)
+
+/*!
+ * \brief Creates the plan of houghLines() for images of \p cols x \p rows
+ *        pixels
+ *
+ * The angle of the normal of a line is divided in \p angles bins over
+ * [0, pi) and the distance of the line to pixel (0,0) in bins of
+ * \p resolution pixels. The tables hold cos(theta) and sin(theta), divided by
+ * the resolution, as integers with HOUGH_FRACTION_BITS fraction bits, so the
+ * distance bin of a vote is found with a multiplication, an addition and a
+ * shift.
+ *
+ * Create the plan once and pass it to every call of houghLines(). Delete the
+ * plan with deleteHoughPlan() when it is not needed any more.
+ *
+ * \param[in] cols       The number of columns of the images
+ * \param[in] rows       The number of rows of the images
+ * \param[in] angles     The number of angle bins, for example 180 for bins of
+ *                       one degree
+ * \param[in] resolution The width of a distance bin in pixels, at least 0.5
+ *
+ * \return The plan
+ */
+houghPlan_t newHoughPlan(const uint32_t cols, const uint32_t rows,
+                         const uint32_t angles, const float resolution)
+{
+    ASSERT((cols == 0) || (rows == 0), "invalid size");
+    ASSERT((cols > HOUGH_MAX_SIZE) || (rows > HOUGH_MAX_SIZE), "size is too large");
+    ASSERT(angles < 2, "at least two angles are required");
+    ASSERT(resolution < 0.5f, "resolution must be at least 0.5 pixels");
+
+    // The votes of a bin must fit in 16 bits
+    ASSERT(((ceilf(resolution) + 1.0f) * (float)(cols + rows)) > (float)UINT16_MAX,
+           "resolution is too coarse for the image size");
+
+    // Longest possible distance, the extra bin absorbs the rounding of the
+    // tables
+    const float diagonal = sqrtf((float)((cols * cols) + (rows * rows)));
+    const int32_t offset = (int32_t)ceilf(diagonal / resolution) + 1;
+
+    houghPlan_t plan =
+    {
+        .cols        = cols,
+        .rows        = rows,
+        .angles      = angles,
+        .resolution  = resolution,
+        .offset      = offset,
+        .seed        = 1,
+        .cosTable    = newInt32Image(angles, 1),
+        .sinTable    = newInt32Image(angles, 1),
+        .rowTerms    = newInt32Image(angles, 1),
+        .accumulator = newInt16Image((2 * offset) + 1, angles),
+    };
+
+    ASSERT((plan.cosTable == NULL) || (plan.sinTable == NULL) ||
+           (plan.rowTerms == NULL) || (plan.accumulator == NULL),
+           "unable to allocate memory for the plan");
+
+    int32_pixel_t *c = (int32_pixel_t *)plan.cosTable->data;
+    int32_pixel_t *s = (int32_pixel_t *)plan.sinTable->data;
+    const double scale = (double)(1 << HOUGH_FRACTION_BITS) / resolution;
+
+    for(uint32_t a=0; a<angles; a++)
+    {
+        const double theta = (M_PI * a) / angles;
+
+        c[a] = (int32_pixel_t)lround(cos(theta) * scale);
+        s[a] = (int32_pixel_t)lround(sin(theta) * scale);
+    }
+
+    return plan;
+}
+
+/*!
+ * \brief Deletes the plan of houghLines()
+ *
+ * \param[in,out] plan A pointer to the plan
+ */
+void deleteHoughPlan(houghPlan_t *plan)
+{
+    deleteImage(plan->accumulator);
+    deleteImage(plan->rowTerms);
+    deleteImage(plan->sinTable);
+    deleteImage(plan->cosTable);
+
+    memset(plan, 0, sizeof(houghPlan_t));
+}
+
+/*!
+ * \brief Adds the votes of edge pixel (x,y) for all angles
+ *
+ * \param[in,out] plan A pointer to the plan with the row terms of row y
+ * \param[in]     x    The column of the edge pixel
+ */
+static inline void houghVote(houghPlan_t *plan, const int32_t x)
+{
+    const int32_pixel_t *c = (int32_pixel_t *)plan->cosTable->data;
+    const int32_pixel_t *t = (int32_pixel_t *)plan->rowTerms->data;
+    const int32_t stride = IMAGE_STRIDE(plan->accumulator);
+    uint16_t *acc = (uint16_t *)plan->accumulator->data;
+
+    for(int32_t a=0; a<plan->angles; a++)
+    {
+        acc[(t[a] + (x * c[a])) >> HOUGH_FRACTION_BITS]++;
+        acc += stride;
+    }
+}
+
+/*!
+ * \brief Decides if an edge pixel votes in the probabilistic mode
+ *
+ * \param[in,out] plan     A pointer to the plan with the random generator
+ * \param[in]     sampling One out of \p sampling edge pixels votes
+ *
+ * \return 1 if the edge pixel votes, 0 otherwise
+ */
+static inline uint32_t houghSample(houghPlan_t *plan, const uint32_t sampling)
+{
+    if(sampling == 1)
+    {
+        return 1;
+    }
+
+    // Xorshift random generator
+    uint32_t r = plan->seed;
+
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+
+    plan->seed = r;
+
+    return (r % sampling) == 0;
+}
+
+/*!
+ * \brief Moves the accumulator bin (\p a, \p r) to the next angle
+ *
+ * The angle after the last angle is 0 with the distance negated.
+ *
+ * \param[in]     plan A pointer to the plan
+ * \param[in,out] a    The angle bin
+ * \param[in,out] r    The distance bin
+ *
+ * \return 1 if the distance bin is within the accumulator, 0 otherwise
+ */
+static inline uint32_t houghNextAngle(const houghPlan_t *plan, int32_t *a, int32_t *r)
+{
+    if(++(*a) == plan->angles)
+    {
+        *a = 0;
+        *r = (2 * plan->offset) - *r;
+    }
+
+    return (*r >= 0) && (*r < plan->accumulator->cols);
+}
+
+/*!
+ * \brief Finds straight lines in a binary image with the Hough transform
+ *
+ * Every edge pixel (x,y) votes for all lines through it:
+ * \n
+ * rho = x * cos(theta) + y * sin(theta)
+ * \n
+ * The votes are counted in the accumulator of the plan, with fixed-point
+ * tables, so no floating point operations are needed per pixel. Background
+ * pixels are skipped 8 (uint8) or 64 (IMGTYPE_BIN1) at a time.
+ *
+ * The lines are the local maxima of the accumulator. A bin is only a line if
+ * it has more votes than its 8 neighbours and at least \p minVotes votes. A
+ * tie between distances is resolved to the smaller distance. Equal bins along
+ * the angle, which a short line gives, are returned as a single line at the
+ * centre of the run. Angles wrap around, the angle after the last angle is 0
+ * with the distance negated, so a vertical line is returned with theta = 0
+ * and a positive rho even if its run starts near pi. Up to \p n lines are
+ * returned in order of decreasing votes.
+ *
+ * If \p sampling is larger than 1, only a random 1 out of \p sampling edge
+ * pixels votes (probabilistic Hough transform), which makes the transform
+ * about \p sampling times faster. The votes of the lines are then estimated
+ * by multiplying the counted votes by \p sampling.
+ *
+ * \param[in]     src      A pointer to the source image of type
+ *                         ::IMGTYPE_UINT8 or ::IMGTYPE_BIN1. Pixels that are
+ *                         not 0 are edge pixels.
+ * \param[in,out] plan     A pointer to the plan created by newHoughPlan() for
+ *                         the size of \p src
+ * \param[out]    lines    Array of at least \p n elements that receives the
+ *                         lines
+ * \param[in]     n        The maximum number of lines
+ * \param[in]     minVotes The minimum number of edge pixels on a line
+ * \param[in]     sampling 1 to let all edge pixels vote, n to let a random 1
+ *                         out of n edge pixels vote
+ *
+ * \return The number of lines found
+ */
+uint32_t houghLines(const image_t *src, houghPlan_t *plan, houghLine_t *lines,
+                    const uint32_t n, const uint32_t minVotes, const uint32_t sampling)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BIN1), "src type is invalid");
+
+    // Verify parameters
+    ASSERT(plan == NULL, "plan is invalid");
+    ASSERT((plan->cols != src->cols) || (plan->rows != src->rows), "plan has a different size");
+    ASSERT((n > 0) && (lines == NULL), "lines is invalid");
+    ASSERT(sampling == 0, "sampling must be at least 1");
+
+    const int32_t angles = plan->angles;
+    const int32_t bins = plan->accumulator->cols;
+    const int32_t stride = IMAGE_STRIDE(plan->accumulator);
+    const int32_pixel_t *s = (int32_pixel_t *)plan->sinTable->data;
+    int32_pixel_t *t = (int32_pixel_t *)plan->rowTerms->data;
+    uint16_t *acc = (uint16_t *)plan->accumulator->data;
+
+    // Shifts the distances to positive bins and rounds to the nearest bin
+    const int32_t bias = (plan->offset << HOUGH_FRACTION_BITS) + (1 << (HOUGH_FRACTION_BITS - 1));
+
+    memset(acc, 0, (size_t)stride * angles * sizeof(uint16_t));
+
+    // Voting
+    for(int32_t y=0; y<src->rows; y++)
+    {
+        for(int32_t a=0; a<angles; a++)
+        {
+            t[a] = (y * s[a]) + bias;
+        }
+
+        if(src->type == IMGTYPE_BIN1)
+        {
+            const bin1_word_t *p = (bin1_word_t *)src->data + (y * (IMAGE_STRIDE(src) / 64));
+
+            for(int32_t k=0; k<BIN1_WORDS(src->cols); k++)
+            {
+                bin1_word_t w = p[k];
+
+                // Ignore the bits after the last column
+                if((src->cols - (k * 64)) < 64)
+                {
+                    w &= ((bin1_word_t)1 << (src->cols - (k * 64))) - 1;
+                }
+
+                for(int32_t x=k*64; w != 0; x++, w >>= 1)
+                {
+                    if(((w & 1) != 0) && houghSample(plan, sampling))
+                    {
+                        houghVote(plan, x);
+                    }
+                }
+            }
+        }
+        else
+        {
+            const uint8_pixel_t *p = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+
+            for(int32_t x=0; x<src->cols; x++)
+            {
+                // Skip 8 background pixels at a time
+                if(((x % 8) == 0) && ((x + 8) <= src->cols))
+                {
+                    uint64_t w;
+
+                    memcpy(&w, p + x, sizeof(w));
+
+                    if(w == 0)
+                    {
+                        x += 7;
+                        continue;
+                    }
+                }
+
+                if((p[x] != 0) && houghSample(plan, sampling))
+                {
+                    houghVote(plan, x);
+                }
+            }
+        }
+    }
+
+    // Peak extraction
+    uint32_t found = 0;
+
+    for(int32_t a=0; a<angles; a++)
+    {
+        const uint16_t *row = acc + (a * stride);
+
+        // Neighbouring angles wrap around at 0 and pi, where the distance
+        // changes sign
+        const uint16_t *prev = acc + (((a + angles - 1) % angles) * stride);
+        const uint16_t *next = acc + (((a + 1) % angles) * stride);
+        const int32_t prevMirror = (a == 0);
+        const int32_t nextMirror = (a == (angles - 1));
+
+        for(int32_t r=0; r<bins; r++)
+        {
+            const uint32_t v = row[r];
+            const uint32_t votes = v * sampling;
+
+            if((v == 0) || (votes < minVotes))
+            {
+                continue;
+            }
+
+            // Skip if the line would not be stored
+            if((found == n) && ((n == 0) || (votes <= lines[n - 1].votes)))
+            {
+                continue;
+            }
+
+            // Non-maximum suppression, a bin must be larger than the bins
+            // before it and at least as large as the bins after it
+            uint32_t peak = ((r == 0) || (v > row[r - 1])) &&
+                            ((r == (bins - 1)) || (v >= row[r + 1]));
+
+            for(int32_t d=-1; (d<=1) && peak; d++)
+            {
+                const int32_t rp = prevMirror ? ((2 * plan->offset) - (r + d)) : (r + d);
+                const int32_t rn = nextMirror ? ((2 * plan->offset) - (r + d)) : (r + d);
+
+                if((rp >= 0) && (rp < bins) && (v <= prev[rp]))
+                {
+                    peak = 0;
+                }
+
+                if((rn >= 0) && (rn < bins) && (v < next[rn]))
+                {
+                    peak = 0;
+                }
+            }
+
+            if(peak == 0)
+            {
+                continue;
+            }
+
+            // Move the line to the centre of the run of equal bins along the
+            // angle, which may continue across the wrap at pi
+            int32_t endA = a;
+            int32_t endR = r;
+            int32_t lineA = a;
+            int32_t lineR = r;
+
+            for(int32_t run=2; run<=angles; run++)
+            {
+                if(!houghNextAngle(plan, &endA, &endR) || (acc[(endA * stride) + endR] != v))
+                {
+                    break;
+                }
+
+                if((run % 2) == 1)
+                {
+                    houghNextAngle(plan, &lineA, &lineR);
+                }
+            }
+
+            // Keep the lines sorted on decreasing votes
+            uint32_t i = (found < n) ? found++ : (n - 1);
+
+            while((i > 0) && (lines[i - 1].votes < votes))
+            {
+                lines[i] = lines[i - 1];
+                i--;
+            }
+
+            lines[i].rho = (float)(lineR - plan->offset) * plan->resolution;
+            lines[i].theta = (float)((M_PI * lineA) / angles);
+            lines[i].votes = votes;
+        }
+    }
+
+    return found;
 }
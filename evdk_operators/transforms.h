@@ -41,17 +41,167 @@ extern "C" {
 
 #include "image.h"
 
-/// \brief Type definition of a complex pixel
-/// Two floats per pixel
-typedef struct complex_pixel_t
+/// Maximum number of radices in the factorization of a transform length
+#define FFT_MAX_FACTORS (32)
+
+/// Precomputed data of a two dimensional FFT of a fixed size
+///
+/// The plan is created once by newFftPlan() and reused for every frame, so
+/// the twiddle factors are not recalculated and the transforms do not
+/// allocate memory.
+typedef struct
+{
+    int32_t  cols;        ///< Number of columns of the images
+    int32_t  rows;        ///< Number of rows of the images
+    int32_t  colFactors[2 * FFT_MAX_FACTORS]; ///< Pairs of radix and remaining
+                                              ///< length for the row transforms
+    int32_t  rowFactors[2 * FFT_MAX_FACTORS]; ///< Pairs of radix and remaining
+                                              ///< length for the column transforms
+    image_t *colTwiddles; ///< exp(-2*pi*i*k/cols) for k = 0..cols-1
+    image_t *rowTwiddles; ///< exp(-2*pi*i*k/rows) for k = 0..rows-1
+    image_t *line;        ///< Input and output buffer of a single row or column
+    image_t *scratch;     ///< Scratch buffer of the butterflies
+
+}fftPlan_t;
+
+/// Maximum size of the FFT tiles of correlateTemplate()
+#define CORRELATE_FFT_TILE (256)
+
+/// Number of mask pixels from which correlateTemplate() correlates in the
+/// frequency domain
+#define CORRELATE_FFT_MIN_SIZE (225)
+
+/// Maximum number of bytes of the FFT buffers of a correlation template
+#define CORRELATE_FFT_MAX_MEMORY (128 * 1024)
+
+/// Cached mask or mask spectrum for correlating images of a fixed size
+///
+/// The template is created once by newCorrelationTemplate() and reused for
+/// every frame. For small masks it holds a copy of the mask, for large masks
+/// the spectrum of the mask, so correlateTemplate() only calculates the
+/// spectrum of the image and the inverse transform.
+typedef struct
+{
+    int32_t    cols;     ///< Number of columns of the images
+    int32_t    rows;     ///< Number of rows of the images
+    int32_t    mskCols;  ///< Number of columns of the mask
+    int32_t    mskRows;  ///< Number of rows of the mask
+    eImageType type;     ///< Type of the mask and the images
+    image_t   *mask;     ///< Copy of the mask for direct correlation, NULL if
+                         ///< the FFT is used
+    image_t   *spectrum; ///< Complex conjugate of the spectrum of the mask
+    image_t   *pad;      ///< Source image with a border
+    image_t   *tile;     ///< A tile of the image with a border
+    image_t   *product;  ///< Spectrum of a tile, multiplied by the mask spectrum
+    fftPlan_t  plan;     ///< Plan of the FFT of a tile
+
+}correlationTemplate_t;
+
+/// Cached data of matchTemplateNCC() for a template and images of a fixed
+/// size
+typedef struct
+{
+    int32_t               cols;        ///< Number of columns of the images
+    int32_t               rows;        ///< Number of rows of the images
+    int32_t               tmplCols;    ///< Number of columns of the template
+    int32_t               tmplRows;    ///< Number of rows of the template
+    float                 energy;      ///< Sum of the squared zero-mean template
+    correlationTemplate_t correlation; ///< Spectrum of the zero-mean template
+    image_t              *integral;    ///< Integral image of the source image
+    image_t              *integralSq;  ///< Integral image of the squared source image,
+                                       ///< 64-bit for templates over 66051 pixels
+    image_t              *scores;      ///< Score map
+
+}nccTemplate_t;
+
+/// Plan and buffers of phaseCorrelate() for images of a fixed size
+typedef struct
+{
+    int32_t   cols;      ///< Number of columns of the images
+    int32_t   rows;      ///< Number of rows of the images
+    image_t  *windowX;   ///< Hann window along the rows
+    image_t  *windowY;   ///< Hann window along the columns
+    image_t  *windowed;  ///< Windowed zero-mean image
+    image_t  *reference; ///< Spectrum of the reference image
+    image_t  *spectrum;  ///< Spectrum of the current image
+    image_t  *product;   ///< Normalized cross-power spectrum and its inverse
+    fftPlan_t plan;      ///< Plan of the FFT
+
+}phaseCorrelation_t;
+
+/// A line x * cos(theta) + y * sin(theta) = rho found by houghLines()
+typedef struct
+{
+    float    rho;   ///< Signed distance of the line to pixel (0,0) in pixels
+    float    theta; ///< Angle of the normal of the line in radians, [0, pi)
+    uint32_t votes; ///< Number of edge pixels on the line
+
+}houghLine_t;
+
+/// Trigonometry tables and vote accumulator of houghLines()
+///
+/// The plan is created once by newHoughPlan() and reused for every frame, so
+/// the tables are not recalculated and the transform does not allocate
+/// memory.
+typedef struct
 {
-    float real;      ///< real part of the complex number
-    float imaginary; ///< imaginary part of the complex number
+    int32_t  cols;        ///< Number of columns of the images
+    int32_t  rows;        ///< Number of rows of the images
+    int32_t  angles;      ///< Number of angle bins over [0, pi)
+    float    resolution;  ///< Width of a rho bin in pixels
+    int32_t  offset;      ///< Rho bin of rho = 0
+    uint32_t seed;        ///< State of the random generator that samples the
+                          ///< edge pixels
+    image_t *cosTable;    ///< cos(theta) / resolution in fixed point
+    image_t *sinTable;    ///< sin(theta) / resolution in fixed point
+    image_t *rowTerms;    ///< y * sin(theta) / resolution of the current row
+    image_t *accumulator; ///< Votes, one row of rho bins per angle
 
-}complex_pixel_t;
+}houghPlan_t;
 
 // Functions are documented in the source file
 
+complex_pixel_t getComplexPixel(const image_t *img, const int32_t c, const int32_t r);
+void setComplexPixel(const image_t *img, const int32_t c, const int32_t r, const complex_pixel_t value);
+
+/// \name Functions for the fast Fourier transform
+/// \{
+fftPlan_t newFftPlan(const uint32_t cols, const uint32_t rows);
+void deleteFftPlan(fftPlan_t *plan);
+void fft2d(const image_t *src, image_t *dst, fftPlan_t *plan);
+void fft2dReal(const image_t *src, image_t *dst, fftPlan_t *plan);
+void ifft2d(const image_t *src, image_t *dst, fftPlan_t *plan);
+uint32_t fftFastSize(const uint32_t n);
+/// \}
+
+/// \name Functions for correlation in the frequency domain
+/// \{
+correlationTemplate_t newCorrelationTemplate(const image_t *msk, const uint32_t cols, const uint32_t rows);
+void deleteCorrelationTemplate(correlationTemplate_t *tmpl);
+void correlateTemplate(const image_t *src, image_t *dst, correlationTemplate_t *tmpl, const eBorder border);
+/// \}
+
+/// \name Functions for template matching
+/// \{
+nccTemplate_t newNccTemplate(const image_t *tmpl, const uint32_t cols, const uint32_t rows);
+void deleteNccTemplate(nccTemplate_t *ncc);
+uint32_t matchTemplateNCC(const image_t *src, image_t *scores, nccTemplate_t *ncc, point_t *matches, const uint32_t n, const float minScore);
+/// \}
+
+/// \name Functions for image registration
+/// \{
+phaseCorrelation_t newPhaseCorrelation(const uint32_t cols, const uint32_t rows);
+void deletePhaseCorrelation(phaseCorrelation_t *pc);
+void phaseCorrelationReference(const image_t *ref, phaseCorrelation_t *pc);
+float phaseCorrelate(const image_t *src, phaseCorrelation_t *pc, float *dx, float *dy, const uint8_t update);
+/// \}
+
+/// \name Functions for the Hough transform
+/// \{
+houghPlan_t newHoughPlan(const uint32_t cols, const uint32_t rows, const uint32_t angles, const float resolution);
+void deleteHoughPlan(houghPlan_t *plan);
+uint32_t houghLines(const image_t *src, houghPlan_t *plan, houghLine_t *lines, const uint32_t n, const uint32_t minVotes, const uint32_t sampling);
+/// \}
 
 
 #endif // _TRANSFORMS_H_
@@ -1417,6 +1417,13 @@ void exampleFinalAssignment(void)
         }
     }
 
+    // Otsu's threshold on a grid of every second pixel, only searched again
+    // if 5% of the pixels changed bin, and smoothed over frames
+    thresholdTracker_t tracker = newThresholdTracker(THRESHOLD_OTSU, 2, 0.25f, 0.05f);
+
+    // Maps the binary values to 0 and 255 for display
+    lut_t display = lutBinaryToDisplay();
+
     while (1U)
     {
         // ---------------------------------------------------------------
@@ -1446,13 +1453,10 @@ void exampleFinalAssignment(void)
         copyUint8Image(dst, tmp);
 
         // Apply thresholding using Otsu's method
-        thresholdOtsu(dst, dst, BRIGHTNESS_DARK);
+        thresholdTracked(dst, dst, BRIGHTNESS_DARK, &tracker);
 
         // Scale binary values for display (0->0, 1->255)
-        for (uint32_t i = 0; i < EVDK5_WIDTH * EVDK5_HEIGHT; i++)
-        {
-            tmp->data[i] = dst->data[i] * 255;
-        }
+        applyLut(dst, tmp, display.table);
 
         // Remove border blobs
         removeBorderBlobsTwoPass(dst, dst, CONNECTED_FOUR, 200);
@@ -1464,10 +1468,7 @@ void exampleFinalAssignment(void)
         ms2 = ms;
 
         // Update display image with the post-processed binary image
-        for (uint32_t i = 0; i < EVDK5_WIDTH * EVDK5_HEIGHT; i++)
-        {
-            tmp->data[i] = dst->data[i] * 255;
-        }
+        applyLut(dst, tmp, display.table);
 
         // Find the largest object
         uint32_t largestObjectLabel = 0;
@@ -66,6 +66,11 @@ int main(void)
     RUN_TEST(test_brightness);
     RUN_TEST(test_contrast);
     RUN_TEST(test_histogram);
+    RUN_TEST(test_histogramStats);
+    RUN_TEST(test_applyLut);
+    RUN_TEST(test_lutCompose);
+    RUN_TEST(test_equalize);
+    RUN_TEST(test_clahe);
     //printf("\n");
 
     printf("IMAGE FUNDAMENTALS\n");
@@ -73,6 +78,13 @@ int main(void)
     RUN_TEST(test_scaleFast);
     RUN_TEST(test_convolve);
     RUN_TEST(test_convolveFast);
+    RUN_TEST(test_roiImage);
+    RUN_TEST(test_imagePool);
+    RUN_TEST(test_newPaddedImage);
+    RUN_TEST(test_copyWithBorder);
+    RUN_TEST(test_convolveSeparable);
+    RUN_TEST(test_integralImage);
+    RUN_TEST(test_convertUint8ToBin1);
     //printf("\n");
 
     printf("MENSURATION\n");
@@ -93,6 +105,7 @@ int main(void)
     RUN_TEST(test_removeBorderBlobsIterative);
     RUN_TEST(test_removeBorderBlobsTwoPass);
     RUN_TEST(test_skeleton);
+    RUN_TEST(test_morphologyBin1);
     //printf("\n");
 
     printf("NOISE\n");
@@ -115,6 +128,10 @@ int main(void)
     RUN_TEST(test_thresholdOptimum);
     RUN_TEST(test_threshold2Means);
     RUN_TEST(test_thresholdOtsu);
+    RUN_TEST(test_thresholdMultiOtsu);
+    RUN_TEST(test_thresholdAdaptive);
+    RUN_TEST(test_thresholdAdaptiveLargeWindow);
+    RUN_TEST(test_thresholdTracked);
     RUN_TEST(test_lineDetector);
     //printf("\n");
 
@@ -123,14 +140,20 @@ int main(void)
     RUN_TEST(test_laplacian);
     RUN_TEST(test_sobel);
     RUN_TEST(test_sobelFast);
+    RUN_TEST(test_sobelGradient);
+    RUN_TEST(test_canny);
     //printf("\n");
 
     printf("SPATIAL FREQUENCY FILTERS\n");
-    //RUN_TEST();
+    RUN_TEST(test_frequencyFilter);
     //printf("\n");
 
     printf("TRANSFORMS\n");
-    //RUN_TEST();
+    RUN_TEST(test_fft2d);
+    RUN_TEST(test_correlateTemplate);
+    RUN_TEST(test_matchTemplateNCC);
+    RUN_TEST(test_phaseCorrelate);
+    RUN_TEST(test_houghLines);
     //printf("\n");
 
     return UNITY_END();
@@ -64,6 +64,257 @@ void test_histogram(void)
     TEST_ASSERT_EQUAL_MESSAGE(1, hist[255], "histogram value incorrect");
 }
 
+void test_histogramStats(void)
+{
+    uint8_pixel_t src_data[7 * 3] =
+    {
+        9,   3,   3,   3,   3, 200,   9,
+        9,   4,   5,   6,   7, 201,   9,
+        9,   9,   9,   9,   9,   9,   9,
+    };
+
+    uint8_pixel_t msk_data[7 * 3] =
+    {
+        0,   1,   1,   0,   0,   1,   0,
+        0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,
+    };
+
+    // Prepare images
+    image_t src = {7, 3, IMGTYPE_UINT8, src_data};
+    image_t msk = {7, 3, IMGTYPE_UINT8, msk_data};
+
+    // Prepare histogram
+    uint32_t hist[256];
+
+    // Test case 1: all pixels
+    histogramStats_t stats = histogramStats(&src, NULL, hist);
+
+    TEST_ASSERT_EQUAL_MESSAGE(21, stats.count, "Test case 1 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(534, stats.sum, "Test case 1 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(3, stats.min, "Test case 1 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(201, stats.max, "Test case 1 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(11, hist[9], "Test case 1 of 3");
+
+    // Test case 2: region of interest
+    image_t roi = roiImage(&src, 1, 0, 5, 2);
+    stats = histogramStats(&roi, NULL, hist);
+
+    TEST_ASSERT_EQUAL_MESSAGE(10, stats.count, "Test case 2 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(3, stats.min, "Test case 2 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(4, hist[3], "Test case 2 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(0, hist[9], "Test case 2 of 3");
+
+    // Test case 3: mask
+    stats = histogramStats(&src, &msk, hist);
+
+    TEST_ASSERT_EQUAL_MESSAGE(3, stats.count, "Test case 3 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(206, stats.sum, "Test case 3 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(3, stats.min, "Test case 3 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(200, stats.max, "Test case 3 of 3");
+    TEST_ASSERT_EQUAL_MESSAGE(2, hist[3], "Test case 3 of 3");
+}
+
+void test_applyLut(void)
+{
+    uint8_pixel_t src_data[7 * 2] =
+    {
+        0,   1,   2,   3,   4,   5,   6,
+        9,   9,   9,   9,   9,   9, 255,
+    };
+
+    uint8_pixel_t exp_data[5 * 2] =
+    {
+      254, 253, 252, 251, 250,
+      246, 246, 246, 246, 246,
+    };
+
+    uint8_pixel_t dst_data[5 * 2] = {0};
+
+    // Prepare lookup table
+    uint8_pixel_t lut[256];
+
+    for(uint32_t i=0; i<256; ++i)
+    {
+        lut[i] = 255 - i;
+    }
+
+    // Prepare images
+    image_t src = {7, 2, IMGTYPE_UINT8, src_data};
+    image_t exp = {5, 2, IMGTYPE_UINT8, exp_data};
+    image_t dst = {5, 2, IMGTYPE_UINT8, dst_data};
+
+    // Execute the operator on a region of interest
+    image_t roi = roiImage(&src, 1, 0, 5, 2);
+    applyLut(&roi, &dst, lut);
+
+    // Verify the result
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), "Test case 1 of 1");
+}
+
+void test_lutCompose(void)
+{
+    uint8_pixel_t src_data[6 * 2] =
+    {
+        0,  40,  49,  50,  60, 100,
+      149, 150, 151, 200, 250, 255,
+    };
+
+    uint8_pixel_t exp_data[6 * 2] =
+    {
+        0,   0,   0, 255, 255, 255,
+      255, 255,   0,   0,   0,   0,
+    };
+
+    uint8_pixel_t dst_data[6 * 2] = {0};
+
+    // Prepare images
+    image_t src = {6, 2, IMGTYPE_UINT8, src_data};
+    image_t exp = {6, 2, IMGTYPE_UINT8, exp_data};
+    image_t dst = {6, 2, IMGTYPE_UINT8, dst_data};
+
+    // Test case 1: brightness, threshold and display in a single pass
+    lut_t add = lutBrightness(50);
+    lut_t thr = lutThreshold(100, 200);
+    lut_t display = lutBinaryToDisplay();
+    lut_t chain = lutCompose(&add, &thr);
+    chain = lutCompose(&chain, &display);
+
+    applyLut(&src, &dst, chain.table);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), "Test case 1 of 4");
+
+    // Test case 2: values outside the range of scale() are clipped
+    lut_t scl = lutScale(40, 200);
+
+    TEST_ASSERT_EQUAL_MESSAGE(0, scl.table[0], "Test case 2 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(0, scl.table[40], "Test case 2 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(128, scl.table[120], "Test case 2 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(255, scl.table[200], "Test case 2 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(255, scl.table[250], "Test case 2 of 4");
+
+    // Test case 3: only the selected value changes
+    lut_t sel = lutSelectedToValue(9, 77);
+
+    TEST_ASSERT_EQUAL_MESSAGE(8, sel.table[8], "Test case 3 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(77, sel.table[9], "Test case 3 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(10, sel.table[10], "Test case 3 of 4");
+
+    // Test case 4: the identity does not change a lookup table
+    lut_t id = lutIdentity();
+    lut_t same = lutCompose(&id, &sel);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(sel.table, same.table, 256, "Test case 4 of 4");
+}
+
+void test_equalize(void)
+{
+    uint8_pixel_t src_data[4 * 4] =
+    {
+       10,  10,  10,  10,
+       20,  20,  20,  20,
+       20,  20,  30,  30,
+       30,  30,  30, 250,
+    };
+
+    uint8_pixel_t exp_data_test_case_01[4 * 4] =
+    {
+        0,   0,   0,   0,
+      128, 128, 128, 128,
+      128, 128, 234, 234,
+      234, 234, 234, 255,
+    };
+
+    uint8_pixel_t src_data_test_case_02[4 * 4] =
+    {
+       77,  77,  77,  77,
+       77,  77,  77,  77,
+       77,  77,  77,  77,
+       77,  77,  77,  77,
+    };
+
+    uint8_pixel_t dst_data[4 * 4] = {0};
+
+    // Prepare images
+    image_t src = {4, 4, IMGTYPE_UINT8, src_data};
+    image_t exp = {4, 4, IMGTYPE_UINT8, exp_data_test_case_01};
+    image_t dst = {4, 4, IMGTYPE_UINT8, dst_data};
+
+    // Test case 1: the few bright pixels do not compress the other values
+    equalize(&src, &dst);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), "Test case 1 of 2");
+
+    // Test case 2: a constant image does not change
+    src.data = src_data_test_case_02;
+    equalize(&src, &src);
+
+    for(uint32_t i=0; i<(4 * 4); ++i)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(77, src_data_test_case_02[i], "Test case 2 of 2");
+    }
+}
+
+void test_clahe(void)
+{
+    uint8_pixel_t src_data[4 * 4] =
+    {
+       10,  10,  10,  10,
+       20,  20,  20,  20,
+       20,  20,  30,  30,
+       30,  30,  30, 250,
+    };
+
+    uint8_pixel_t exp_data_test_case_01[4 * 4] =
+    {
+       64,  64,  64,  64,
+      159, 159, 159, 159,
+      159, 159, 239, 239,
+      239, 239, 239, 255,
+    };
+
+    uint8_pixel_t dst_data[8 * 8] = {0};
+
+    // Test case 1: a single tile without clipping maps the cumulative
+    // histogram
+    image_t src = {4, 4, IMGTYPE_UINT8, src_data};
+    image_t exp = {4, 4, IMGTYPE_UINT8, exp_data_test_case_01};
+    image_t dst = {4, 4, IMGTYPE_UINT8, dst_data};
+
+    clahe_t c = newClahe(4, 4, 1, 1, 256.0f);
+    clahe(&src, &dst, &c);
+    deleteClahe(&c);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), "Test case 1 of 3");
+
+    // Test case 2 and 3: the clip limit limits the contrast of flat tiles
+    uint8_pixel_t flat_data[8 * 8];
+    memset(flat_data, 100, sizeof(flat_data));
+
+    image_t flat = {8, 8, IMGTYPE_UINT8, flat_data};
+    dst.cols = 8;
+    dst.rows = 8;
+
+    const float clipLimit[2] = {1.0f, 40.0f};
+    const uint8_pixel_t expected[2] = {112, 128};
+
+    for(uint32_t i=0; i<2; ++i)
+    {
+        // Set test case name
+        char name[80] = "";
+        sprintf(name, "Test case %d of %d", i+2, 3);
+
+        c = newClahe(8, 8, 2, 2, clipLimit[i]);
+        clahe(&flat, &dst, &c);
+        deleteClahe(&c);
+
+        for(uint32_t j=0; j<(8 * 8); ++j)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(expected[i], dst_data[j], name);
+        }
+    }
+}
+
 void test_brightness(void)
 {
     // Prepare images for testing
@@ -37,6 +37,21 @@
 /// \brief Unit test function for histogram()
 void test_histogram(void);
 
+/// \brief Unit test function for histogramStats()
+void test_histogramStats(void);
+
+/// \brief Unit test function for applyLut()
+void test_applyLut(void);
+
+/// \brief Unit test function for lutCompose() and the lookup table builders
+void test_lutCompose(void);
+
+/// \brief Unit test function for equalize()
+void test_equalize(void);
+
+/// \brief Unit test function for clahe()
+void test_clahe(void);
+
 /// \brief Unit test function for brightness()
 void test_brightness(void);
 
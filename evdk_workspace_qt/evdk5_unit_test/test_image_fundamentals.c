@@ -717,3 +717,474 @@ void test_convolveFast(void)
         TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
     }
 }
+
+void test_roiImage(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data_test_case_01[8 * 8] =
+    {
+        200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200,  10, 150,  20, 160, 200, 200,
+        200, 200, 150,  10, 160,  20, 200, 200,
+        200, 200,  30, 170,  40, 180, 200, 200,
+        200, 200, 170,  30, 180,  40, 200, 200,
+        200, 200, 200, 200, 200, 200, 200, 200,
+        200, 200, 200, 200, 200, 200, 200, 200,
+    };
+
+    uint8_pixel_t exp_data_test_case_01[8 * 8] =
+    {
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170,   0,   1,   0,   1, 170, 170,
+        170, 170,   1,   0,   1,   0, 170, 170,
+        170, 170,   0,   1,   0,   1, 170, 170,
+        170, 170,   1,   0,   1,   0, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+        170, 170, 170, 170, 170, 170, 170, 170,
+    };
+
+    uint8_pixel_t dst_data[8 * 8];
+
+    // Prepare images
+    image_t src = {8,8, IMGTYPE_UINT8, src_data_test_case_01};
+    image_t exp = {8,8, IMGTYPE_UINT8, exp_data_test_case_01};
+    image_t dst = {8,8, IMGTYPE_UINT8, dst_data};
+
+    memset(dst_data, 170, sizeof(dst_data));
+
+    // Create views of the 4x4 region in the center of both images
+    image_t srcRoi = roiImage(&src, 2, 2, 4, 4);
+    image_t dstRoi = roiImage(&dst, 2, 2, 4, 4);
+
+    // Verify the views
+    TEST_ASSERT_EQUAL(4, srcRoi.cols);
+    TEST_ASSERT_EQUAL(4, srcRoi.rows);
+    TEST_ASSERT_EQUAL(8, IMAGE_STRIDE(&srcRoi));
+    TEST_ASSERT_FALSE(IMAGE_IS_PACKED(&srcRoi));
+    TEST_ASSERT_EQUAL(10, getUint8Pixel(&srcRoi, 0, 0));
+    TEST_ASSERT_EQUAL(40, getUint8Pixel(&srcRoi, 3, 3));
+
+    // Execute an operator on the views, only the region must be written
+    threshold(&srcRoi, &dstRoi, 100, 255);
+
+#if 0 // Change 0 to 1 to enable printing
+
+    // Print image data
+    prettyprint(&src, "src");
+    prettyprint(&exp, "exp");
+    prettyprint(&dst, "dst");
+
+#endif
+
+    // Verify the result
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), "Test case 1 of 1");
+}
+
+void test_imagePool(void)
+{
+    image_t *imgs[32];
+
+    // More images than the previous fixed limit of 16 images
+    for(uint32_t i=0; i < 32; ++i)
+    {
+        imgs[i] = newUint8Image(16, 8);
+        TEST_ASSERT_NOT_NULL(imgs[i]);
+        TEST_ASSERT_NOT_NULL(imgs[i]->data);
+        TEST_ASSERT_EQUAL(16, imgs[i]->cols);
+        TEST_ASSERT_EQUAL(8, imgs[i]->rows);
+        TEST_ASSERT_EQUAL(16, IMAGE_STRIDE(imgs[i]));
+        TEST_ASSERT_EQUAL(IMGTYPE_UINT8, imgs[i]->type);
+    }
+
+    // A deleted image is reused by the next image of the same size
+    uint8_t *data = imgs[5]->data;
+    deleteUint8Image(imgs[5]);
+    imgs[5] = newUint8Image(16, 8);
+    TEST_ASSERT_EQUAL_PTR(data, imgs[5]->data);
+
+    // Per-frame release only deletes the images created after the mark
+    uint32_t mark = imagePoolMark();
+    image_t *tmp1 = newInt16Image(16, 8);
+    image_t *tmp2 = newFloatImage(16, 8);
+    TEST_ASSERT_NOT_NULL(tmp1);
+    TEST_ASSERT_NOT_NULL(tmp2);
+    data = tmp2->data;
+    imagePoolRelease(mark);
+
+    tmp2 = newFloatImage(16, 8);
+    TEST_ASSERT_EQUAL_PTR(data, tmp2->data);
+
+    // Images created before the mark are still valid
+    setUint8Pixel(imgs[31], 15, 7, 123);
+    TEST_ASSERT_EQUAL(123, getUint8Pixel(imgs[31], 15, 7));
+
+    // Empty images have no data
+    image_t *empty = newEmptyBgr888Image(16, 8);
+    TEST_ASSERT_NOT_NULL(empty);
+    TEST_ASSERT_NULL(empty->data);
+
+    deleteAllImages();
+}
+
+void test_newPaddedImage(void)
+{
+    // Strides are rounded up to a multiple of IMAGE_ALIGNMENT bytes
+    TEST_ASSERT_EQUAL(64, getPaddedStride(IMGTYPE_UINT8, 13));
+    TEST_ASSERT_EQUAL(128, getPaddedStride(IMGTYPE_UINT8, 65));
+    TEST_ASSERT_EQUAL(32, getPaddedStride(IMGTYPE_INT16, 13));
+    TEST_ASSERT_EQUAL(16, getPaddedStride(IMGTYPE_FLOAT, 13));
+    TEST_ASSERT_EQUAL(64, getPaddedStride(IMGTYPE_BGR888, 13));
+
+    // Regular images are aligned, but not padded
+    image_t *img = newUint8Image(13, 5);
+    TEST_ASSERT_EQUAL(0, ((uintptr_t)img->data) % IMAGE_ALIGNMENT);
+    TEST_ASSERT_TRUE(IMAGE_IS_PACKED(img));
+    TEST_ASSERT_FALSE(isAlignedImage(img));
+
+    // Padded images are aligned and padded
+    image_t *src = newPaddedImage(IMGTYPE_UINT8, 13, 5);
+    image_t *dst = newPaddedImage(IMGTYPE_UINT8, 13, 5);
+    TEST_ASSERT_EQUAL(13, src->cols);
+    TEST_ASSERT_EQUAL(5, src->rows);
+    TEST_ASSERT_EQUAL(64, IMAGE_STRIDE(src));
+    TEST_ASSERT_TRUE(isAlignedImage(src));
+    TEST_ASSERT_TRUE(isAlignedImage(dst));
+
+    // Operators give the same result for padded and packed images
+    image_t *exp = newUint8Image(13, 5);
+    for(int32_t y=0; y < 5; ++y)
+    {
+        for(int32_t x=0; x < 13; ++x)
+        {
+            setUint8Pixel(img, x, y, (uint8_pixel_t)(10 + x + y * 13));
+        }
+    }
+
+    copyUint8Image(img, src);
+    scaleFast(img, exp);
+    scaleFast(src, dst);
+
+    for(int32_t y=0; y < 5; ++y)
+    {
+        for(int32_t x=0; x < 13; ++x)
+        {
+            TEST_ASSERT_EQUAL(getUint8Pixel(exp, x, y), getUint8Pixel(dst, x, y));
+        }
+    }
+
+    deleteAllImages();
+}
+
+void test_copyWithBorder(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[3 * 2] =
+    {
+        1, 2, 3,
+        4, 5, 6,
+    };
+
+    uint8_pixel_t exp_data_test_case_01[7 * 4] =
+    {
+        9, 9, 9, 9, 9, 9, 9,
+        9, 9, 1, 2, 3, 9, 9,
+        9, 9, 4, 5, 6, 9, 9,
+        9, 9, 9, 9, 9, 9, 9,
+    };
+
+    uint8_pixel_t exp_data_test_case_02[7 * 4] =
+    {
+        1, 1, 1, 2, 3, 3, 3,
+        1, 1, 1, 2, 3, 3, 3,
+        4, 4, 4, 5, 6, 6, 6,
+        4, 4, 4, 5, 6, 6, 6,
+    };
+
+    uint8_pixel_t exp_data_test_case_03[7 * 4] =
+    {
+        2, 1, 1, 2, 3, 3, 2,
+        2, 1, 1, 2, 3, 3, 2,
+        5, 4, 4, 5, 6, 6, 5,
+        5, 4, 4, 5, 6, 6, 5,
+    };
+
+    uint8_pixel_t exp_data_test_case_04[7 * 4] =
+    {
+        5, 6, 4, 5, 6, 4, 5,
+        2, 3, 1, 2, 3, 1, 2,
+        5, 6, 4, 5, 6, 4, 5,
+        2, 3, 1, 2, 3, 1, 2,
+    };
+
+    uint8_pixel_t dst_data[7 * 4];
+
+    typedef struct testcase_t
+    {
+        eBorder border;
+        uint8_pixel_t *exp_data;
+    }testcase_t;
+
+    // Compose array of test cases
+    testcase_t testcases[] =
+    {
+        {BORDER_CONSTANT,  exp_data_test_case_01},
+        {BORDER_REPLICATE, exp_data_test_case_02},
+        {BORDER_REFLECT,   exp_data_test_case_03},
+        {BORDER_WRAP,      exp_data_test_case_04},
+    };
+
+    // Prepare images
+    image_t src = {3,2, IMGTYPE_UINT8, src_data};
+    image_t exp = {7,4, IMGTYPE_UINT8, NULL};
+    image_t dst = {7,4, IMGTYPE_UINT8, dst_data};
+
+    // Loop all test cases
+    for(uint32_t i=0; i < (sizeof(testcases) / sizeof(testcase_t)); ++i)
+    {
+        // Set the data
+        exp.data = testcases[i].exp_data;
+
+        // Execute the operator
+        copyWithBorder(&src, &dst, testcases[i].border, 9);
+
+        // Set test case name
+        char name[80] = "";
+        sprintf(name, "Test case %d of %d", i+1, (uint32_t)(sizeof(testcases) / sizeof(testcase_t)));
+
+#if 0 // Change 0 to 1 to enable printing
+
+        // Print testcase info
+        printf("\n---------------------------------------\n");
+        printf("%s\n", name);
+
+        // Print image data
+        prettyprint(&src, "src");
+        prettyprint(&exp, "exp");
+        prettyprint(&dst, "dst");
+
+#endif
+
+        // Verify the result
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), name);
+    }
+}
+
+void test_convolveSeparable(void)
+{
+    // Prepare images for testing
+    int16_pixel_t src_data[8 * 8];
+    int16_pixel_t exp_data[8 * 8];
+    int16_pixel_t dst_data[8 * 8];
+    int16_pixel_t msk_data[3 * 3];
+    uint8_pixel_t src_data_uint8[8 * 8];
+    uint8_pixel_t dst_data_uint8[8 * 8];
+
+    const int16_t rowKernel[3] = {1, 2, 1};
+    const int16_t colKernel[3] = {-1, 0, 3};
+
+    for(int32_t i=0; i < (8 * 8); ++i)
+    {
+        src_data[i] = (int16_pixel_t)(((i * 37) % 101) - 50);
+        src_data_uint8[i] = 100;
+    }
+
+    // The mask is the outer product of the column and row kernel
+    for(int32_t j=0; j < 3; ++j)
+    {
+        for(int32_t i=0; i < 3; ++i)
+        {
+            msk_data[(j * 3) + i] = colKernel[j] * rowKernel[i];
+        }
+    }
+
+    // Prepare images
+    image_t src = {8,8, IMGTYPE_INT16, (uint8_t *)src_data};
+    image_t exp = {8,8, IMGTYPE_INT16, (uint8_t *)exp_data};
+    image_t dst = {8,8, IMGTYPE_INT16, (uint8_t *)dst_data};
+    image_t msk = {3,3, IMGTYPE_INT16, (uint8_t *)msk_data};
+
+    // Test case 1: equal to convolve() with the outer product mask
+    convolve(&src, &exp, &msk);
+    convolveSeparable(&src, &dst, rowKernel, colKernel, 3, 0, BORDER_CONSTANT);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(exp_data, dst_data, (8 * 8), "Test case 1 of 3");
+
+    // Test case 2: fixed-point normalisation with rounding
+    for(int32_t i=0; i < (8 * 8); ++i)
+    {
+        exp_data[i] = (int16_pixel_t)((exp_data[i] + 4) >> 3);
+    }
+
+    convolveSeparable(&src, &dst, rowKernel, colKernel, 3, 3, BORDER_CONSTANT);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(exp_data, dst_data, (8 * 8), "Test case 2 of 3");
+
+    // Test case 3: a normalised kernel keeps a constant image constant if the
+    // border pixels are replicated, and saturates for uint8 images
+    image_t src_uint8 = {8,8, IMGTYPE_UINT8, src_data_uint8};
+    image_t dst_uint8 = {8,8, IMGTYPE_UINT8, dst_data_uint8};
+
+    convolveSeparable(&src_uint8, &dst_uint8, rowKernel, rowKernel, 3, 4, BORDER_REPLICATE);
+
+    TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(100, dst_data_uint8, (8 * 8), "Test case 3 of 3");
+
+    convolveSeparable(&src_uint8, &dst_uint8, rowKernel, rowKernel, 3, 0, BORDER_REPLICATE);
+
+    TEST_ASSERT_EACH_EQUAL_UINT8_MESSAGE(255, dst_data_uint8, (8 * 8), "Test case 3 of 3");
+}
+
+void test_integralImage(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[3 * 2] =
+    {
+        1, 2, 3,
+        4, 5, 6,
+    };
+
+    int32_pixel_t exp_data_test_case_01[4 * 3] =
+    {
+        0,  0,  0,  0,
+        0,  1,  3,  6,
+        0,  5, 12, 21,
+    };
+
+    int32_pixel_t exp_data_test_case_02[4 * 3] =
+    {
+        0,  0,  0,  0,
+        0,  1,  5, 14,
+        0, 17, 46, 91,
+    };
+
+    int64_pixel_t exp_data_test_case_03[4 * 3] =
+    {
+        0,  0,  0,  0,
+        0,  1,  3,  6,
+        0,  5, 12, 21,
+    };
+
+    int32_pixel_t dst_data[4 * 3];
+    int64_pixel_t dst_data_int64[4 * 3];
+
+    // Prepare images
+    image_t src = {3,2, IMGTYPE_UINT8, src_data};
+    image_t dst = {4,3, IMGTYPE_INT32, (uint8_t *)dst_data};
+    image_t dst_int64 = {4,3, IMGTYPE_INT64, (uint8_t *)dst_data_int64};
+
+    // Test case 1
+    integralImage(&src, &dst);
+
+    TEST_ASSERT_EQUAL_INT32_ARRAY_MESSAGE(exp_data_test_case_01, dst_data, (4 * 3), "Test case 1 of 5");
+    TEST_ASSERT_EQUAL_INT64_MESSAGE(16, integralRectSum(&dst, 1, 0, 2, 2), "Test case 1 of 5");
+    TEST_ASSERT_EQUAL_INT64_MESSAGE(5, integralRectSum(&dst, 1, 1, 1, 1), "Test case 1 of 5");
+
+    // Test case 2
+    integralSquaredImage(&src, &dst);
+
+    TEST_ASSERT_EQUAL_INT32_ARRAY_MESSAGE(exp_data_test_case_02, dst_data, (4 * 3), "Test case 2 of 5");
+    TEST_ASSERT_EQUAL_INT64_MESSAGE(77, integralRectSum(&dst, 0, 1, 3, 1), "Test case 2 of 5");
+
+    // Test case 3
+    integralImage(&src, &dst_int64);
+
+    TEST_ASSERT_EQUAL_INT64_ARRAY_MESSAGE(exp_data_test_case_03, dst_data_int64, (4 * 3), "Test case 3 of 5");
+    TEST_ASSERT_EQUAL_INT64_MESSAGE(16, integralRectSum(&dst_int64, 1, 0, 2, 2), "Test case 3 of 5");
+
+    // Test case 4: build the integral image one row at a time
+    memset(dst_data, 0xFF, sizeof(dst_data));
+    integralImageUpdate(&src, &dst, 0, 1);
+    integralImageUpdate(&src, &dst, 1, 1);
+
+    TEST_ASSERT_EQUAL_INT32_ARRAY_MESSAGE(exp_data_test_case_01, dst_data, (4 * 3), "Test case 4 of 5");
+
+    // Test case 5: update after the last source row has changed
+    src_data[5] = 9;
+    exp_data_test_case_02[11] = 91 - 36 + 81;
+    integralSquaredImage(&src, &dst);
+    src_data[5] = 6;
+    integralSquaredImageUpdate(&src, &dst, 1, 1);
+    exp_data_test_case_02[11] = 91;
+
+    TEST_ASSERT_EQUAL_INT32_ARRAY_MESSAGE(exp_data_test_case_02, dst_data, (4 * 3), "Test case 5 of 5");
+}
+
+void test_convertUint8ToBin1(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[8 * 8] =
+    {
+        1,   0,   0,   0,   0,   0,   0,   0,
+        0,   1,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,
+        0,   0,   1,   1,   1,   1,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+      255,   0,  17,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+    };
+
+    // Pixel x is bit x of a word, non-zero pixels are 1
+    bin1_word_t exp_words[8] =
+    {
+        0x01, 0x02, 0x80, 0xFF, 0x3C, 0x00, 0x05, 0x00,
+    };
+
+    uint8_pixel_t exp_data[8 * 8] =
+    {
+        1,   0,   0,   0,   0,   0,   0,   0,
+        0,   1,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   1,
+        1,   1,   1,   1,   1,   1,   1,   1,
+        0,   0,   1,   1,   1,   1,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        1,   0,   1,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+    };
+
+    uint8_pixel_t dst_data[8 * 8] = {0};
+
+    image_t src = {8,8, IMGTYPE_UINT8, src_data};
+    image_t dst = {8,8, IMGTYPE_UINT8, dst_data};
+
+    image_t *bin = newBin1Image(8, 8);
+    TEST_ASSERT_NOT_NULL(bin);
+    TEST_ASSERT_EQUAL(64, IMAGE_STRIDE(bin));
+
+    // Pack
+    convertUint8ToBin1(&src, bin);
+
+    const bin1_word_t *words = (const bin1_word_t *)bin->data;
+
+    for(uint32_t y=0; y < 8; ++y)
+    {
+        TEST_ASSERT_EQUAL_HEX8_MESSAGE(exp_words[y], (uint8_t)words[y], "Test case 1 of 3");
+    }
+
+    // Unpack
+    convertBin1ToUint8(bin, &dst);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data, dst_data, (8 * 8), "Test case 2 of 3");
+
+    // Rows that span multiple words
+    image_t *wide = newUint8Image(150, 3);
+    image_t *wideBin = newBin1Image(150, 3);
+    image_t *wideDst = newUint8Image(150, 3);
+
+    for(int32_t y=0; y < 3; ++y)
+    {
+        for(int32_t x=0; x < 150; ++x)
+        {
+            setUint8Pixel(wide, x, y, (((x * 7) + y) % 5) == 0);
+        }
+    }
+
+    convertUint8ToBin1(wide, wideBin);
+    convertBin1ToUint8(wideBin, wideDst);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(wide->data, wideDst->data, (150 * 3), "Test case 3 of 3");
+
+    deleteImage(wideDst);
+    deleteImage(wideBin);
+    deleteImage(wide);
+    deleteImage(bin);
+}
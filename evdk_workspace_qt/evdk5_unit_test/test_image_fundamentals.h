@@ -46,4 +46,25 @@ void test_convolve(void);
 /// \brief Unit test function for convolveFast()
 void test_convolveFast(void);
 
+/// \brief Unit test function for roiImage()
+void test_roiImage(void);
+
+/// \brief Unit test function for the image pool
+void test_imagePool(void);
+
+/// \brief Unit test function for newPaddedImage()
+void test_newPaddedImage(void);
+
+/// \brief Unit test function for copyWithBorder()
+void test_copyWithBorder(void);
+
+/// \brief Unit test function for convolveSeparable()
+void test_convolveSeparable(void);
+
+/// \brief Unit test function for integralImage()
+void test_integralImage(void);
+
+/// \brief Unit test function for convertUint8ToBin1() and convertBin1ToUint8()
+void test_convertUint8ToBin1(void);
+
 #endif // _TEST_IMAGE_FUNDAMENTALS_H_
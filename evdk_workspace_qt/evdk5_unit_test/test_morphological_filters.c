@@ -1623,3 +1623,124 @@ void test_skeleton(void)
          TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
      }
 }
+
+void test_morphologyBin1(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[8 * 8] =
+    {
+        0,   0,   1,   0,   0,   0,   0,   1,
+        0,   1,   0,   0,   0,   0,   0,   1,
+        1,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   1,   1,   1,   1,   0,   0,
+        0,   0,   1,   1,   1,   1,   0,   0,
+        0,   1,   1,   1,   1,   1,   1,   0,
+        0,   0,   1,   1,   1,   1,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   1,
+    };
+
+    uint8_t mask[9] =
+    {
+        1,1,0,
+        1,1,1,
+        0,1,1,
+    };
+
+    uint8_t m1[9] =
+    {
+        0,0,0,
+        0,1,1,
+        0,0,0,
+    };
+
+    uint8_t m2[9] =
+    {
+        0,0,0,
+        1,0,0,
+        0,0,0,
+    };
+
+    uint8_pixel_t exp_data[8 * 8] = {0};
+    uint8_pixel_t dst_data[8 * 8] = {0};
+
+    image_t src = {8,8, IMGTYPE_UINT8, src_data};
+    image_t exp = {8,8, IMGTYPE_UINT8, exp_data};
+    image_t dst = {8,8, IMGTYPE_UINT8, dst_data};
+
+    image_t *srcBin = newBin1Image(8, 8);
+    image_t *dstBin = newBin1Image(8, 8);
+
+    convertUint8ToBin1(&src, srcBin);
+
+    // The results must be equal to the results of the uint8 images
+    erosion(&src, &exp, mask, 3);
+    erosion(srcBin, dstBin, mask, 3);
+    convertBin1ToUint8(dstBin, &dst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (8 * 8), "Test case 1 of 8");
+
+    dilation(&src, &exp, mask, 3);
+    dilation(srcBin, dstBin, mask, 3);
+    convertBin1ToUint8(dstBin, &dst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (8 * 8), "Test case 2 of 8");
+
+    outline(&src, &exp, mask, 3);
+    outline(srcBin, dstBin, mask, 3);
+    convertBin1ToUint8(dstBin, &dst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (8 * 8), "Test case 3 of 8");
+
+    hitmiss(&src, &exp, m1, m2);
+    hitmiss(srcBin, dstBin, m1, m2);
+    convertBin1ToUint8(dstBin, &dst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (8 * 8), "Test case 4 of 8");
+
+    deleteImage(dstBin);
+    deleteImage(srcBin);
+
+    // A gray image that is wider than two 64-bit words, with an odd width, so
+    // the carries between the words and the last partial word are used
+    image_t *gray = newUint8Image(150, 9);
+    image_t *wide = newUint8Image(150, 9);
+    image_t *wideExp = newUint8Image(150, 9);
+    image_t *wideDst = newUint8Image(150, 9);
+    image_t *wideBin = newBin1Image(150, 9);
+    image_t *wideDstBin = newBin1Image(150, 9);
+
+    for(int32_t y=0; y<9; y++)
+    {
+        for(int32_t x=0; x<150; x++)
+        {
+            gray->data[(y * 150) + x] = (uint8_pixel_t)(((x * 37) + (y * 91) + (x * y * 11)) % 256);
+        }
+    }
+
+    // Pack the objects into bits, and into a uint8 image for the reference
+    threshold(gray, wide, 100, 255);
+    threshold(gray, wideBin, 100, 255);
+
+    erosion(wide, wideExp, mask, 3);
+    erosion(wideBin, wideDstBin, mask, 3);
+    convertBin1ToUint8(wideDstBin, wideDst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(wideExp->data, wideDst->data, (150 * 9), "Test case 5 of 8");
+
+    dilation(wide, wideExp, mask, 3);
+    dilation(wideBin, wideDstBin, mask, 3);
+    convertBin1ToUint8(wideDstBin, wideDst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(wideExp->data, wideDst->data, (150 * 9), "Test case 6 of 8");
+
+    outline(wide, wideExp, mask, 3);
+    outline(wideBin, wideDstBin, mask, 3);
+    convertBin1ToUint8(wideDstBin, wideDst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(wideExp->data, wideDst->data, (150 * 9), "Test case 7 of 8");
+
+    hitmiss(wide, wideExp, m1, m2);
+    hitmiss(wideBin, wideDstBin, m1, m2);
+    convertBin1ToUint8(wideDstBin, wideDst);
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(wideExp->data, wideDst->data, (150 * 9), "Test case 8 of 8");
+
+    deleteImage(wideDstBin);
+    deleteImage(wideBin);
+    deleteImage(wideDst);
+    deleteImage(wideExp);
+    deleteImage(wide);
+    deleteImage(gray);
+}
@@ -64,4 +64,7 @@ void test_removeBorderBlobsTwoPass(void);
 /// \brief Unit test function for skeleton()
 void test_skeleton(void);
 
+/// \brief Unit test function for the IMGTYPE_BIN1 binary operators
+void test_morphologyBin1(void);
+
 #endif // _TEST_MORPHOLOGICAL_FILTERS_H_
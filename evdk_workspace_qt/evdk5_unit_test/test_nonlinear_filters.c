@@ -231,6 +231,19 @@ void test_mean(void) {
         0,   0,   0,   0,   0,   0,   0,   0,
     };
 
+    // The window is larger than the image, so every pixel is the mean of the
+    // whole image (32.5 rounded up)
+    uint8_pixel_t exp_data_test_case_05[8 * 8] = {
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+    };
+
     uint8_pixel_t dst_data[8 * 8] = {
         0,   0,   0,   0,   0,   0,   0,   0,
         0,   0,   0,   0,   0,   0,   0,   0,
@@ -255,6 +268,7 @@ void test_mean(void) {
         {src_data_test_case_02, exp_data_test_case_02, 3},
         {src_data_test_case_01, exp_data_test_case_03, 5},
         {src_data_test_case_02, exp_data_test_case_04, 5},
+        {src_data_test_case_01, exp_data_test_case_05, 17},
     };
 
     // Prepare images
@@ -494,6 +508,17 @@ void test_minimum(void) {
         0,   0,   0,   0,   0,   0,   0,   0,
     };
 
+    uint8_pixel_t exp_data_test_case_05[8 * 8] = {
+       1,   1,   1,   1,   1,   2,   3,   4,
+       1,   1,   1,   1,   1,   2,   3,   4,
+       1,   1,   1,   1,   1,   2,   3,   4,
+       1,   1,   1,   1,   1,   2,   3,   4,
+       1,   1,   1,   1,   1,   2,   3,   4,
+       9,   9,   9,   9,   9,  10,  11,  12,
+      17,  17,  17,  17,  17,  18,  19,  20,
+      25,  25,  25,  25,  25,  26,  27,  28,
+    };
+
     uint8_pixel_t dst_data[8 * 8] = {
         0,   0,   0,   0,   0,   0,   0,   0,
         0,   0,   0,   0,   0,   0,   0,   0,
@@ -517,6 +542,7 @@ void test_minimum(void) {
         {src_data_test_case_02, exp_data_test_case_02, 3},
         {src_data_test_case_01, exp_data_test_case_03, 5},
         {src_data_test_case_02, exp_data_test_case_04, 5},
+        {src_data_test_case_01, exp_data_test_case_05, 9},
     };
 
     // Prepare images
@@ -754,6 +780,19 @@ void test_range(void) {
         15,  25,  25,  25,  25,  25,  25,  15,
     };
 
+    // The window is larger than the image, so every pixel is the range of the
+    // whole image
+    uint8_pixel_t exp_data_test_case_05[8 * 8] = {
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+      63,  63,  63,  63,  63,  63,  63,  63,
+    };
+
     uint8_pixel_t dst_data[8 * 8] = {
         0,   0,   0,   0,   0,   0,   0,   0,
         0,   0,   0,   0,   0,   0,   0,   0,
@@ -778,6 +817,7 @@ void test_range(void) {
         {src_data_test_case_02, exp_data_test_case_02, 3},
         {src_data_test_case_01, exp_data_test_case_03, 5},
         {src_data_test_case_02, exp_data_test_case_04, 5},
+        {src_data_test_case_01, exp_data_test_case_05, 17},
     };
 
     // Prepare images
@@ -885,6 +925,30 @@ void test_median() {
         1,   3,   5,   5,   5,   5,   3,   1,
     };
 
+    uint8_pixel_t exp_data_test_case_05[8 * 8] = {
+        5,   5,   5,   5,   5,   5,   5,   5,
+        5,  15,  15,  15,  15,  15,  15,   5,
+        5,  15,  15,  15,  15,  15,  15,   5,
+        5,  15,  15,   5,   5,  15,  15,   5,
+        5,  15,  15,   5,   5,  15,  15,   5,
+        5,  15,  15,  15,  15,  15,  15,   5,
+        5,  15,  15,  15,  15,  15,  15,   5,
+        5,   5,   5,   5,   5,   5,   5,   5,
+    };
+
+    // The window is larger than the image, so every pixel is the median of
+    // the whole image (32.5 rounded up)
+    uint8_pixel_t exp_data_test_case_06[8 * 8] = {
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+       33,  33,  33,  33,  33,  33,  33,  33,
+    };
+
     uint8_pixel_t dst_data[8 * 8] = {
         0,   0,   0,   0,   0,   0,   0,   0,
         0,   0,   0,   0,   0,   0,   0,   0,
@@ -909,6 +973,8 @@ void test_median() {
         {src_data_test_case_02, exp_data_test_case_02, 3},
         {src_data_test_case_01, exp_data_test_case_03, 5},
         {src_data_test_case_02, exp_data_test_case_04, 5},
+        {src_data_test_case_02, exp_data_test_case_05, 7},
+        {src_data_test_case_01, exp_data_test_case_06, 31},
     };
 
     // Prepare images
@@ -206,12 +206,13 @@ void test_thresholdOptimum(void)
          uint8_pixel_t *src_data;
          uint8_pixel_t *exp_data;
          eBrightness brightness;
+         uint8_pixel_t threshold;
      }testcase_t;
 
      // Compose array of test cases
      testcase_t testcases[] = {
-         {src_data, exp_data_test_case_01, BRIGHTNESS_DARK},
-         {src_data, exp_data_test_case_02, BRIGHTNESS_BRIGHT},
+         {src_data, exp_data_test_case_01, BRIGHTNESS_DARK, 234},
+         {src_data, exp_data_test_case_02, BRIGHTNESS_BRIGHT, 234},
      };
 
      // Prepare images
@@ -227,7 +228,7 @@ void test_thresholdOptimum(void)
          exp.data = testcases[i].exp_data;
 
          // Execute the operator
-         thresholdOptimum(&src, &dst, testcases[i].brightness);
+         uint8_pixel_t t = thresholdOptimum(&src, &dst, testcases[i].brightness);
 
          // Set test case name
          char name[80] = "";
@@ -250,6 +251,7 @@ void test_thresholdOptimum(void)
          TEST_ASSERT_EQUAL_MESSAGE(exp.type, dst.type, name);
          TEST_ASSERT_EQUAL_MESSAGE(exp.cols, dst.cols, name);
          TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
+         TEST_ASSERT_EQUAL_MESSAGE(testcases[i].threshold, t, name);
      }
 }
 
@@ -417,18 +419,19 @@ void test_threshold2Means(void)
          uint8_pixel_t *src_data;
          uint8_pixel_t *exp_data;
          eBrightness brightness;
+         uint8_pixel_t threshold;
      }testcase_t;
 
      // Compose array of test cases
      testcase_t testcases[] = {
-         {src_data_test_case_01, exp_data_test_case_01, BRIGHTNESS_DARK},
-         {src_data_test_case_01, exp_data_test_case_02, BRIGHTNESS_BRIGHT},
-         {src_data_test_case_02, exp_data_test_case_03, BRIGHTNESS_DARK},
-         {src_data_test_case_02, exp_data_test_case_04, BRIGHTNESS_BRIGHT},
-         {src_data_test_case_03, exp_data_test_case_05, BRIGHTNESS_DARK},
-         {src_data_test_case_03, exp_data_test_case_06, BRIGHTNESS_BRIGHT},
-         {src_data_test_case_04, exp_data_test_case_07, BRIGHTNESS_DARK},
-         {src_data_test_case_04, exp_data_test_case_08, BRIGHTNESS_BRIGHT},
+         {src_data_test_case_01, exp_data_test_case_01, BRIGHTNESS_DARK, 10},
+         {src_data_test_case_01, exp_data_test_case_02, BRIGHTNESS_BRIGHT, 10},
+         {src_data_test_case_02, exp_data_test_case_03, BRIGHTNESS_DARK, 114},
+         {src_data_test_case_02, exp_data_test_case_04, BRIGHTNESS_BRIGHT, 114},
+         {src_data_test_case_03, exp_data_test_case_05, BRIGHTNESS_DARK, 6},
+         {src_data_test_case_03, exp_data_test_case_06, BRIGHTNESS_BRIGHT, 6},
+         {src_data_test_case_04, exp_data_test_case_07, BRIGHTNESS_DARK, 28},
+         {src_data_test_case_04, exp_data_test_case_08, BRIGHTNESS_BRIGHT, 28},
      };
 
      // Prepare images
@@ -444,7 +447,7 @@ void test_threshold2Means(void)
          exp.data = testcases[i].exp_data;
 
          // Execute the operator
-         threshold2Means(&src, &dst, testcases[i].brightness);
+         uint8_pixel_t t = threshold2Means(&src, &dst, testcases[i].brightness);
 
          // Set test case name
          char name[80] = "";
@@ -467,6 +470,7 @@ void test_threshold2Means(void)
          TEST_ASSERT_EQUAL_MESSAGE(exp.type, dst.type, name);
          TEST_ASSERT_EQUAL_MESSAGE(exp.cols, dst.cols, name);
          TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
+         TEST_ASSERT_EQUAL_MESSAGE(testcases[i].threshold, t, name);
      }
 }
 
@@ -649,6 +653,357 @@ void test_thresholdOtsu(void)
      }
 }
 
+void test_thresholdMultiOtsu(void)
+{
+    uint8_pixel_t src_data[8 * 8] =
+    {
+       10,  12,  10,  12, 100, 102, 100, 102,
+       12,  10,  12,  10, 102, 100, 102, 100,
+       10,  12,  10,  12, 100, 102, 100, 102,
+       12,  10,  12,  10, 102, 100, 102, 100,
+      200, 202, 200, 202, 250, 250, 250, 250,
+      202, 200, 202, 200, 250, 250, 250, 250,
+      200, 202, 200, 202, 250, 250, 250, 250,
+      202, 200, 202, 200, 250, 250, 250, 250,
+    };
+
+    uint8_pixel_t exp_data_test_case_01[8 * 8] =
+    {
+        0,   0,   0,   0,   1,   1,   1,   1,
+        0,   0,   0,   0,   1,   1,   1,   1,
+        0,   0,   0,   0,   1,   1,   1,   1,
+        0,   0,   0,   0,   1,   1,   1,   1,
+        2,   2,   2,   2,   2,   2,   2,   2,
+        2,   2,   2,   2,   2,   2,   2,   2,
+        2,   2,   2,   2,   2,   2,   2,   2,
+        2,   2,   2,   2,   2,   2,   2,   2,
+    };
+
+    uint8_pixel_t exp_data_test_case_02[8 * 8] =
+    {
+        0,   0,   0,   0,   1,   1,   1,   1,
+        0,   0,   0,   0,   1,   1,   1,   1,
+        0,   0,   0,   0,   1,   1,   1,   1,
+        0,   0,   0,   0,   1,   1,   1,   1,
+        2,   2,   2,   2,   3,   3,   3,   3,
+        2,   2,   2,   2,   3,   3,   3,   3,
+        2,   2,   2,   2,   3,   3,   3,   3,
+        2,   2,   2,   2,   3,   3,   3,   3,
+    };
+
+    uint8_pixel_t dst_data[8 * 8] = {0};
+
+    typedef struct testcase_t
+    {
+        uint8_pixel_t *exp_data;
+        uint32_t n;
+        uint8_pixel_t thresholds[OTSU_MAX_THRESHOLDS];
+    }testcase_t;
+
+    // Compose array of test cases
+    testcase_t testcases[] =
+    {
+        {exp_data_test_case_01, 2, {12, 102}},
+        {exp_data_test_case_02, 3, {12, 102, 202}},
+    };
+
+    // Prepare images
+    image_t src = {8, 8, IMGTYPE_UINT8, src_data};
+    image_t exp = {8, 8, IMGTYPE_UINT8, NULL};
+    image_t dst = {8, 8, IMGTYPE_UINT8, dst_data};
+
+    // Loop all test cases
+    for(uint32_t i=0; i < (sizeof(testcases) / sizeof(testcase_t)); ++i)
+    {
+        // Set the data
+        exp.data = testcases[i].exp_data;
+
+        // Execute the operator
+        uint8_pixel_t thresholds[OTSU_MAX_THRESHOLDS] = {0};
+        thresholdMultiOtsu(&src, &dst, thresholds, testcases[i].n);
+
+        // Set test case name
+        char name[80] = "";
+        sprintf(name, "Test case %d of %d", i+1, (uint32_t)(sizeof(testcases) / sizeof(testcase_t)));
+
+        // Verify the result
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(testcases[i].thresholds, thresholds, testcases[i].n, name);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), name);
+    }
+}
+
+void test_thresholdAdaptive(void)
+{
+    // Dark objects on a background that gets brighter to the right
+    uint8_pixel_t src_data[8 * 8] =
+    {
+      100, 115, 130, 145, 160, 175, 190, 205,
+      100,  55,  70, 145, 160, 175, 190, 205,
+      100,  55,  70, 145, 160, 175, 190, 205,
+      100, 115, 130, 145, 160, 175, 190, 205,
+      100, 115, 130, 145, 160, 115, 130, 205,
+      100, 115, 130, 145, 160, 115, 130, 205,
+      100, 115, 130, 145, 160, 175, 190, 205,
+      100, 115, 130, 145, 160, 175, 190, 205,
+    };
+
+    uint8_pixel_t exp_data_test_case_01[8 * 8] =
+    {
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   1,   1,   0,   0,   0,   0,   0,
+        0,   1,   1,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   1,   1,   0,
+        0,   0,   0,   0,   0,   1,   1,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+    };
+
+    uint8_pixel_t exp_data_test_case_03[8 * 8] =
+    {
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   1,   1,   0,   0,   0,   0,   0,
+        0,   1,   1,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   1,   0,   0,
+        0,   0,   0,   0,   0,   1,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+    };
+
+    uint8_pixel_t exp_data_test_case_04[8 * 8] =
+    {
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   1,   1,   0,   0,   0,   0,   0,
+        0,   1,   1,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   1,   1,   0,
+        1,   0,   0,   0,   0,   1,   1,   0,
+        1,   0,   0,   0,   0,   0,   0,   0,
+        1,   0,   0,   0,   0,   0,   0,   0,
+    };
+
+    uint8_pixel_t inv_data[8 * 8];
+    uint8_pixel_t dst_data[8 * 8] = {0};
+
+    // Bright objects on a background that gets darker to the right
+    for(uint32_t i=0; i<(8 * 8); ++i)
+    {
+        inv_data[i] = 255 - src_data[i];
+    }
+
+    typedef struct testcase_t
+    {
+        uint8_pixel_t *src_data;
+        uint8_pixel_t *exp_data;
+        eBrightness brightness;
+        eAdaptiveMethod method;
+        float k;
+    }testcase_t;
+
+    // Compose array of test cases
+    testcase_t testcases[] =
+    {
+        {src_data, exp_data_test_case_01, BRIGHTNESS_DARK,   ADAPTIVE_BRADLEY, 0.2f},
+        {inv_data, exp_data_test_case_01, BRIGHTNESS_BRIGHT, ADAPTIVE_BRADLEY, 0.2f},
+        {src_data, exp_data_test_case_03, BRIGHTNESS_DARK,   ADAPTIVE_SAUVOLA, 0.34f},
+        {inv_data, exp_data_test_case_04, BRIGHTNESS_BRIGHT, ADAPTIVE_NIBLACK, 0.5f},
+    };
+
+    // Prepare images
+    image_t src = {8, 8, IMGTYPE_UINT8, NULL};
+    image_t exp = {8, 8, IMGTYPE_UINT8, NULL};
+    image_t dst = {8, 8, IMGTYPE_UINT8, dst_data};
+
+    adaptiveBuffers_t buffers = newAdaptiveBuffers(8, 8);
+
+    // Loop all test cases
+    for(uint32_t i=0; i < (sizeof(testcases) / sizeof(testcase_t)); ++i)
+    {
+        // Set the data
+        src.data = testcases[i].src_data;
+        exp.data = testcases[i].exp_data;
+
+        // Execute the operator
+        thresholdAdaptive(&src, &dst, testcases[i].brightness, testcases[i].method,
+                          5, testcases[i].k, &buffers);
+
+        // Set test case name
+        char name[80] = "";
+        sprintf(name, "Test case %d of %d", i+1, (uint32_t)(sizeof(testcases) / sizeof(testcase_t)));
+
+        // Verify the result
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), name);
+    }
+
+    deleteAdaptiveBuffers(&buffers);
+}
+
+void test_thresholdAdaptiveLargeWindow(void)
+{
+    // Dark squares on a bright, noisy background. The windows hold so many
+    // bright pixels that their sum of squares does not fit in 32 bits.
+    const int32_t cols = 320;
+    const int32_t rows = 240;
+
+    image_t *src = newUint8Image(cols, rows);
+    image_t *dst = newUint8Image(cols, rows);
+    image_t *exp = newUint8Image(cols, rows);
+
+    uint32_t seed = 12345;
+
+    for(int32_t y=0; y<rows; ++y)
+    {
+        for(int32_t x=0; x<cols; ++x)
+        {
+            seed = (seed * 1103515245) + 12345;
+
+            const uint8_pixel_t noise = (seed >> 16) % 16;
+            const int32_t square = ((x % 40) < 4) && ((y % 40) < 4);
+
+            src->data[(y * cols) + x] = square ? (30 + noise) : (240 + noise);
+        }
+    }
+
+    typedef struct testcase_t
+    {
+        eAdaptiveMethod method;
+        uint32_t size;
+        float k;
+    }testcase_t;
+
+    // Compose array of test cases
+    testcase_t testcases[] =
+    {
+        {ADAPTIVE_NIBLACK, 301, 0.2f},
+        {ADAPTIVE_SAUVOLA, 401, 0.34f},
+    };
+
+    adaptiveBuffers_t buffers = newAdaptiveBuffers(cols, rows);
+
+    // Loop all test cases
+    for(uint32_t i=0; i < (sizeof(testcases) / sizeof(testcase_t)); ++i)
+    {
+        const int32_t r = testcases[i].size / 2;
+        const float k = testcases[i].k;
+
+        // Brute force reference, with the window sums in 64 bits. The
+        // columns of the window are summed first.
+        for(int32_t y=0; y<rows; ++y)
+        {
+            const int32_t y0 = (y - r < 0) ? 0 : (y - r);
+            const int32_t y1 = (y + r + 1 > rows) ? rows : (y + r + 1);
+
+            uint32_t colSum[320] = {0};
+            int64_t colSumSq[320] = {0};
+
+            for(int32_t v=y0; v<y1; ++v)
+            {
+                for(int32_t u=0; u<cols; ++u)
+                {
+                    const int64_t p = src->data[(v * cols) + u];
+
+                    colSum[u] += p;
+                    colSumSq[u] += p * p;
+                }
+            }
+
+            for(int32_t x=0; x<cols; ++x)
+            {
+                const int32_t x0 = (x - r < 0) ? 0 : (x - r);
+                const int32_t x1 = (x + r + 1 > cols) ? cols : (x + r + 1);
+                const int64_t n = (x1 - x0) * (y1 - y0);
+
+                uint32_t sum = 0;
+                int64_t sumSq = 0;
+
+                for(int32_t u=x0; u<x1; ++u)
+                {
+                    sum += colSum[u];
+                    sumSq += colSumSq[u];
+                }
+
+                const float m = (float)sum / (float)n;
+                const float sd = sqrtf((float)((n * sumSq) - ((int64_t)sum * sum))) / (float)n;
+                const float t = (testcases[i].method == ADAPTIVE_NIBLACK) ?
+                                (m - (k * sd)) :
+                                (m * (1.0f + (k * ((sd / 128.0f) - 1.0f))));
+
+                exp->data[(y * cols) + x] = ((float)src->data[(y * cols) + x] <= t) ? 1 : 0;
+            }
+        }
+
+        // Execute the operator
+        thresholdAdaptive(src, dst, BRIGHTNESS_DARK, testcases[i].method,
+                          testcases[i].size, k, &buffers);
+
+        // Set test case name
+        char name[80] = "";
+        sprintf(name, "Test case %d of %d", i+1, (uint32_t)(sizeof(testcases) / sizeof(testcase_t)));
+
+        // Verify the result
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, dst->data, (cols * rows), name);
+    }
+
+    deleteAdaptiveBuffers(&buffers);
+    deleteImage(exp);
+    deleteImage(dst);
+    deleteImage(src);
+}
+
+void test_thresholdTracked(void)
+{
+    uint8_pixel_t src_data[8 * 8] =
+    {
+        105, 105, 105, 105, 105, 105, 105, 105,
+        105, 105, 105, 105, 105, 105, 105, 105,
+        110, 110, 110, 110, 110, 110, 110, 110,
+        110, 110, 110, 110, 110, 110, 110, 110,
+        120, 120, 120, 120, 120, 120, 120, 120,
+        120, 120, 120, 120, 120, 120, 120, 120,
+        125, 125, 125, 125, 125, 125, 125, 125,
+        125, 125, 125, 125, 125, 125, 125, 125,
+    };
+
+    uint8_pixel_t exp_data[8 * 8] = {0};
+    uint8_pixel_t dst_data[8 * 8] = {0};
+
+    // Prepare images
+    image_t src = {8, 8, IMGTYPE_UINT8, src_data};
+    image_t exp = {8, 8, IMGTYPE_UINT8, exp_data};
+    image_t dst = {8, 8, IMGTYPE_UINT8, dst_data};
+
+    thresholdTracker_t tracker = newThresholdTracker(THRESHOLD_OTSU, 1, 0.5f, 0.1f);
+
+    // Test case 1: the first frame gives the same result as thresholdOtsu()
+    thresholdOtsu(&src, &exp, BRIGHTNESS_DARK);
+
+    TEST_ASSERT_EQUAL_MESSAGE(110, thresholdTracked(&src, &dst, BRIGHTNESS_DARK, &tracker), "Test case 1 of 4");
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp.data, dst.data, (exp.cols * exp.rows), "Test case 1 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(1, tracker.searches, "Test case 1 of 4");
+
+    // Test case 2: a small change does not start a new search
+    src_data[0] = 106;
+    src_data[1] = 106;
+
+    TEST_ASSERT_EQUAL_MESSAGE(110, thresholdTracked(&src, &dst, BRIGHTNESS_DARK, &tracker), "Test case 2 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(1, tracker.searches, "Test case 2 of 4");
+
+    // Test case 3: a large change starts a new search, the threshold moves
+    // halfway to the new threshold
+    for(uint32_t i=0; i<(8 * 8); ++i)
+    {
+        src_data[i] += 20;
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(120, thresholdTracked(&src, &dst, BRIGHTNESS_DARK, &tracker), "Test case 3 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(2, tracker.searches, "Test case 3 of 4");
+
+    // Test case 4: the next frame moves further without a new search
+    TEST_ASSERT_EQUAL_MESSAGE(125, thresholdTracked(&src, &dst, BRIGHTNESS_DARK, &tracker), "Test case 4 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(2, tracker.searches, "Test case 4 of 4");
+}
+
 void test_lineDetector(void)
 {
     // Prepare images for testing
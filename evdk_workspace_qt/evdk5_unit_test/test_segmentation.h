@@ -46,6 +46,19 @@ void test_threshold2Means(void);
 /// \brief Unit test function for thresholdOtsu()
 void test_thresholdOtsu(void);
 
+/// \brief Unit test function for thresholdMultiOtsu()
+void test_thresholdMultiOtsu(void);
+
+/// \brief Unit test function for thresholdAdaptive()
+void test_thresholdAdaptive(void);
+
+/// \brief Unit test function for thresholdAdaptive() with windows larger
+///        than 257 x 257 pixels
+void test_thresholdAdaptiveLargeWindow(void);
+
+/// \brief Unit test function for thresholdTracked()
+void test_thresholdTracked(void);
+
 /// \brief Unit test function for lineDetector()
 void test_lineDetector(void);
 
@@ -62,14 +62,14 @@ void test_gaussianFilter(void)
 
     int16_pixel_t exp_data_test_case_02[8 * 8] =
     {
-         660,   890,   962,  1008,  1082,  1128,  1068,   792,
-         890,  1200,  1296,  1358,  1458,  1520,  1440,  1068,
-        1010,  1360,  1476,  1578,  1748,  1850,  1760,  1308,
-        1240,  1670,  1842,  2088,  2492,  2738,  2628,  1952,
-        1610,  2170,  2440,  2920,  3693,  4173,  4028,  2988,
-        1840,  2480,  2806,  3430,  4437,  5061,  4896,  3632,
-        1780,  2400,  2720,  3340,  4340,  4960,  4800,  3560,
-        1320,  1780,  2020,  2480,  3220,  3680,  3560,  2640,
+         605,   825,   891,   935,  1001,  1045,   990,   726,
+         825,  1125,  1215,  1275,  1365,  1425,  1350,   990,
+         935,  1275,  1385,  1485,  1635,  1735,  1650,  1210,
+        1155,  1575,  1741,  1985,  2351,  2595,  2490,  1826,
+        1485,  2025,  2275,  2735,  3425,  3885,  3750,  2750,
+        1705,  2325,  2631,  3235,  4141,  4745,  4590,  3366,
+        1650,  2250,  2550,  3150,  4050,  4650,  4500,  3300,
+        1210,  1650,  1870,  2310,  2970,  3410,  3300,  2420,
     };
 
     int16_pixel_t dst_data[8 * 8] =
@@ -413,3 +413,171 @@ void test_sobelFast(void)
      TEST_ASSERT_EQUAL_MESSAGE(exp_mag.cols, dst_mag.cols, name);
      TEST_ASSERT_EQUAL_MESSAGE(exp_mag.rows, dst_mag.rows, name);
 }
+
+void test_sobelGradient(void)
+{
+    // Prepare images for testing
+    int16_pixel_t src_data[8 * 8] =
+    {
+        5,   5,   5,   5,   6,   6,   6,   6,
+        5,   5,   5,   5,   6,   6,   6,   6,
+        5,   5,   5,   5,   6,   6,   6,   6,
+        5,   5,   5,   5,   6,   6,   6,   6,
+        10, 10,  10,  10,  20,  20,  20,  20,
+        10, 10,  10,  10,  20,  20,  20,  20,
+        10, 10,  10,  10,  20,  20,  20,  20,
+        10, 10,  10,  10,  20,  20,  20,  20,
+    };
+
+    int16_pixel_t exp_data_mag_test_case_01[8 * 8] =
+    {
+        30,    20,    20,    24,    26,    24,    24,    36,
+        20,     0,     0,     4,     4,     0,     0,    24,
+        20,     0,     0,     4,     4,     0,     0,    24,
+        40,    20,    20,    42,    60,    56,    56,    80,
+        50,    20,    20,    60,    78,    56,    56,   108,
+        40,     0,     0,    40,    40,     0,     0,    80,
+        40,     0,     0,    40,    40,     0,     0,    80,
+        60,    40,    40,    80,   100,    80,    80,   120,
+    };
+
+    uint8_pixel_t exp_data_dir_test_case_01[8 * 8] =
+    {
+        1,   2,   2,   2,   2,   2,   2,   3,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        1,   2,   2,   1,   2,   2,   2,   3,
+        1,   2,   2,   1,   1,   2,   2,   3,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,
+        3,   2,   2,   3,   3,   2,   2,   1,
+    };
+
+    int16_pixel_t exp_data_mag_test_case_02[8 * 8] =
+    {
+        20,    20,    20,    22,    24,    24,    24,    24,
+        20,     0,     0,     4,     4,     0,     0,    24,
+        20,     0,     0,     4,     4,     0,     0,    24,
+        30,    20,    20,    33,    51,    56,    56,    56,
+        40,    20,    20,    41,    58,    56,    56,    81,
+        40,     0,     0,    40,    40,     0,     0,    80,
+        40,     0,     0,    40,    40,     0,     0,    80,
+        41,    40,    40,    61,    81,    80,    80,    82,
+    };
+
+    uint8_pixel_t exp_data_dir_test_case_02[8 * 8] =
+    {
+        1,   2,   2,   2,   2,   2,   2,   3,
+        0,   0,   0,   0,   0,   0,   0,   4,
+        0,   0,   0,   0,   0,   0,   0,   4,
+        1,   2,   2,   1,   2,   2,   2,   3,
+        1,   2,   2,   1,   1,   2,   2,   3,
+        0,   0,   0,   0,   0,   0,   0,   4,
+        0,   0,   0,   0,   0,   0,   0,   4,
+        7,   6,   6,   7,   7,   6,   6,   5,
+    };
+
+    int16_pixel_t dst_data_mag[8 * 8];
+    uint8_pixel_t dst_data_dir[8 * 8];
+
+    // Prepare images
+    image_t src = {8, 8, IMGTYPE_INT16, (uint8_t *)src_data};
+    image_t dst_mag = {8, 8, IMGTYPE_INT16, (uint8_t *)dst_data_mag};
+    image_t dst_dir = {8, 8, IMGTYPE_UINT8, dst_data_dir};
+
+    // Test case 1: L1 magnitude and orientation in 4 bins
+    sobelGradient(&src, &dst_mag, &dst_dir, NORM_L1, 4);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(exp_data_mag_test_case_01, dst_data_mag, (8 * 8), "Test case 1 of 2");
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_dir_test_case_01, dst_data_dir, (8 * 8), "Test case 1 of 2");
+
+    // Test case 2: approximated L2 magnitude and direction in 8 bins
+    sobelGradient(&src, &dst_mag, &dst_dir, NORM_L2, 8);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(exp_data_mag_test_case_02, dst_data_mag, (8 * 8), "Test case 2 of 2");
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_dir_test_case_02, dst_data_dir, (8 * 8), "Test case 2 of 2");
+}
+
+void test_canny(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data_test_case_01[12 * 6];
+    uint8_pixel_t src_data_test_case_03[12 * 6];
+
+    // A strong step at column 3 and a weak step at column 8
+    for(int32_t i=0; i < (12 * 6); ++i)
+    {
+        int32_t x = i % 12;
+        src_data_test_case_01[i] = (x < 3) ? 0 : ((x < 8) ? 200 : 230);
+    }
+
+    // A vertical step that is strong in the first row only
+    for(int32_t i=0; i < (12 * 6); ++i)
+    {
+        int32_t x = i % 12;
+        int32_t y = i / 12;
+        src_data_test_case_03[i] = (x < 6) ? 0 : ((y < 1) ? 250 : 100);
+    }
+
+    // Only the strong edge
+    uint8_pixel_t exp_data_test_case_01[12 * 6] =
+    {
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    };
+
+    // Both edges
+    uint8_pixel_t exp_data_test_case_02[12 * 6] =
+    {
+        0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+    };
+
+    // The weak part of the edge is connected to the strong part
+    uint8_pixel_t exp_data_test_case_03[12 * 6] =
+    {
+        0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1,
+        0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+    };
+
+    uint8_pixel_t exp_data_test_case_04[12 * 6] = {0};
+
+    uint8_pixel_t dst_data[12 * 6];
+
+    // Prepare images
+    image_t src_test_case_01 = {12, 6, IMGTYPE_UINT8, src_data_test_case_01};
+    image_t src_test_case_03 = {12, 6, IMGTYPE_UINT8, src_data_test_case_03};
+    image_t dst = {12, 6, IMGTYPE_UINT8, dst_data};
+
+    cannyBuffers_t buffers = newCannyBuffers(12, 6);
+
+    // Test case 1
+    canny(&src_test_case_01, &dst, 50, 300, &buffers);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_test_case_01, dst_data, (12 * 6), "Test case 1 of 4");
+
+    // Test case 2
+    canny(&src_test_case_01, &dst, 50, 70, &buffers);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_test_case_02, dst_data, (12 * 6), "Test case 2 of 4");
+
+    // Test case 3
+    canny(&src_test_case_03, &dst, 50, 300, &buffers);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_test_case_03, dst_data, (12 * 6), "Test case 3 of 4");
+
+    // Test case 4: no pixel reaches the high threshold, without buffers
+    canny(&src_test_case_01, &dst, 300, 1000, NULL);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_test_case_04, dst_data, (12 * 6), "Test case 4 of 4");
+
+    deleteCannyBuffers(&buffers);
+}
@@ -46,4 +46,10 @@ void test_sobel(void);
 /// \brief Unit test function for sobelFast()
 void test_sobelFast(void);
 
+/// \brief Unit test function for sobelGradient()
+void test_sobelGradient(void);
+
+/// \brief Unit test function for canny()
+void test_canny(void);
+
 #endif // _TEST_SPATIAL_FILTERS_H_
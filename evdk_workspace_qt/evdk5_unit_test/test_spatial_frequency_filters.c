@@ -33,3 +33,74 @@
 
 #include "main.h"
 
+
+void test_frequencyFilter(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[8 * 4];
+    uint8_pixel_t dst_data[8 * 4];
+    float_pixel_t dst_data_float[8 * 4];
+    float_pixel_t exp_data_test_case_04[8 * 4];
+
+    uint8_pixel_t exp_data_test_case_01[8 * 4];
+    uint8_pixel_t exp_data_test_case_02[8 * 4];
+
+    memset(exp_data_test_case_01, 100, sizeof(exp_data_test_case_01));
+    memset(exp_data_test_case_02, 0, sizeof(exp_data_test_case_02));
+
+    // Prepare images
+    image_t src = {8,4, IMGTYPE_UINT8, src_data};
+    image_t dst = {8,4, IMGTYPE_UINT8, dst_data};
+    image_t dst_float = {8,4, IMGTYPE_FLOAT, (uint8_t *)dst_data_float};
+
+    // Test case 1: a constant image passes a low-pass filter unchanged
+    frequencyFilter_t filter = newFrequencyFilter(8, 4, FILTER_GAUSSIAN, FILTER_LOWPASS, 1.0f, 0.0f, 0);
+
+    memset(src_data, 100, sizeof(src_data));
+    frequencyFilter(&src, &dst, &filter);
+    deleteFrequencyFilter(&filter);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_test_case_01, dst_data, (8 * 4), "Test case 1 of 4");
+
+    // Test case 2: a high-pass filter removes a constant image
+    filter = newFrequencyFilter(8, 4, FILTER_IDEAL, FILTER_HIGHPASS, 1.0f, 0.0f, 0);
+
+    frequencyFilter(&src, &dst, &filter);
+    deleteFrequencyFilter(&filter);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data_test_case_02, dst_data, (8 * 4), "Test case 2 of 4");
+
+    // Test case 3: a Butterworth low-pass filter with a high cutoff keeps
+    // every image
+    for(int32_t i=0; i<(8 * 4); i++)
+    {
+        src_data[i] = (uint8_pixel_t)((i * 53) % 256);
+    }
+
+    filter = newFrequencyFilter(8, 4, FILTER_BUTTERWORTH, FILTER_LOWPASS, 1000.0f, 0.0f, 2);
+
+    frequencyFilter(&src, &dst, &filter);
+    deleteFrequencyFilter(&filter);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(src_data, dst_data, (8 * 4), "Test case 3 of 4");
+
+    // Test case 4: a band-pass filter keeps a single frequency of a mixture
+    // and removes the mean
+    const int32_t pattern[8] = {0, 100, 0, -100, 0, 100, 0, -100};
+
+    for(int32_t y=0; y<4; y++)
+    {
+        for(int32_t x=0; x<8; x++)
+        {
+            src_data[(y * 8) + x] = (uint8_pixel_t)(128 + pattern[x] + ((x % 2) ? 20 : -20));
+            exp_data_test_case_04[(y * 8) + x] = (float_pixel_t)pattern[x];
+        }
+    }
+
+    filter = newFrequencyFilter(8, 4, FILTER_IDEAL, FILTER_BANDPASS, 2.0f, 1.0f, 0);
+
+    frequencyFilter(&src, &dst_float, &filter);
+    deleteFrequencyFilter(&filter);
+
+    TEST_ASSERT_FLOAT_ARRAY_WITHIN_MESSAGE(0.001f, exp_data_test_case_04, dst_data_float, (8 * 4), "Test case 4 of 4");
+}
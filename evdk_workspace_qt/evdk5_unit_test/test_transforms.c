@@ -33,3 +33,383 @@
 
 #include "main.h"
 
+
+void test_fft2d(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[3 * 2] =
+    {
+        1, 2, 3,
+        4, 5, 6,
+    };
+
+    complex_pixel_t cpx_data[3 * 2] =
+    {
+        {1, 0}, {2, 0}, {3, 0},
+        {4, 0}, {5, 0}, {6, 0},
+    };
+
+    float exp_data[2 * 3 * 2] =
+    {
+        21.0f, 0.0f,  -3.0f, 1.7320508f,  -3.0f, -1.7320508f,
+        -9.0f, 0.0f,   0.0f, 0.0f,         0.0f,  0.0f,
+    };
+
+    complex_pixel_t dst_data[3 * 2];
+    complex_pixel_t inv_data[3 * 2];
+
+    // Prepare images
+    image_t src = {3,2, IMGTYPE_UINT8, src_data};
+    image_t cpx = {3,2, IMGTYPE_COMPLEX, (uint8_t *)cpx_data};
+    image_t dst = {3,2, IMGTYPE_COMPLEX, (uint8_t *)dst_data};
+    image_t inv = {3,2, IMGTYPE_COMPLEX, (uint8_t *)inv_data};
+
+    // Test case 1
+    fft2dReal(&src, &dst, NULL);
+
+    TEST_ASSERT_FLOAT_ARRAY_WITHIN_MESSAGE(0.0001f, exp_data, (float *)dst_data, (2 * 3 * 2), "Test case 1 of 4");
+
+    // Test case 2
+    fft2d(&cpx, &dst, NULL);
+
+    TEST_ASSERT_FLOAT_ARRAY_WITHIN_MESSAGE(0.0001f, exp_data, (float *)dst_data, (2 * 3 * 2), "Test case 2 of 4");
+
+    // Test case 3
+    ifft2d(&dst, &inv, NULL);
+
+    TEST_ASSERT_FLOAT_ARRAY_WITHIN_MESSAGE(0.0001f, (float *)cpx_data, (float *)inv_data, (2 * 3 * 2), "Test case 3 of 4");
+
+    // Test case 4: mixed radix with a reused plan, the real and complex
+    // transforms agree and the inverse restores the image
+    image_t *src4 = newUint8Image(20, 12);
+    image_t *cpx4 = newComplexImage(20, 12);
+    image_t *dst4 = newComplexImage(20, 12);
+    image_t *real4 = newComplexImage(20, 12);
+    fftPlan_t plan = newFftPlan(20, 12);
+
+    for(int32_t y=0; y<12; y++)
+    {
+        for(int32_t x=0; x<20; x++)
+        {
+            uint8_pixel_t val = (uint8_pixel_t)(((x * 37) + (y * y * 11)) % 256);
+            complex_pixel_t c = {val, 0};
+
+            setUint8Pixel(src4, x, y, val);
+            setComplexPixel(cpx4, x, y, c);
+        }
+    }
+
+    fft2dReal(src4, real4, &plan);
+    fft2d(cpx4, dst4, &plan);
+
+    TEST_ASSERT_FLOAT_ARRAY_WITHIN_MESSAGE(0.01f, (float *)dst4->data, (float *)real4->data, (2 * 20 * 12), "Test case 4 of 4");
+
+    ifft2d(dst4, dst4, &plan);
+
+    TEST_ASSERT_FLOAT_ARRAY_WITHIN_MESSAGE(0.001f, (float *)cpx4->data, (float *)dst4->data, (2 * 20 * 12), "Test case 4 of 4");
+
+    deleteFftPlan(&plan);
+    deleteImage(real4);
+    deleteImage(dst4);
+    deleteImage(cpx4);
+    deleteImage(src4);
+}
+
+void test_correlateTemplate(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[12 * 10];
+    uint8_pixel_t dst_data[12 * 10];
+    uint8_pixel_t exp_data[12 * 10];
+    uint8_pixel_t msk_data[17 * 17];
+
+    uint8_pixel_t msk_data_3x3[3 * 3] =
+    {
+        1, 0, 1,
+        0, 2, 0,
+        1, 1, 0,
+    };
+
+    for(int32_t i=0; i<(12 * 10); i++)
+    {
+        src_data[i] = (uint8_pixel_t)((i * 7) % 40);
+    }
+
+    // Prepare images
+    image_t src = {12,10, IMGTYPE_UINT8, src_data};
+    image_t dst = {12,10, IMGTYPE_UINT8, dst_data};
+    image_t exp = {12,10, IMGTYPE_UINT8, exp_data};
+    image_t msk = {17,17, IMGTYPE_UINT8, msk_data};
+    image_t msk_3x3 = {3,3, IMGTYPE_UINT8, msk_data_3x3};
+
+    // Test case 1: a large mask with only the centre set keeps the image
+    memset(msk_data, 0, sizeof(msk_data));
+    msk_data[(8 * 17) + 8] = 1;
+
+    correlationTemplate_t large = newCorrelationTemplate(&msk, 12, 10);
+    TEST_ASSERT_NULL_MESSAGE(large.mask, "Test case 1 of 4");
+
+    correlateTemplate(&src, &dst, &large, BORDER_CONSTANT);
+    deleteCorrelationTemplate(&large);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(src_data, dst_data, (12 * 10), "Test case 1 of 4");
+
+    // Test case 2: shift by two columns and one row
+    msk_data[(8 * 17) + 8] = 0;
+    msk_data[(9 * 17) + 10] = 1;
+
+    for(int32_t y=0; y<10; y++)
+    {
+        for(int32_t x=0; x<12; x++)
+        {
+            exp_data[(y * 12) + x] = ((x < 10) && (y < 9)) ? src_data[((y + 1) * 12) + x + 2] : 0;
+        }
+    }
+
+    large = newCorrelationTemplate(&msk, 12, 10);
+    correlateTemplate(&src, &dst, &large, BORDER_CONSTANT);
+    deleteCorrelationTemplate(&large);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data, dst_data, (12 * 10), "Test case 2 of 4");
+
+    // Test case 3: a template of a small mask that is reused equals direct
+    // correlation
+    correlationTemplate_t tmpl = newCorrelationTemplate(&msk_3x3, 12, 10);
+    TEST_ASSERT_NOT_NULL_MESSAGE(tmpl.mask, "Test case 3 of 4");
+
+    for(int32_t i=0; i<3; i++)
+    {
+        src_data[i * 11] = (uint8_pixel_t)(50 * i);
+
+        correlateBorder(&src, &exp, &msk_3x3, BORDER_REPLICATE);
+        correlateTemplate(&src, &dst, &tmpl, BORDER_REPLICATE);
+
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp_data, dst_data, (12 * 10), "Test case 3 of 4");
+    }
+
+    deleteCorrelationTemplate(&tmpl);
+
+    // Test case 4: a frame that needs more than one FFT tile to fit in the
+    // memory budget equals direct correlation
+    image_t *frame = newUint8Image(160, 120);
+    image_t *frameExp = newUint8Image(160, 120);
+    image_t *frameDst = newUint8Image(160, 120);
+
+    for(int32_t i=0; i<(160 * 120); i++)
+    {
+        frame->data[i] = (uint8_pixel_t)((i * 13) % 7);
+    }
+
+    for(int32_t i=0; i<(17 * 17); i++)
+    {
+        msk_data[i] = (uint8_pixel_t)(((i * 5) % 3) == 0);
+    }
+
+    tmpl = newCorrelationTemplate(&msk, 160, 120);
+    TEST_ASSERT_NULL_MESSAGE(tmpl.mask, "Test case 4 of 4");
+    TEST_ASSERT_LESS_THAN_MESSAGE(160, tmpl.tile->cols, "Test case 4 of 4");
+
+    correlateBorder(frame, frameExp, &msk, BORDER_REPLICATE);
+    correlateTemplate(frame, frameDst, &tmpl, BORDER_REPLICATE);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(frameExp->data, frameDst->data, (160 * 120), "Test case 4 of 4");
+
+    deleteCorrelationTemplate(&tmpl);
+    deleteImage(frameDst);
+    deleteImage(frameExp);
+    deleteImage(frame);
+}
+
+void test_matchTemplateNCC(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t src_data[12 * 10];
+    uint8_pixel_t tmpl_data[4 * 3];
+    float_pixel_t scores_data[9 * 8];
+    point_t matches[2];
+
+    for(int32_t i=0; i<(12 * 10); i++)
+    {
+        src_data[i] = (uint8_pixel_t)((i * i * 13) % 97);
+    }
+
+    // The template is a part of the image with more contrast and brightness
+    for(int32_t y=0; y<3; y++)
+    {
+        for(int32_t x=0; x<4; x++)
+        {
+            tmpl_data[(y * 4) + x] = (uint8_pixel_t)((2 * src_data[((y + 3) * 12) + x + 5]) + 10);
+        }
+    }
+
+    // Prepare images
+    image_t src = {12,10, IMGTYPE_UINT8, src_data};
+    image_t tmpl = {4,3, IMGTYPE_UINT8, tmpl_data};
+    image_t scores = {9,8, IMGTYPE_FLOAT, (uint8_t *)scores_data};
+
+    nccTemplate_t ncc = newNccTemplate(&tmpl, 12, 10);
+
+    // Test case 1
+    uint32_t n = matchTemplateNCC(&src, &scores, &ncc, matches, 2, 0.0f);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2, n, "Test case 1 of 3");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(5, matches[0].x, "Test case 1 of 3");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(3, matches[0].y, "Test case 1 of 3");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.0001f, 1.0f, scores_data[(3 * 9) + 5], "Test case 1 of 3");
+
+    // The second match does not overlap the first match
+    TEST_ASSERT_TRUE_MESSAGE((abs(matches[1].x - 5) >= 4) || (abs(matches[1].y - 3) >= 3), "Test case 1 of 3");
+    TEST_ASSERT_TRUE_MESSAGE(scores_data[(matches[1].y * 9) + matches[1].x] < 1.0f, "Test case 1 of 3");
+
+    // Test case 2: only the perfect match reaches the minimum score
+    n = matchTemplateNCC(&src, NULL, &ncc, matches, 2, 0.999f);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, n, "Test case 2 of 3");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(5, matches[0].x, "Test case 2 of 3");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(3, matches[0].y, "Test case 2 of 3");
+
+    // Test case 3: a window without contrast has score 0
+    memset(src_data, 80, sizeof(src_data));
+
+    n = matchTemplateNCC(&src, &scores, &ncc, matches, 2, 0.5f);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, n, "Test case 3 of 3");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.0001f, 0.0f, scores_data[0], "Test case 3 of 3");
+
+    deleteNccTemplate(&ncc);
+}
+
+void test_phaseCorrelate(void)
+{
+    // Prepare images for testing
+    uint8_pixel_t ref_data[32 * 24];
+    uint8_pixel_t src_data[32 * 24];
+
+    // A textured reference image and a copy that is shifted 3 pixels to the
+    // right and 2 pixels up
+    for(int32_t y=0; y<24; y++)
+    {
+        for(int32_t x=0; x<32; x++)
+        {
+            ref_data[(y * 32) + x] = (uint8_pixel_t)(((x * x * 7) + (y * 31) + (x * y * 3)) % 101);
+        }
+    }
+
+    for(int32_t y=0; y<24; y++)
+    {
+        for(int32_t x=0; x<32; x++)
+        {
+            src_data[(y * 32) + x] = ref_data[(((y + 2) % 24) * 32) + ((x + 29) % 32)];
+        }
+    }
+
+    // Prepare images
+    image_t ref = {32,24, IMGTYPE_UINT8, ref_data};
+    image_t src = {32,24, IMGTYPE_UINT8, src_data};
+
+    phaseCorrelation_t pc = newPhaseCorrelation(32, 24);
+    float dx = 0.0f;
+    float dy = 0.0f;
+
+    // Test case 1
+    phaseCorrelationReference(&ref, &pc);
+    float peak = phaseCorrelate(&src, &pc, &dx, &dy, 1);
+
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.25f, 3.0f, dx, "Test case 1 of 3");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.25f, -2.0f, dy, "Test case 1 of 3");
+    TEST_ASSERT_TRUE_MESSAGE(peak > 0.5f, "Test case 1 of 3");
+
+    // Test case 2: src is now the reference, so the same image does not move
+    peak = phaseCorrelate(&src, &pc, &dx, &dy, 1);
+
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.0f, dx, "Test case 2 of 3");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.0f, dy, "Test case 2 of 3");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 1.0f, peak, "Test case 2 of 3");
+
+    // Test case 3: moving back to the first image
+    phaseCorrelate(&ref, &pc, &dx, &dy, 0);
+
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.25f, -3.0f, dx, "Test case 3 of 3");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.25f, 2.0f, dy, "Test case 3 of 3");
+
+    deletePhaseCorrelation(&pc);
+}
+
+void test_houghLines(void)
+{
+    // A vertical line at x = 40 and a horizontal line at y = 20
+    uint8_pixel_t src_data[64 * 64] = {0};
+
+    for(int32_t i=0; i<64; i++)
+    {
+        src_data[(i * 64) + 40] = 1;
+        src_data[(20 * 64) + i] = 1;
+    }
+
+    // Some isolated edge pixels
+    src_data[(5 * 64) + 5] = 1;
+    src_data[(50 * 64) + 10] = 1;
+    src_data[(60 * 64) + 60] = 1;
+
+    // Prepare images
+    image_t src = {64,64, IMGTYPE_UINT8, src_data};
+
+    houghPlan_t plan = newHoughPlan(64, 64, 180, 1.0f);
+    houghLine_t lines[4];
+
+    // Test case 1: all edge pixels vote
+    uint32_t n = houghLines(&src, &plan, lines, 4, 40, 1);
+
+    TEST_ASSERT_EQUAL_MESSAGE(2, n, "Test case 1 of 4");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 40.0f, lines[0].rho, "Test case 1 of 4");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.0f, lines[0].theta, "Test case 1 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(64, lines[0].votes, "Test case 1 of 4");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 20.0f, lines[1].rho, "Test case 1 of 4");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 1.5708f, lines[1].theta, "Test case 1 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(64, lines[1].votes, "Test case 1 of 4");
+
+    // Test case 2: a bit-packed image gives the same lines
+    image_t *bin = newBin1Image(64, 64);
+    houghLine_t binLines[4];
+
+    convertUint8ToBin1(&src, bin);
+    uint32_t nb = houghLines(bin, &plan, binLines, 4, 40, 1);
+
+    TEST_ASSERT_EQUAL_MESSAGE(n, nb, "Test case 2 of 4");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(lines, binLines, n * sizeof(houghLine_t), "Test case 2 of 4");
+
+    // Test case 3: a sample of the edge pixels finds the same lines
+    n = houghLines(&src, &plan, lines, 4, 40, 2);
+
+    TEST_ASSERT_EQUAL_MESSAGE(2, n, "Test case 3 of 4");
+
+    for(uint32_t i=0; i<n; i++)
+    {
+        const int32_t vertical = (lines[i].theta < 0.01f);
+
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, vertical ? 40.0f : 20.0f, lines[i].rho, "Test case 3 of 4");
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, vertical ? 0.0f : 1.5708f, lines[i].theta, "Test case 3 of 4");
+    }
+
+    // Test case 4: a short vertical line votes equally for a run of angles
+    // from near pi, across the wrap, to just above 0. It is returned as one
+    // line at theta = 0 with a positive rho.
+    uint8_pixel_t wrap_data[64 * 64] = {0};
+
+    for(int32_t i=0; i<16; i++)
+    {
+        wrap_data[(i * 64) + 40] = 1;
+    }
+
+    image_t wrap = {64,64, IMGTYPE_UINT8, wrap_data};
+
+    n = houghLines(&wrap, &plan, lines, 4, 16, 1);
+
+    TEST_ASSERT_EQUAL_MESSAGE(1, n, "Test case 4 of 4");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 40.0f, lines[0].rho, "Test case 4 of 4");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.0f, lines[0].theta, "Test case 4 of 4");
+    TEST_ASSERT_EQUAL_MESSAGE(16, lines[0].votes, "Test case 4 of 4");
+
+    deleteImage(bin);
+    deleteHoughPlan(&plan);
+}
@@ -34,6 +34,19 @@
 #ifndef _TEST_TRANSFORMS_H_
 #define _TEST_TRANSFORMS_H_
 
+/// \brief Unit test function for fft2d(), fft2dReal() and ifft2d()
+void test_fft2d(void);
 
+/// \brief Unit test function for correlateTemplate()
+void test_correlateTemplate(void);
+
+/// \brief Unit test function for matchTemplateNCC()
+void test_matchTemplateNCC(void);
+
+/// \brief Unit test function for phaseCorrelate()
+void test_phaseCorrelate(void);
+
+/// \brief Unit test function for houghLines()
+void test_houghLines(void);
 
 #endif // _TEST_TRANSFORMS_H_